@@ -66,6 +66,28 @@ private:
     Editor(const Editor&) = delete;
     Editor& operator=(const Editor&) = delete;
 
+    // A moved-from editor holds nothing and must not save or unlock
+    void save()
+    {
+        if (nullptr == object_) {
+
+            return;
+        }
+
+        if (locked_) {
+            auto& callback = *locked_save_callback_;
+            callback(object_, *object_lock_);
+
+            object_lock_->unlock();
+        } else {
+            auto& callback = *unlocked_save_callback_;
+            callback(object_);
+        }
+
+        object_ = nullptr;
+        locked_ = false;
+    }
+
 public:
     Editor(std::mutex& objectMutex, C* object, LockedSave save)
         : object_(object)
@@ -101,23 +123,30 @@ public:
         , unlocked_save_callback_(rhs.unlocked_save_callback_.release())
     {
         rhs.object_ = nullptr;
+        rhs.locked_ = false;
     }
 
-    C& It() { return *object_; }
-
-    ~Editor()
+    Editor& operator=(Editor&& rhs)
     {
-        if (locked_) {
-            auto& callback = *locked_save_callback_;
-            callback(object_, *object_lock_);
-
-            object_lock_->unlock();
-        } else {
-            auto& callback = *unlocked_save_callback_;
-            callback(object_);
+        if (this != &rhs) {
+            save();
+            object_ = rhs.object_;
+            locked_ = rhs.locked_;
+            object_lock_.reset(rhs.object_lock_.release());
+            locked_save_callback_.reset(rhs.locked_save_callback_.release());
+            unlocked_save_callback_.reset(
+                rhs.unlocked_save_callback_.release());
+            rhs.object_ = nullptr;
+            rhs.locked_ = false;
         }
+
+        return *this;
     }
 
+    C& It() { return *object_; }
+
+    ~Editor() { save(); }
+
 }; // class Editor
 } // namespace opentxs
 
@@ -92,6 +92,9 @@ private:
     friend OT;
 
     NymMap nym_map_;
+    // Digest of the serialized credential index most recently verified for
+    // each nym. Guarded by nym_map_lock_.
+    std::map<std::string, std::string> verified_nyms_;
     ServerMap server_map_;
     UnitMap unit_map_;
     ContextMap context_map_;
@@ -106,6 +109,10 @@ private:
         const Identifier& nym,
         const Identifier& context);
     std::mutex& peer_lock(const std::string& nymID) const;
+    bool verify_nym(
+        const std::string& id,
+        const class Nym& nym,
+        std::unique_lock<std::mutex>& mapLock);
     std::string ServerToNym(const Identifier& serverID);
 
     /**   Save an instantiated unit definition to storage and add to internal
@@ -41,9 +41,16 @@
 
 #include "opentxs/core/Contract.hpp"
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace opentxs
 {
@@ -59,9 +66,48 @@ class Mint : public Contract
 private: // Private prevents erroneous use by other classes.
     typedef Contract ot_super;
 
+    // The public and private bank information for one denomination, as
+    // generated and before the private half is sealed to the notary.
+    typedef std::pair<String, String> DenominationKey;
+    typedef std::map<int64_t, DenominationKey> mapOfKeys;
+
+    // Ahead-of-time mode: key pairs for the next series, generated in the
+    // background by PregenerateNextSeries().
+    mutable std::mutex next_lock_;
+    std::unique_ptr<std::thread> next_thread_;
+    std::atomic<bool> next_ready_{false};
+    mapOfKeys next_keys_;
+
+    static void release_armor(mapOfArmor& theArmor);
+
+    Account* create_reserve(const Identifier& theInstrumentDefinitionID,
+                            const Identifier& theNotaryID,
+                            Nym& theNotary) const;
+    void generate_keys(const std::vector<int64_t>& denominations,
+                       const int32_t nPrimeLength, mapOfKeys& output) const;
+    void init_series(int32_t nSeries, time64_t VALID_FROM, time64_t VALID_TO,
+                     time64_t MINT_EXPIRATION,
+                     const Identifier& theInstrumentDefinitionID,
+                     const Identifier& theNotaryID, Nym& theNotary,
+                     Account* pReserve);
+    bool seal_keys(Nym& theNotary, const mapOfKeys& keys, mapOfArmor& thePublic,
+                   mapOfArmor& thePrivate) const;
+
 protected:
     int32_t ProcessXMLNode(irr::io::IrrXMLReader*& xml) override;
 
+    // Waits for PregenerateNextSeries() to finish. The background thread
+    // calls GenerateDenominationKey, so every subclass which implements it
+    // must call this from its own destructor.
+    void join_next();
+
+    // Generates the public and private bank information for a single
+    // denomination. Must not touch any member of the mint, since
+    // GenerateNewMint runs several of these at once.
+    virtual bool GenerateDenominationKey(int32_t nPrimeLength,
+                                         String& strPublic,
+                                         String& strPrivate) const = 0;
+
     void InitMint();
 
     mapOfArmor m_mapPrivate; // An ENVELOPE. You need to pass the Pseudonym to
@@ -182,8 +228,8 @@ public:
 
     int64_t GetDenomination(int32_t nIndex);
     EXPORT int64_t GetLargestDenomination(int64_t lAmount);
-    virtual bool AddDenomination(Nym& theNotary, int64_t lDenomination,
-                                 int32_t nPrimeLength = 1024) = 0;
+    bool AddDenomination(Nym& theNotary, int64_t lDenomination,
+                         int32_t nPrimeLength = 1024);
 
     inline int32_t GetDenominationCount() const
     {
@@ -213,11 +259,28 @@ public:
                                 int64_t nDenom7 = 0, int64_t nDenom8 = 0,
                                 int64_t nDenom9 = 0, int64_t nDenom10 = 0);
 
+    // Ahead-of-time mode: starts generating key pairs for the next series,
+    // with the same denominations as this one, on a background thread.
+    EXPORT bool PregenerateNextSeries(int32_t nPrimeLength = 1024);
+    EXPORT bool NextSeriesReady() const { return next_ready_.load(); }
+    // Replaces this mint with series GetSeries() + 1, using the pre-generated
+    // keys (waiting for them if necessary.) The mint is left untouched on
+    // failure. Sign and save afterwards, as with GenerateNewMint.
+    EXPORT bool RolloverToNextSeries(time64_t VALID_FROM, time64_t VALID_TO,
+                                     time64_t MINT_EXPIRATION, Nym& theNotary);
+
     // step 2: (coin request is in Token)
 
     // Lucre step 3: mint signs token
     EXPORT virtual bool SignToken(Nym& theNotary, Token& theToken,
                                   String& theOutput, int32_t nTokenIndex) = 0;
+    // Lucre step 3, for a whole withdrawal: blind-signs prototoken 0 of every
+    // token, spread across up to threads workers (0 means one per hardware
+    // thread.) Each denomination's private key is opened once per batch, and
+    // the signatures are set onto the tokens. Fails if any token fails.
+    EXPORT virtual bool SignTokens(Nym& theNotary,
+                                   const std::vector<Token*>& tokens,
+                                   const std::size_t threads = 0) = 0;
 
     // step 4: (unblind coin is in Token)
 
@@ -43,6 +43,8 @@
 #include "opentxs/core/String.hpp"
 
 #include <stdint.h>
+#include <cstddef>
+#include <vector>
 
 namespace opentxs
 {
@@ -63,6 +65,11 @@ class MintLucre : public Mint
 private: // Private prevents erroneous use by other classes.
     typedef Mint ot_super;
     friend class Mint; // for the factory.
+
+    bool open_bank(Nym& theNotary, int64_t lDenomination, String& strBank);
+    bool sign_prototoken(const String& strBank, const String& strPrototoken,
+                         String& theOutput) const;
+
 protected:
     MintLucre();
     EXPORT MintLucre(const String& strNotaryID,
@@ -70,12 +77,15 @@ protected:
     EXPORT MintLucre(const String& strNotaryID, const String& strServerNymID,
                      const String& strInstrumentDefinitionID);
 
+    bool GenerateDenominationKey(int32_t nPrimeLength, String& strPublic,
+                                 String& strPrivate) const override;
+
 public:
-    bool AddDenomination(Nym& theNotary, int64_t lDenomination,
-                                 int32_t nPrimeLength = 1024) override;
 
     EXPORT bool SignToken(Nym& theNotary, Token& theToken,
                                   String& theOutput, int32_t nTokenIndex) override;
+    EXPORT bool SignTokens(Nym& theNotary, const std::vector<Token*>& tokens,
+                           const std::size_t threads = 0) override;
     EXPORT bool VerifyToken(Nym& theNotary, String& theCleartextToken,
                                     int64_t lDenomination) override;
 
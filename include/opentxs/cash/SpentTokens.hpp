@@ -0,0 +1,144 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CASH_SPENTTOKENS_HPP
+#define OPENTXS_CASH_SPENTTOKENS_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_set>
+
+namespace opentxs
+{
+
+class String;
+
+// Server-side spent token database
+//
+// There is one store per (instrument definition, series). Each store is an
+// append-only log of token hashes (spent/<unit>.<series>.log) backed by an
+// in-memory hash set which is built the first time the series is touched.
+//
+// Every line of the log holds one batch: the space separated hashes of all
+// tokens from a single deposit, terminated by a newline. Since the batch is
+// appended with one write and flushed before Insert returns, a batch is
+// either entirely present or (if the line was torn by a crash) entirely
+// absent, in which case the partial line is discarded on load. A deposit
+// spanning several series writes one line per series; if any of them fails,
+// the lines already written are truncated away again.
+//
+// Series which were spent into the old one-file-per-token layout
+// (spent/<unit>.<series>/<hash>) are still consulted on a miss.
+//
+// Once the tokens of a series can no longer be deposited its store can be
+// dropped in one operation with ExpireSeries.
+class SpentTokens
+{
+public:
+    // series -> token hashes
+    typedef std::map<std::int32_t, std::set<std::string>> Batch;
+
+    EXPORT static SpentTokens& It();
+
+    // Keeps its stores in folder instead of the server's spent folder. It()
+    // should be used outside of tests.
+    EXPORT explicit SpentTokens(const std::string& folder);
+
+    // The key under which a token is recorded: a hash of its cleartext
+    EXPORT static std::string Hash(const String& theCleartextToken);
+
+    EXPORT bool Exists(
+        const String& strInstrumentDefinitionID,
+        const std::int32_t series,
+        const std::string& hash);
+    EXPORT bool ExpireSeries(
+        const String& strInstrumentDefinitionID,
+        const std::int32_t series);
+    // Records every hash in the batch, or nothing at all if any of them was
+    // already spent or the batch contains no hashes.
+    EXPORT bool Insert(
+        const String& strInstrumentDefinitionID,
+        const Batch& batch);
+
+    ~SpentTokens() = default;
+
+private:
+    typedef std::unique_lock<std::mutex> Lock;
+
+    struct Store {
+        std::string path_;
+        std::string legacy_folder_;
+        bool legacy_{false};
+        std::unordered_set<std::string> hashes_;
+    };
+
+    const std::string folder_;
+    std::mutex lock_;
+    std::map<std::string, std::unique_ptr<Store>> stores_;
+
+    static std::string store_name(
+        const String& strInstrumentDefinitionID,
+        const std::int32_t series);
+
+    bool append(
+        const Store& store,
+        const std::string& line,
+        std::int64_t& position) const;
+    bool exists(const Store& store, const std::string& hash) const;
+    bool form_path(const std::string& name, std::string& output) const;
+    Store* get_store(
+        const Lock& lock,
+        const String& strInstrumentDefinitionID,
+        const std::int32_t series);
+    bool load(Store& store) const;
+    bool truncate(const Store& store, const std::int64_t position) const;
+
+    SpentTokens();
+    SpentTokens(const SpentTokens&) = delete;
+    SpentTokens(SpentTokens&&) = delete;
+    SpentTokens& operator=(const SpentTokens&) = delete;
+    SpentTokens& operator=(SpentTokens&&) = delete;
+};
+
+}  // namespace opentxs
+
+#endif  // OPENTXS_CASH_SPENTTOKENS_HPP
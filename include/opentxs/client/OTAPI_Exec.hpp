@@ -3816,6 +3816,21 @@ public:
         const int32_t& nBoxType,       // 0/nymbox, 1/inbox, 2/outbox
         const int64_t& TRANSACTION_NUMBER) const;
 
+    // Requests several box receipts at once, without waiting for each reply
+    // before sending the next request. TRANSACTION_NUMBERS is a
+    // comma-separated list.
+    //
+    // Returns the number of replies received, or -1 on error. Any receipt
+    // which is still missing afterwards should be requested with
+    // getBoxReceipt.
+    //
+    EXPORT int32_t getBoxReceipts(
+        const std::string& NOTARY_ID,
+        const std::string& NYM_ID,
+        const std::string& ACCOUNT_ID,
+        const int32_t& nBoxType,
+        const std::string& TRANSACTION_NUMBERS) const;
+
     EXPORT bool DoesBoxReceiptExist(
         const std::string& NOTARY_ID,
         const std::string& NYM_ID,     // Unused here for now, but still
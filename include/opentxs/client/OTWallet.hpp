@@ -46,6 +46,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace opentxs
 {
@@ -209,11 +210,19 @@ private:
                    bool bRemoveFromCachedKey=true,
                    String * pStrOutputName=nullptr);
     void Release();
+    const std::vector<Nym*>& nym_index();
+    const std::vector<Account*>& account_index();
 
 private:
     mapOfNymsSP m_mapPrivateNyms;
     mapOfAccounts m_mapAccounts;
 
+    // Dense, ID-ordered views of the two maps above so that GetNym(iIndex)
+    // and GetAccount(iIndex) don't have to walk the map. Cleared whenever a
+    // map changes and rebuilt on the next indexed lookup.
+    std::vector<Nym*> nym_index_;
+    std::vector<Account*> account_index_;
+
     setOfIdentifiers m_setNymsOnCachedKey; // All the Nyms that use the Master
                                            // key are listed here (makes it easy
                                            // to see which ones are converted
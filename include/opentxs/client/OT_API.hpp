@@ -118,6 +118,7 @@ private:
         const Identifier& server,
         Nym* nym,
         Message& message) const;
+    bool binary_messages(const Identifier& server) const;
 
 
     OT_API(
@@ -730,6 +731,13 @@ public:
                       int32_t nBoxType, // 0/nymbox, 1/inbox, 2/outbox
                       const int64_t& lTransactionNum) const;
 
+    EXPORT int32_t getBoxReceipts(
+        const Identifier& NOTARY_ID,
+        const Identifier& NYM_ID,
+        const Identifier& ACCOUNT_ID,
+        int32_t nBoxType,
+        const std::set<int64_t>& numbers) const;
+
     EXPORT int32_t
         queryInstrumentDefinitions(const Identifier& NOTARY_ID,
                                    const Identifier& NYM_ID,
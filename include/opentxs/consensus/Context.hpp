@@ -41,6 +41,7 @@
 
 #include "opentxs/core/contract/Signable.hpp"
 #include "opentxs/core/Identifier.hpp"
+#include "opentxs/core/NumRanges.hpp"
 #include "opentxs/core/Proto.hpp"
 #include "opentxs/core/Types.hpp"
 
@@ -68,9 +69,11 @@ private:
     Identifier local_nymbox_hash_;
     Identifier remote_nymbox_hash_;
     std::atomic<RequestNumber> request_number_;
-    std::set<RequestNumber> acknowledged_request_numbers_;
-    std::set<TransactionNumber> available_transaction_numbers_;
-    std::set<TransactionNumber> issued_transaction_numbers_;
+    // Numbers are handed out in contiguous blocks, so these are stored as
+    // ranges.
+    NumRanges acknowledged_request_numbers_;
+    NumRanges available_transaction_numbers_;
+    NumRanges issued_transaction_numbers_;
 
     proto::Context contract(const Lock& lock) const;
     proto::Context IDVersion(const Lock& lock) const;
@@ -91,6 +94,10 @@ private:
 protected:
     typedef std::unique_lock<std::mutex> Lock;
 
+    /** Set by every mutator. Wallet::save() only re-signs and stores the
+     *  context when this is true. */
+    std::atomic<bool> dirty_{true};
+
     Identifier GetID(const Lock& lock) const override;
 
     virtual proto::Context serialize(
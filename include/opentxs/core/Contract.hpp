@@ -52,6 +52,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace irr
 {
@@ -403,6 +404,17 @@ public:
         const proto::HashType hashType,
         const OTPasswordData* pPWData = nullptr) const;
     EXPORT const Nym* GetContractPublicNym() const;
+
+    /** Checks theNym's signing-key signature on each contract, as
+     *  VerifySignature(theNym) would, but submits every candidate signature to
+     *  CryptoAsymmetric::VerifyBatch() at once so they are checked in
+     *  parallel. output[i] holds the result for contracts[i]. Returns true
+     *  only if every contract verified. */
+    EXPORT static bool VerifySignatures(
+        const std::vector<const Contract*>& contracts,
+        const Nym& theNym,
+        std::vector<bool>& output,
+        const OTPasswordData* pPWData = nullptr);
 };
 }  // namespace opentxs
 #endif  // OPENTXS_CORE_CONTRACT_HPP
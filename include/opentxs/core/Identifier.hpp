@@ -43,6 +43,9 @@
 #include "opentxs/core/Proto.hpp"
 #include "opentxs/core/Types.hpp"
 
+#include <cstddef>
+#include <cstring>
+#include <functional>
 #include <iosfwd>
 #include <string>
 
@@ -67,6 +70,10 @@ private:
 
     ID type_{DefaultType};
 
+    /** Orders identifiers by type, then by the raw digest bytes. Returns a
+     * negative value, zero, or a positive value like memcmp. */
+    int compare(const Identifier& rhs) const;
+
 public:
     EXPORT friend std::ostream& operator<<(std::ostream& os, const String& obj);
     EXPORT static bool validateID(const std::string& strPurportedID);
@@ -108,4 +115,27 @@ public:
     EXPORT virtual ~Identifier() = default;
 };
 }  // namespace opentxs
+
+namespace std
+{
+template <>
+struct hash<opentxs::Identifier> {
+    /** Identifiers are already uniformly distributed digests, so the leading
+     * bytes make a good hash without any further mixing. */
+    size_t operator()(const opentxs::Identifier& id) const
+    {
+        size_t output = 0;
+        const auto size = id.GetSize();
+
+        if (0 < size) {
+            std::memcpy(
+                &output,
+                id.GetPointer(),
+                (sizeof(output) < size) ? sizeof(output) : size);
+        }
+
+        return output;
+    }
+};
+}  // namespace std
 #endif  // OPENTXS_CORE_OTIDENTIFIER_HPP
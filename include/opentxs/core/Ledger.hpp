@@ -46,6 +46,7 @@
 #include <cstdint>
 #include <map>
 #include <set>
+#include <utility>
 
 namespace opentxs
 {
@@ -78,9 +79,32 @@ private: // Private prevents erroneous use by other classes.
         String strInput);
 
 private:
+    // (key, transaction number)
+    typedef std::set<std::pair<int64_t, int64_t>> setOfReceipts;
+
     mapOfTransactions m_mapTransactions; // a ledger contains a map of
                                          // transactions.
 
+    // Secondary indexes into m_mapTransactions, kept in sync by
+    // AddTransaction and RemoveTransaction. Every transaction is indexed by
+    // its in-ref-to number. Transfer receipts (by the number of origin of
+    // the acceptPending inside) and cheque/voucher receipts (by cheque
+    // number) can only be indexed by parsing the receipt, so those two are
+    // built the first time one of them is needed.
+    setOfReceipts m_setInRefTo;
+    setOfReceipts m_setTransferReceipts;
+    setOfReceipts m_setChequeReceipts;
+    std::map<int64_t, int64_t> m_mapReceiptKeys; // transaction number -> key
+    bool m_bReceiptIndexes{false};
+
+    OTTransaction* find_receipt(
+        const setOfReceipts& theIndex,
+        int64_t lKey) const;
+    void index_receipt(OTTransaction& theTransaction);
+    void index_transaction(OTTransaction& theTransaction);
+    void index_receipts();
+    void unindex_transaction(OTTransaction& theTransaction);
+
 protected:
     // return -1 if error, 0 if nothing, and 1 if the node was processed.
     int32_t ProcessXMLNode(irr::io::IrrXMLReader*& xml) override;
@@ -42,10 +42,14 @@
 #include "opentxs/core/String.hpp"
 #include "opentxs/core/util/Assert.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <deque>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
 
 #if defined(unix) || defined(__unix__) || defined(__unix) ||                   \
@@ -63,6 +67,7 @@ namespace opentxs
 
 typedef std::deque<String*> dequeOfStrings;
 
+class LogWriter;
 class OTLogStream;
 
 #ifdef _WIN32
@@ -86,17 +91,22 @@ OTLOG_IMPORT extern OTLogStream otLog3;  // logs using OTLog::vOutput(3)
 OTLOG_IMPORT extern OTLogStream otLog4;  // logs using OTLog::vOutput(4)
 OTLOG_IMPORT extern OTLogStream otLog5;  // logs using OTLog::vOutput(5)
 
+// Lines are assembled in a buffer belonging to the calling thread, so
+// several threads may write to the same stream without mixing up each
+// other's lines.
 class OTLogStream : public std::ostream, std::streambuf
 {
 private:
     int logLevel{0};
-    int next{0};
-    char* pBuffer{nullptr};
 
 public:
     explicit OTLogStream(int _logLevel);
     ~OTLogStream();
 
+    /** A stream whose level is above nLogLevel is left in a failed state, so
+     * anything inserted into it is discarded without being formatted. */
+    void SetLogLevel(int32_t nLogLevel);
+
     virtual int overflow(int c) override;
 };
 
@@ -104,20 +114,57 @@ public:
 class Log
 {
 private:
+    // Held by a thread for as long as it uses pLogger. While Init or Cleanup
+    // is replacing pLogger no lease can be taken, and logging falls back to
+    // stderr instead of waiting.
+    class Lease
+    {
+    public:
+        Lease();
+        ~Lease();
+
+        explicit operator bool() const { return held_; }
+
+    private:
+        bool held_{false};
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+    };
+
+    // Held by Init and Cleanup. Waits until every lease has been returned.
+    class Exclusive
+    {
+    public:
+        Exclusive();
+        ~Exclusive();
+
+    private:
+        Exclusive(const Exclusive&) = delete;
+        Exclusive& operator=(const Exclusive&) = delete;
+    };
+
     static Log* pLogger;
+    static std::atomic<std::size_t> s_nUsers;
+    static std::atomic<bool> s_bReplacing;
 
     static const String m_strVersion;
     static const String m_strPathSeparator;
 
+    // Guards logDeque, which any thread may log into.
+    std::mutex m_memlogLock;
     dequeOfStrings logDeque;
 
     String m_strThreadContext;
     String m_strLogFileName;
     String m_strLogFilePath;
 
-    int32_t m_nLogLevel{0};
+    std::atomic<int32_t> m_nLogLevel{0};
 
     bool m_bInitialized{false};
+    bool m_bStructured{false};
+
+    std::unique_ptr<LogWriter> m_pWriter;
 
     /** For things that represent internal inconsistency in the code. Normally
      * should NEVER happen even with bad input from user. (Don't call this
@@ -125,6 +172,11 @@ private:
     static Assert::fpt_Assert_sz_n_sz(logAssert);
 
     static bool CheckLogger(Log* pLogger);
+    static int32_t log_level();
+    static bool pop_memlog_back();
+    static bool log_to_file(std::string&& strOutput);
+    static void update_streams();
+    static void write(const char* szLevel, const char* szOutput);
 
 public:
     /** now the logger checks the global config file itself for the
@@ -162,6 +214,9 @@ public:
     //
 
     EXPORT static bool LogToFile(const String& strOutput);
+    /** Once initialized, log lines are written by a background thread. This
+     * returns after everything logged so far has reached the log file. */
+    EXPORT static void Flush();
 
     /** We keep 1024 logs in memory, to make them available via the API. */
     EXPORT static int32_t GetMemlogSize();
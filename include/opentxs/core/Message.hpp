@@ -56,7 +56,9 @@ namespace opentxs
 class Context;
 class Message;
 class Nym;
+class OTAsymmetricKey;
 class OTPasswordData;
+class OTSignature;
 class Tag;
 
 class OTMessageStrategy
@@ -98,8 +100,22 @@ protected:
     bool m_bIsSigned{false};
 
 private:
+    // Set by SetBinary() or LoadBinary()
+    bool binary_{false};
+    // The serialized fields which the signatures of a binary message cover
+    std::string binary_body_;
+
     bool updateContentsByType(Tag& parent);
 
+    bool load_binary_body();
+    bool sign_binary(const Nym& theNym, const OTPasswordData* pPWData);
+    void update_binary_contents();
+    bool verify_binary(
+        const OTAsymmetricKey& theKey,
+        const OTSignature& theSignature,
+        const OTPasswordData* pPWData) const;
+    bool verify_binary(const Nym& theNym, const OTPasswordData* pPWData) const;
+
     int32_t processXmlNodeAckReplies(Message& m, irr::io::IrrXMLReader*& xml);
     int32_t processXmlNodeAcknowledgedReplies(Message& m,
                                               irr::io::IrrXMLReader*& xml);
@@ -112,6 +128,31 @@ public:
 
     bool VerifyContractID() const override;
 
+    // Binary wire format
+    //
+    // In binary mode a message is signed over its serialized fields (see
+    // NotaryMessage.proto) instead of over its XML contents, so that it can
+    // be loaded again without running the XML parser. SaveContract() renders
+    // such a message as a base64 block between "NOTARY MESSAGE" bookends,
+    // which LoadContractFromString() also accepts, so that binary messages
+    // can still be stored or embedded in other messages as strings.
+    //
+    // The server answers each request in the encoding it arrived in, and
+    // sets m_bBinaryMessages on its replies. Clients only switch to the
+    // binary encoding once a server has advertised it that way.
+    EXPORT static bool IsBinary(const std::string& wire);
+    EXPORT bool Binary() const { return binary_; }
+    // Takes effect the next time the message is signed.
+    EXPORT void SetBinary(const bool binary);
+    EXPORT bool LoadBinary(const std::string& wire);
+    // Requires a message which was signed in binary mode, or loaded with
+    // LoadBinary().
+    EXPORT bool SerializeBinary(std::string& wire) const;
+
+    EXPORT bool LoadContractFromString(const String& theStr) override;
+    using Contract::SaveContract;
+    EXPORT bool SaveContract() override;
+
     EXPORT bool SignContract(const Nym& theNym,
                                      const OTPasswordData* pPWData = nullptr) override;
     EXPORT bool VerifySignature(
@@ -197,6 +238,8 @@ public:
                      // or false
     bool m_bBool{false};    // Some commands need to send a bool. This variable is for
                      // those.
+    bool m_bBinaryMessages{false}; // Set on replies from servers which accept
+                                   // binary requests.
     int64_t m_lTime{0}; // Timestamp when the message was signed.
 
     static OTMessageStrategyManager messageStrategyManager;
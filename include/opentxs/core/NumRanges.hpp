@@ -0,0 +1,146 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_NUMRANGES_HPP
+#define OPENTXS_CORE_NUMRANGES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+
+namespace opentxs
+{
+
+class String;
+
+/** A set of int64_t stored as sorted runs of consecutive numbers. Membership
+ * tests cost O(log runs), and a block of transaction numbers issued together
+ * costs a single entry however large it is. Serializes to and from strings
+ * such as "1-5,7,9-12". Plain comma-separated OTNumList strings are accepted
+ * too. */
+class NumRanges
+{
+public:
+    /** first number of each run -> last number of that run (inclusive) */
+    typedef std::map<int64_t, int64_t> Ranges;
+
+    /** Visits the individual numbers in ascending order. */
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int64_t value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const int64_t* pointer;
+        typedef const int64_t& reference;
+
+        reference operator*() const { return value_; }
+        EXPORT const_iterator& operator++();
+        EXPORT const_iterator operator++(int);
+        bool operator==(const const_iterator& rhs) const
+        {
+            return (range_ == rhs.range_) &&
+                   ((range_ == end_) || (value_ == rhs.value_));
+        }
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+    private:
+        friend class NumRanges;
+
+        Ranges::const_iterator range_;
+        Ranges::const_iterator end_;
+        int64_t value_{0};
+
+        const_iterator(
+            const Ranges::const_iterator& range,
+            const Ranges::const_iterator& end);
+    };
+
+    EXPORT NumRanges();
+    explicit EXPORT NumRanges(const String& strRanges);
+
+    /** if false, means the value was already there. */
+    EXPORT bool Add(const int64_t& theValue);
+
+    /** Adds every number from lFirst to lLast inclusive. */
+    EXPORT void AddRange(const int64_t& lFirst, const int64_t& lLast);
+
+    /** Adds the numbers from a serialized list of ranges. If false, means the
+     * string was malformed. (Everything before the error is still added.) */
+    EXPORT bool Add(const String& strRanges);
+
+    /** if false, means the value was NOT already there. */
+    EXPORT bool Remove(const int64_t& theValue);
+
+    /** returns true/false (whether value is already there.) */
+    EXPORT bool Verify(const int64_t& theValue) const;
+
+    /** The number at position nIndex, counting in ascending order. Costs
+     * O(runs). returns false if nIndex is out of range. */
+    EXPORT bool At(const std::size_t nIndex, int64_t& lOutput) const;
+
+    /** The lowest number in the set. returns false if empty. */
+    EXPORT bool Peek(int64_t& lPeek) const;
+
+    std::size_t Count() const { return m_lCount; }
+    bool empty() const { return m_mapRanges.empty(); }
+    const Ranges& GetRanges() const { return m_mapRanges; }
+
+    EXPORT const_iterator begin() const;
+    EXPORT const_iterator end() const;
+
+    /** Outputs the ranges as a comma-separated string such as "1-5,7"
+     * (for serialization, usually.) returns false if the set was empty. */
+    EXPORT bool Output(String& strOutput) const;
+    EXPORT void Release();
+
+private:
+    Ranges m_mapRanges;
+    std::size_t m_lCount{0};
+
+    Ranges::iterator find_range(const int64_t& theValue);
+    Ranges::const_iterator find_range(const int64_t& theValue) const;
+};
+
+}  // namespace opentxs
+
+#endif  // OPENTXS_CORE_NUMRANGES_HPP
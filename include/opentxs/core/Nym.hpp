@@ -43,6 +43,7 @@
 #include "opentxs/core/crypto/NymParameters.hpp"
 #include "opentxs/core/crypto/OTASCIIArmor.hpp"
 #include "opentxs/core/Identifier.hpp"
+#include "opentxs/core/NumRanges.hpp"
 #include "opentxs/core/NymIDSource.hpp"
 #include "opentxs/core/Proto.hpp"
 #include "opentxs/core/Types.hpp"
@@ -73,8 +74,7 @@ class Tag;
 class Wallet;
 
 typedef std::deque<Message*> dequeOfMail;
-typedef std::deque<int64_t> dequeOfTransNums;
-typedef std::map<std::string, dequeOfTransNums*> mapOfTransNums;
+typedef std::map<std::string, NumRanges> mapOfTransNums;
 typedef std::map<std::string, Identifier> mapOfIdentifiers;
 typedef std::map<std::string, CredentialSet*> mapOfCredentialSets;
 typedef std::list<OTAsymmetricKey*> listOfAsymmetricKeys;
@@ -43,6 +43,8 @@
 #include "opentxs/core/Item.hpp"
 #include "opentxs/core/Types.hpp"
 
+#include <memory>
+
 namespace opentxs
 {
 
@@ -342,7 +344,9 @@ same time that it is first being
 
  */
 
+class Cheque;
 class Ledger;
+class OTCronItem;
 class Tag;
 
 class OTTransaction : public OTTransactionType
@@ -591,6 +595,20 @@ enum transactionType {
                                        // amount (depending on type) and return
                                        // it.
 
+    // The reference string decoded as an item (pending, transferReceipt,
+    // chequeReceipt...), as the cheque attached to that depositCheque item
+    // (chequeReceipt, voucherReceipt), or as a cron item (paymentReceipt,
+    // finalReceipt). Each is decoded the first time it's asked for and kept
+    // until the reference string or number changes, so a receipt is parsed
+    // once no matter how many times it's inspected. Returns nullptr if the
+    // reference doesn't decode as that type. The transaction keeps ownership:
+    // don't delete the result, and don't hold onto it past the next change to
+    // this transaction. The item's number of origin is calculated when it's
+    // decoded, so read it with GetRawNumberOfOrigin().
+    EXPORT const Item* GetReferenceItem(const Identifier& theNotaryID);
+    EXPORT Cheque* GetReferenceCheque(const Identifier& theNotaryID);
+    EXPORT OTCronItem* GetReferenceCronItem();
+
     EXPORT static OTTransaction* GenerateTransaction(
         const Identifier& theNymID, const Identifier& theAccountID,
         const Identifier& theNotaryID, transactionType theType,
@@ -836,6 +854,23 @@ protected:
     // marked as "rejected." All the client has to do is check m_bCancelled
     // to see if it's set to TRUE, and it will know.
     bool m_bCancelled{false};
+
+private:
+    void ReleaseReferenceCache();
+    void ValidateReferenceCache(const Identifier& theNotaryID);
+
+    // Decoded from m_ascInReferenceTo. (See GetReferenceItem.) Valid while
+    // m_lReferenceCacheRevision matches m_lReferenceRevision and, for the
+    // item and cheque, m_ReferenceCacheNotaryID is the notary they were
+    // verified against.
+    std::unique_ptr<Item> m_pReferenceItem;
+    std::unique_ptr<Cheque> m_pReferenceCheque;
+    std::unique_ptr<OTCronItem> m_pReferenceCronItem;
+    Identifier m_ReferenceCacheNotaryID;
+    int64_t m_lReferenceCacheRevision{-1};
+    bool m_bReferenceItemLoaded{false};
+    bool m_bReferenceChequeLoaded{false};
+    bool m_bReferenceCronItemLoaded{false};
 };
 
 } // namespace opentxs
@@ -593,6 +593,9 @@ protected:
     originType m_originType{originType::not_applicable}; // (See originType comment.)
     OTASCIIArmor m_ascInReferenceTo; // This item may be in reference to a
                                      // different item.
+    // Bumped whenever m_ascInReferenceTo or m_lInReferenceToTransaction
+    // changes, so that anything decoded from them can tell it's stale.
+    int64_t m_lReferenceRevision{0};
     bool m_bLoadSecurely{true}; // Defaults to true.
     // For a "blank" or "successNotice" transaction, this contains the list of
     // transaction
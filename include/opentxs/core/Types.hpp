@@ -218,6 +218,14 @@ enum class ConnectionState : std::uint8_t {
     STALLED = 2
 };
 
+// zlib level used when armoring strings. The level is recorded in the zlib
+// stream header, so armor written with any level can be read by all versions.
+enum class ArmorCompression : std::uint8_t {
+    NONE = 0,
+    FAST = 1,
+    BEST = 9
+};
+
 typedef std::pair<SendResult, std::unique_ptr<std::string>> NetworkReplyRaw;
 typedef std::pair<SendResult, std::unique_ptr<String>> NetworkReplyString;
 typedef std::pair<SendResult, std::unique_ptr<Message>> NetworkReplyMessage;
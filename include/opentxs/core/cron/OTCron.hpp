@@ -55,6 +55,9 @@ class Nym;
 typedef std::map<int64_t, OTCronItem*> mapOfCronItems;
 /** multimapOfCronItems: Mapped to date the item was added to Cron. */
 typedef std::multimap<time64_t, OTCronItem*> multimapOfCronItems;
+/** multimapOfCronSchedule: Transaction numbers, mapped to the time the item is
+ * next due for processing. */
+typedef std::multimap<time64_t, int64_t> multimapOfCronSchedule;
 /** Mapped (uniquely) to market ID. */
 typedef std::map<std::string, OTMarket*> mapOfMarkets;
 /** Cron stores a bunch of these on this list, which the server refreshes from
@@ -74,6 +77,10 @@ private:
     // Cron Items are found on both lists.
     mapOfCronItems m_mapCronItems;
     multimapOfCronItems m_multimapCronItems;
+    // Each item is also scheduled once, by the time it next needs processing,
+    // so that each round only visits the items which are due.
+    multimapOfCronSchedule m_multimapSchedule;
+    std::map<int64_t, multimapOfCronSchedule::iterator> m_mapSchedule;
     // Always store this in any object that's associated with a specific server.
     Identifier m_NOTARY_ID;
     // I can't put receipts in people's inboxes without a supply of these.
@@ -94,6 +101,9 @@ private:
 
     static Timer tCron;
 
+    void ScheduleItem(const OTCronItem& theItem, time64_t tNotBefore);
+    void UnscheduleItem(int64_t lTransactionNum);
+
 public:
     static int32_t GetCronMsBetweenProcess()
     {
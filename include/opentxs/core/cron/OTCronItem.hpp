@@ -210,6 +210,11 @@ public:
         return m_PROCESS_INTERVAL;
     }
 
+    // The earliest time at which ProcessCron() will do anything more than
+    // decline to run because its process interval hasn't elapsed yet.
+    // OTCron uses this to skip items which aren't due.
+    virtual time64_t GetNextCronDue() const;
+
     inline OTCron* GetCron() const
     {
         return m_pCron;
@@ -43,7 +43,9 @@
 #include "opentxs/core/String.hpp"
 #include "opentxs/core/Types.hpp"
 
+#include <cstddef>
 #include <set>
+#include <vector>
 
 namespace opentxs
 {
@@ -60,9 +62,35 @@ class CryptoAsymmetric
 {
 
 public:
+    /** One (plaintext, key, signature) check submitted to VerifyBatch(). The
+     *  referenced objects must outlive the call. */
+    class Verification
+    {
+    public:
+        const OTData* plaintext_{nullptr};
+        const OTAsymmetricKey* key_{nullptr};
+        const OTData* signature_{nullptr};
+        proto::HashType hash_type_{proto::HASHTYPE_ERROR};
+
+        Verification(
+            const OTData& plaintext,
+            const OTAsymmetricKey& key,
+            const OTData& signature,
+            const proto::HashType hashType);
+    };
 
     static proto::AsymmetricKeyType CurveToKeyType(const EcdsaCurve& curve);
     static EcdsaCurve KeyTypeToCurve(const proto::AsymmetricKeyType& type);
+    /** Verify every entry in batch, spreading the work across up to threads
+     *  workers (0 means one per hardware thread). Workers come from a pool
+     *  kept for the life of the process; small batches are checked on the
+     *  calling thread. output[i] holds the result for batch[i]. Returns true
+     *  only if every signature verified. */
+    static bool VerifyBatch(
+        const std::vector<Verification>& batch,
+        std::vector<bool>& output,
+        const std::size_t threads = 0,
+        const OTPasswordData* pPWData = nullptr);
 
     bool SignContract(
         const String& strContractUnsigned,
@@ -70,9 +70,8 @@ protected:
         const std::uint8_t* inputStart,
         const std::size_t& inputSize) const;
     bool Base64Decode(
-        const std::string&& input,
-         RawData& output) const;
-    std::string BreakLines(const std::string& input) const;
+        const std::string& input,
+        RawData& output) const;
 
     CryptoEncodingEngine() = delete;
     CryptoEncodingEngine(CryptoEngine& parent);
@@ -82,7 +81,6 @@ protected:
 
 public:
     static std::string SanatizeBase58(const std::string& input);
-    static std::string SanatizeBase64(const std::string& input);
 
     std::string DataEncode(const std::string& input) const;
     std::string DataEncode(const OTData& input) const;
@@ -40,8 +40,10 @@
 #define OPENTXS_CORE_CRYPTO_OTASCIIARMOR_HPP
 
 #include "opentxs/core/String.hpp"
+#include "opentxs/core/Types.hpp"
 
 #include <stdint.h>
+#include <atomic>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -103,6 +105,12 @@ class OTASCIIArmor : public String
 public:
     static OTDB::OTPacker* GetPacker();
 
+    /** Selects the zlib level used by SetString. Reading is unaffected. */
+    EXPORT static void SetCompression(const ArmorCompression level);
+    EXPORT static ArmorCompression Compression();
+    /** Parses "none", "fast" or "best". Unknown values select "best". */
+    EXPORT static ArmorCompression ParseCompression(const std::string& level);
+
     EXPORT OTASCIIArmor();
     EXPORT OTASCIIArmor(const char* szValue);
     EXPORT OTASCIIArmor(const OTData& theValue);
@@ -182,6 +190,7 @@ private:
     std::string decompress_string(const std::string& str) const;
 
     static std::unique_ptr<OTDB::OTPacker> s_pPacker;
+    static std::atomic<ArmorCompression> s_compression;
 };
 
 }  // namespace opentxs
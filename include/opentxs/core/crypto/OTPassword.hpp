@@ -204,15 +204,14 @@ public:
 
 private:
     uint32_t size_{0};
-    uint8_t data_[DEFAULT_SIZE]{};
+    // Allocated from SecureArena, which keeps it locked in memory
+    uint8_t* data_{nullptr};
     bool isText_{false};
     bool isBinary_{false};
-    bool isPageLocked_{false};
     const BlockSize blockSize_{DEFAULT_SIZE};
     uint32_t position_{};
 
-    bool ot_lockPage(void* addr, size_t len);
-    bool ot_unlockPage(void* addr, size_t len);
+    void allocate();
 };
 
 } // namespace opentxs
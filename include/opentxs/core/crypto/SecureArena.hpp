@@ -0,0 +1,122 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_CRYPTO_SECUREARENA_HPP
+#define OPENTXS_CORE_CRYPTO_SECUREARENA_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace opentxs
+{
+
+// Page-locked storage for secrets (OTPassword buffers)
+//
+// Rather than calling mlock / munlock on every buffer, memory is carved out
+// of a few slabs which are mapped with a PROT_NONE guard page on either side
+// and locked once, when the slab is created. Every slab serves one of a small
+// number of power-of-two size classes. Freed chunks are zeroed and kept on
+// the free list of their class for reuse; slabs are never returned to the
+// system.
+//
+// Requests larger than the largest class, or made when a slab can not be
+// mapped, are served from the ordinary heap (they are still zeroed on free)
+// and show up in Stats::fallback_.
+class SecureArena
+{
+public:
+    struct Stats {
+        // Slabs mapped and the bytes they hold (excluding guard pages)
+        std::uint64_t slabs_{0};
+        std::uint64_t slab_bytes_{0};
+        // Portion of slab_bytes_ that mlock succeeded on
+        std::uint64_t locked_bytes_{0};
+        // Chunks currently handed out and their size class total
+        std::uint64_t chunks_in_use_{0};
+        std::uint64_t bytes_in_use_{0};
+        // Lifetime counters
+        std::uint64_t allocations_{0};
+        std::uint64_t frees_{0};
+        // Allocations currently served from the ordinary heap
+        std::uint64_t fallback_{0};
+    };
+
+    EXPORT static SecureArena& It();
+
+    // Never returns nullptr. The returned memory is zeroed.
+    EXPORT void* Allocate(const std::size_t size);
+    // size must be the value that was passed to Allocate.
+    EXPORT void Free(void* chunk, const std::size_t size);
+    EXPORT Stats GetStats() const;
+
+    ~SecureArena() = default;
+
+private:
+    typedef std::lock_guard<std::mutex> Lock;
+
+    static const std::size_t MIN_CLASS_SHIFT{6};   // 64 bytes
+    static const std::size_t MAX_CLASS_SHIFT{15};  // 32768 bytes
+    static const std::size_t CLASSES{MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1};
+    static const std::size_t SLAB_SIZE{65536};
+
+    mutable std::mutex lock_;
+    // Usable region of each slab, keyed by start address -> end address
+    std::map<std::uintptr_t, std::uintptr_t> slabs_;
+    std::array<std::vector<std::uint8_t*>, CLASSES> free_{};
+    Stats stats_{};
+    bool warned_{false};
+
+    static std::size_t size_class(const std::size_t size);
+
+    bool in_slab(const void* chunk) const;
+    bool new_slab(const std::size_t sizeClass);
+
+    SecureArena() = default;
+    SecureArena(const SecureArena&) = delete;
+    SecureArena(SecureArena&&) = delete;
+    SecureArena& operator=(const SecureArena&) = delete;
+    SecureArena& operator=(SecureArena&&) = delete;
+};
+
+}  // namespace opentxs
+
+#endif  // OPENTXS_CORE_CRYPTO_SECUREARENA_HPP
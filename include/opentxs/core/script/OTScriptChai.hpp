@@ -75,6 +75,14 @@ public:
 
     bool ExecuteScript(OTVariable* pReturnVar = nullptr) override;
     chaiscript::ChaiScript* const chai{nullptr};
+
+private:
+    // Constructing an interpreter (and its standard library) is far more
+    // expensive than running a typical clause, so interpreters are pooled.
+    // Each one is reset to its freshly constructed state before it is
+    // reused, so nothing bound for one script is visible to the next.
+    static chaiscript::ChaiScript* acquire_interpreter();
+    static void release_interpreter(chaiscript::ChaiScript* interpreter);
 };
 
 
@@ -72,6 +72,10 @@ class TradeListMarket;
 #define MAX_MARKET_QUERY_DEPTH                                                 \
     50 // todo add this to the ini file. (Now that we actually have one.)
 
+// Fills are journaled between saves of the market file. After this many, the
+// market file is signed and written again and the journal starts over.
+#define OT_MARKET_JOURNAL_LIMIT 50
+
 // Multiple offers, mapped by price limit.
 // Using multi-map since there will be more than one offer for each single
 // price.
@@ -118,6 +122,29 @@ private:
     int64_t m_lLastSalePrice{0};
     std::string m_strLastSaleDate;
 
+    // Incremented whenever an offer is added, removed, or filled. (Not saved
+    // to storage, only used while the software is running.)
+    int64_t m_lBookRevision{0};
+
+    // The armored form of each offer, as written by UpdateContents(), mapped
+    // by transaction number. Offers only change when they are filled, so
+    // most of them can be reused each time the market is saved.
+    std::map<int64_t, std::string> m_mapArmoredOffers;
+
+    const std::string& GetArmoredOffer(OTOffer& theOffer);
+
+    // The offers filled since the market file was last written, armored on
+    // one line and mapped by transaction number. Each fill rewrites the
+    // journal (markets/<market_ID>.journal) instead of re-signing the whole
+    // market. LoadMarket() replays it and SaveMarket() empties it.
+    std::map<int64_t, std::string> m_mapJournal;
+    int32_t m_nJournaledFills{0};
+
+    bool JournalFill(OTOffer& theOffer, OTOffer& theOtherOffer);
+    bool SaveJournal();
+    bool ReplayJournal();
+    void SaveRecentTrades();
+
     // The server stores a map of markets, one for each unique combination of
     // instrument definitions.
     // That's what this market class represents: one instrument definition being
@@ -173,6 +200,13 @@ public:
                       OTOffer& theOtherOffer);
     bool ProcessTrade(OTTrade& theTrade, OTOffer& theOffer);
 
+    // A trade which has already been matched against this revision of the
+    // book can not match anything new until the book changes.
+    inline const int64_t& GetBookRevision() const
+    {
+        return m_lBookRevision;
+    }
+
     int64_t GetHighestBidPrice();
     int64_t GetLowestAskPrice();
 
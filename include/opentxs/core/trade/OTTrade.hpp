@@ -117,6 +117,9 @@ private:
 
     String marketOffer_; // The market offer associated with this trade.
 
+    int64_t bookRevision_{-1}; // The revision of the market's book this offer
+                               // was last matched against. (Not saved.)
+
 protected:
     void onFinalReceipt(OTCronItem& origCronItem,
                                 const int64_t& newTransactionNumber,
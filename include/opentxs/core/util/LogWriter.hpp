@@ -0,0 +1,120 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_CORE_UTIL_LOGWRITER_HPP
+#define OPENTXS_CORE_UTIL_LOGWRITER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace opentxs
+{
+
+// Background writer used by Log once it has been initialized
+//
+// Callers hand finished log lines to a bounded lock-free ring buffer which
+// may have any number of producers and exactly one consumer. Each slot
+// carries a sequence number telling producers whether it is free and the
+// consumer whether it has been published, so neither side takes a lock.
+// Producers only wait if the ring is full.
+//
+// A single thread drains the ring into stderr and into a log file which it
+// keeps open, flushing once per batch rather than once per line. When
+// maxSize is non-zero the file is rotated (path.1, path.2, ...) once it
+// grows beyond that many bytes, keeping at most maxFiles old files.
+class LogWriter
+{
+public:
+    LogWriter(
+        const std::string& path,
+        const std::uint64_t maxSize,
+        const std::uint32_t maxFiles);
+    ~LogWriter();
+
+    // Returns once everything pushed before the call has been written.
+    void Flush();
+    void Push(std::string&& line);
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> sequence_{0};
+        std::string line_;
+    };
+
+    static const std::uint64_t capacity_{4096};
+    static const std::uint64_t mask_{capacity_ - 1};
+
+    const std::string path_;
+    const std::uint64_t max_size_{0};
+    const std::uint32_t max_files_{0};
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<std::uint64_t> head_{0};
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<bool> running_{true};
+    std::atomic<bool> sleeping_{false};
+    std::uint64_t tail_{0};
+    std::uint64_t size_{0};
+    std::ofstream file_;
+    std::mutex lock_;
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    std::thread thread_;
+
+    bool drain();
+    bool empty() const;
+    void open();
+    void rotate();
+    void run();
+    void wake();
+
+    LogWriter() = delete;
+    LogWriter(const LogWriter&) = delete;
+    LogWriter(LogWriter&&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+    LogWriter& operator=(LogWriter&&) = delete;
+};
+
+}  // namespace opentxs
+
+#endif  // OPENTXS_CORE_UTIL_LOGWRITER_HPP
@@ -43,7 +43,11 @@
 #include "opentxs/network/ZMQ.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <ctime>
+#include <future>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -55,48 +59,100 @@ namespace opentxs
 class ServerContract;
 class String;
 
+// Requests are sent over a DEALER socket, each one prefixed with a tag frame
+// and an empty delimiter frame. The server's REP workers treat the tag as part
+// of the routing envelope and echo it back, so any number of requests can be
+// in flight and replies are matched to their requests in whatever order they
+// arrive. This works against both the ROUTER front end and a plain REP
+// server.
+//
+// The DEALER socket belongs to a dedicated I/O thread. Callers hand it
+// requests through an inproc PUSH/PULL pair, since zmq sockets must not be
+// shared between threads. The futures returned by SendAsync are fulfilled by
+// that thread as soon as the matching reply (or a timeout) arrives, so they
+// may be polled with wait_for.
+//
+// Messages which were signed in binary mode (see Message::SetBinary) are sent
+// without the armoring. Binary() says whether requests to this server should
+// be signed that way. It starts out false, and is switched on by
+// EnableBinary() once the server has advertised support in a reply, provided
+// binary messages are enabled in the client's configuration. Requests are
+// never resent in the other encoding.
 class ServerConnection
 {
 private:
     friend class ZMQ;
 
+    struct Pending {
+        std::chrono::steady_clock::time_point deadline_;
+        // Which of the promises below the caller is waiting on
+        bool message_{false};
+        std::promise<NetworkReplyRaw> promise_;
+        std::promise<NetworkReplyMessage> message_promise_;
+    };
+
     std::shared_ptr<const ServerContract> remote_contract_;
     const std::string remote_endpoint_;
+    const std::string queue_endpoint_;
     zsock_t* request_socket_{nullptr};
+    zsock_t* pull_socket_{nullptr};
+    zsock_t* push_socket_{nullptr};
     std::unique_ptr<std::mutex> lock_;
     std::unique_ptr<std::thread> thread_;
+    std::unique_ptr<std::thread> io_thread_;
+    std::mutex pending_lock_;
+    std::map<std::uint64_t, Pending> pending_;
+    std::atomic<std::uint64_t> next_tag_{0};
     std::atomic<std::time_t> last_activity_;
     std::atomic<bool>& shutdown_;
     std::atomic<bool> status_;
     std::atomic<std::chrono::seconds>& keep_alive_;
+    const bool binary_allowed_{false};
+    std::atomic<bool> binary_;
 
+    static std::string GetQueueEndpoint();
     static std::string GetRemoteEndpoint(
         const std::string& server,
         std::shared_ptr<const ServerContract>& contract);
+    static NetworkReplyMessage ReplyMessage(NetworkReplyRaw&& raw);
 
+    void Expire(const bool all);
+    void Finish(
+        const std::uint64_t tag,
+        const SendResult result,
+        const std::string& reply = "");
+    bool Forward();
     void Init();
-    bool Receive(std::string& reply);
+    void IOThread();
+    Pending& Queue(const std::uint64_t tag);
+    void Receive();
     void ResetSocket();
     void ResetTimer();
     void SetRemoteKey();
     void SetProxy();
     void SetTimeouts();
+    void Submit(const std::uint64_t tag, const std::string& message);
     void Thread();
 
     ServerConnection() = delete;
     ServerConnection(
         const std::string& server,
         std::atomic<bool>& shutdown,
-        std::atomic<std::chrono::seconds>& keepAlive);
+        std::atomic<std::chrono::seconds>& keepAlive,
+        const bool binary);
     ServerConnection(const ServerConnection&) = delete;
     ServerConnection(ServerConnection&&) = delete;
     ServerConnection& operator=(const ServerConnection&) = delete;
     ServerConnection& operator=(ServerConnection&&) = delete;
 
 public:
+    bool Binary() const { return binary_.load(); }
+    void EnableBinary();
     NetworkReplyRaw Send(const std::string& message);
     NetworkReplyString Send(const String& message);
     NetworkReplyMessage Send(const Message& message);
+    std::future<NetworkReplyRaw> SendAsync(const std::string& message);
+    std::future<NetworkReplyMessage> SendAsync(const Message& message);
     bool Status() const;
 
     ~ServerConnection();
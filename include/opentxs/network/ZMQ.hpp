@@ -85,6 +85,7 @@ private:
     mutable std::atomic<bool> shutdown_;
 
     std::string socks_proxy_;
+    bool binary_messages_{false};
 
     std::map<std::string,std::unique_ptr<ServerConnection>> server_connections_;
 
@@ -98,6 +99,7 @@ private:
     ZMQ& operator=(const ZMQ&&) = delete;
 
 public:
+    bool BinaryMessages() const;
     std::chrono::seconds KeepAlive() const;
     void KeepAlive(const std::chrono::seconds duration) const;
     std::chrono::seconds Linger();
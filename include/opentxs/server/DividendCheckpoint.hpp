@@ -0,0 +1,109 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_SERVER_DIVIDENDCHECKPOINT_HPP
+#define OPENTXS_SERVER_DIVIDENDCHECKPOINT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace opentxs
+{
+
+// The saved state of a dividend payout (see PayDividendVisitor), from which
+// an interrupted payout can be finished.
+class DividendCheckpoint
+{
+public:
+    // One shareholder's voucher, collected by PayDividendVisitor::Trigger()
+    // and sent by PayDividendVisitor::Pay().
+    class Payout
+    {
+    public:
+        std::string recipient_;
+        int64_t amount_{0};
+        int64_t voucher_number_{0}; // issued to the server nym
+        int64_t receipt_number_{0}; // for the nymbox receipt
+        int32_t state_{0};
+    };
+
+    static const int32_t PAYOUT_PENDING = 0;
+    static const int32_t PAYOUT_PAID = 1;
+    static const int32_t PAYOUT_RETURNED = 2;
+    static const int32_t PAYOUT_FAILED = 3; // left over, returned at the end
+
+    // Written once the payer has been debited, before anything else happens.
+    // Resume refunds the payer from a checkpoint at this stage.
+    static const int32_t STAGE_FUNDS_MOVED = 1;
+    // Written once the payouts are collected and numbered. Resume sends
+    // whatever is still pending.
+    static const int32_t STAGE_PAYING = 0;
+
+    std::string notary_id_;
+    std::string nym_id_; // the payer
+    std::string payout_instrument_definition_id_;
+    std::string voucher_acct_id_;
+    // The original payDividend item, which is the memo of every voucher
+    std::string memo_;
+    int64_t payout_per_share_{0};
+    int64_t total_cost_{0};
+    int64_t leftover_number_{0}; // voucher number for returning leftovers
+    int32_t stage_{STAGE_PAYING};
+    // The balances the payer's account and the voucher reserve are saved
+    // with, so Resume can tell whether the debit and credit were saved.
+    std::string payer_acct_id_;
+    int64_t payer_balance_{0};
+    int64_t reserve_balance_{0};
+    std::vector<Payout> payouts_;
+
+    // Fails for a record which is malformed, or which does not end with the
+    // line Serialize() finishes with.
+    bool Parse(const std::string& record);
+    std::string Serialize() const;
+
+    bool Load(const std::string& filename);
+    // Writes the record to a temporary file, which is then renamed over
+    // filename. A crash therefore leaves either the previous checkpoint or
+    // this one, never a partial record.
+    bool Save(const std::string& filename) const;
+};
+
+} // namespace opentxs
+
+#endif // OPENTXS_SERVER_DIVIDENDCHECKPOINT_HPP
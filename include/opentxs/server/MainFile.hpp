@@ -39,6 +39,7 @@
 #ifndef OPENTXS_SERVER_MAINFILE_HPP
 #define OPENTXS_SERVER_MAINFILE_HPP
 
+#include <cstdint>
 #include <string>
 
 namespace opentxs
@@ -60,8 +61,20 @@ public:
     bool SaveMainFile();
     bool SaveMainFileToString(String& filename);
 
+    // The transaction number high-water mark is kept in its own small record,
+    // so reserving numbers does not require rewriting the main file.
+    bool LoadTransactionNumber(int64_t& number);
+    bool SaveTransactionNumber(const int64_t number);
+
 private:
+    // The record is written to two slots in turn, so a torn write can never
+    // destroy the last good value.
+    static const int TRANSACTION_NUMBER_SLOTS = 2;
+
+    std::string transaction_number_filename(const int slot) const;
+
     std::string version_;
+    int transaction_number_slot_;
     OTServer* server_; // TODO: remove when feasible
 };
 
@@ -41,15 +41,52 @@
 
 #include "opentxs/network/ZMQ.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace opentxs
 {
 
 class ServerLoader;
 class OTServer;
+class String;
 
+// Client requests arrive on a ROUTER socket and are handed out over an
+// inproc DEALER socket to a pool of worker threads. Cron runs on its own
+// thread.
+//
+// Requests may be ascii-armored XML or binary (see Message::IsBinary), and
+// each reply uses the encoding of its request. The time spent loading each
+// request and encoding its reply is logged per command and encoding at
+// verbosity 2.
+//
+// Requests from the same connection are handed to the workers one at a time,
+// in the order they arrived: a pipelining client may have several requests
+// in flight, and request numbers are checked strictly. The rest wait in a
+// queue on the ROUTER thread, so they do not hold up a worker. Requests from
+// the same nym are always processed one at a time. Commands
+// which only read server state (or rewrite the requesting nym's own boxes)
+// may run concurrently with each other; every other command, and cron, runs
+// exclusively. Concurrent commands still take turns using the server nym,
+// from the point where the request is authenticated until the reply is
+// signed, since its keys are not thread safe.
+//
+// That includes notarizeTransaction. A transaction can move funds into
+// another nym's account and inbox, and draws on the transaction number
+// counter, the main file and cron, none of which are synchronized on their
+// own, so the per-nym lock alone would not make it safe to run transactions
+// from different nyms side by side.
 class MessageProcessor
 {
 public:
@@ -58,15 +95,109 @@ public:
     EXPORT void run();
 
 private:
+    typedef std::unique_lock<std::mutex> Lock;
+
+    // Accumulated cost of one (command, encoding) pair, in microseconds
+    struct Timing {
+        std::atomic<std::int64_t> count_{0};
+        std::atomic<std::int64_t> parse_{0};
+        std::atomic<std::int64_t> serialize_{0};
+    };
+
+    struct NymLock {
+        std::mutex mutex_;
+        // Requests holding or waiting for mutex_. The entry is erased when
+        // this drops to zero.
+        std::size_t users_{0};
+    };
+
+    // Holds the lock for one nym while a request from that nym is processed.
+    // Entries only exist while a request for the nym is in flight, so
+    // requests naming arbitrary nyms can not grow the map.
+    class NymGuard
+    {
+    public:
+        NymGuard(MessageProcessor& parent, const std::string& nymID);
+        ~NymGuard();
+
+    private:
+        MessageProcessor& parent_;
+        const std::string nym_id_;
+        NymLock* lock_{nullptr};
+
+        NymGuard() = delete;
+        NymGuard(const NymGuard&) = delete;
+        NymGuard& operator=(const NymGuard&) = delete;
+    };
+
+    // Holds the notary lock, shared or exclusive, until it goes out of scope.
+    class NotaryGuard
+    {
+    public:
+        NotaryGuard(MessageProcessor& parent, const bool exclusive);
+        ~NotaryGuard();
+
+    private:
+        MessageProcessor& parent_;
+        const bool exclusive_{false};
+
+        NotaryGuard() = delete;
+        NotaryGuard(const NotaryGuard&) = delete;
+        NotaryGuard& operator=(const NotaryGuard&) = delete;
+    };
+
+    static std::size_t commandIndex(const String& command);
+    static std::string connectionID(zmsg_t* message);
+    static bool isSharedCommand(const String& command);
+
+    void forwardQueued(const std::string& connection);
+    void forwardReply(zmsg_t* message);
     void init(int port, zcert_t* transportKey);
+    void lockExclusive();
+    void lockShared();
     bool processMessage(const std::string& messageString, std::string& reply);
-    void processSocket();
+    void processSocket(zsock_t* socket);
+    void queueRequest(zmsg_t* message);
+    void recordTiming(
+        const String& command,
+        const bool binary,
+        const std::chrono::microseconds parse,
+        const std::chrono::microseconds serialize);
+    void runCron();
+    void runWorker();
+    void startThreads();
+    void stopThreads();
+    void unlockExclusive();
+    void unlockShared();
 
 private:
     OTServer* server_;
     zsock_t* zmqSocket_;
+    zsock_t* zmqBackend_;
     zactor_t* zmqAuth_;
     zpoller_t* zmqPoller_;
+
+    std::atomic<bool> shutdown_;
+    std::unique_ptr<std::thread> cron_;
+    std::vector<std::unique_ptr<std::thread>> workers_;
+
+    // Keyed by ROUTER identity. A connection has an entry while one of its
+    // requests is with a worker, holding the requests which arrived after
+    // it. Only used by the thread in run().
+    std::map<std::string, std::deque<zmsg_t*>> connection_queue_;
+
+    std::mutex nym_map_lock_;
+    std::map<std::string, NymLock> nym_lock_;
+
+    std::mutex notary_lock_;
+    std::condition_variable notary_signal_;
+    std::int64_t shared_count_;
+    std::int64_t exclusive_waiting_;
+    bool exclusive_;
+
+    // Indexed by commandIndex(), once per encoding. Unknown commands share
+    // the last entry.
+    std::vector<Timing> timing_;
 };
 
 } // namespace opentxs
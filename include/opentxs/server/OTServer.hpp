@@ -52,8 +52,9 @@
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
-
+#include <vector>
 
 namespace opentxs
 {
@@ -123,6 +124,16 @@ private:
                              Message* msg = nullptr,
                              const String* messageString = nullptr,
                              const char* command = nullptr);
+    // Drops several instruments into one recipient's nymbox, which is loaded,
+    // signed and saved only once. receiptNumbers holds an already issued
+    // receipt number for each instrument, so nothing here touches the
+    // transactor and batches for different recipients may run concurrently.
+    bool DropInstrumentsToNymbox(const Identifier& notaryID,
+                                 const Identifier& senderNymID,
+                                 const Identifier& recipientNymID,
+                                 const std::vector<String>& instruments,
+                                 const std::vector<int64_t>& receiptNumbers,
+                                 const char* command = nullptr);
 
 private:
     MainFile mainFile_;
@@ -145,6 +156,10 @@ private:
     // connect info.
 
     Nym m_nymServer;
+    // The server nym loads its keys lazily, which is not thread safe. Held
+    // whenever the server nym is used by a thread which may not be alone:
+    // shared requests (see MessageProcessor) and the dividend workers.
+    std::mutex server_nym_lock_;
 
     OTCron m_Cron; // This is where re-occurring and expiring tasks go.
 };
@@ -40,8 +40,12 @@
 #define OPENTXS_SERVER_ACCTFUNCTOR_PAYDIVIDEND_HPP
 
 #include "opentxs/core/AccountVisitor.hpp"
+#include "opentxs/server/DividendCheckpoint.hpp"
 
+#include <cstddef>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 namespace opentxs
 {
@@ -63,6 +67,31 @@ class String;
 //
 class PayDividendVisitor : public AccountVisitor
 {
+    typedef DividendCheckpoint::Payout Payout;
+
+    // Payouts are sent, and progress checkpointed, this many at a time.
+    static const std::size_t PAYOUT_BATCH = 256;
+
+    static std::string checkpoint_filename(const OTServer& theServer);
+
+    bool issue_voucher(const Identifier& theRecipientID, int64_t lAmount,
+                       int64_t lTransactionNumber, String& strOutput) const;
+    void erase_checkpoint() const;
+    void load_checkpoint(const DividendCheckpoint& checkpoint);
+    void pay_batch(const std::size_t begin, const std::size_t end);
+    bool refund();
+    bool return_to_sender(int64_t lAmount, int64_t lTransactionNumber);
+    bool run();
+    bool save_checkpoint() const;
+
+    std::vector<Payout> payouts_;
+    int64_t total_cost_{0};
+    int64_t leftover_number_{0}; // voucher number for returning leftovers
+    int32_t stage_{DividendCheckpoint::STAGE_PAYING};
+    std::string payer_acct_id_;
+    int64_t payer_balance_{0};
+    int64_t reserve_balance_{0};
+
     Identifier* m_pNymID{nullptr};
     Identifier* m_pPayoutInstrumentDefinitionID{nullptr};
     Identifier* m_pVoucherAcctID{nullptr};
@@ -119,7 +148,28 @@ public:
         return m_lAmountReturned;
     }
 
+    // Only records what theAccount's owner is owed. Nothing is sent until
+    // Pay().
     bool Trigger(Account& theAccount) override;
+
+    // Checkpoints the payout once lTotalCost has been debited from
+    // thePayerAcct and credited to theVoucherReserveAcct, before either
+    // account is saved. Until Pay() checkpoints again, Resume() refunds the
+    // payer.
+    bool Fund(int64_t lTotalCost, const Account& thePayerAcct,
+              const Account& theVoucherReserveAcct);
+
+    // Sends the vouchers collected by Trigger(), and returns whatever is
+    // left of the funds to the payer. Transaction numbers for the whole job
+    // are issued up front, and each batch costs one nymbox write per
+    // recipient. Vouchers are built in parallel, but signed one at a time,
+    // since the server nym may only be used by one thread at a time.
+    // Progress is checkpointed after every batch, so Resume() can finish the
+    // job after a crash.
+    bool Pay();
+
+    // Finishes a dividend payout interrupted by a crash, if there is one.
+    static bool Resume(OTServer& theServer);
 };
 
 } // namespace opentxs
@@ -77,6 +77,16 @@ struct ServerSettings
         __heartbeat_ms_between_beats = value;
     }
 
+    static int32_t GetWorkerThreads()
+    {
+        return __worker_threads;
+    }
+
+    static void SetWorkerThreads(int32_t value)
+    {
+        __worker_threads = value;
+    }
+
     static const std::string& GetOverrideNymID()
     {
         return __override_nym_id;
@@ -92,6 +102,9 @@ struct ServerSettings
     static int32_t __heartbeat_no_requests;
     static int32_t __heartbeat_ms_between_beats;
 
+    // The number of threads servicing client requests.
+    static int32_t __worker_threads;
+
     // The Nym who's allowed to do certain commands even if they are turned off.
     static std::string __override_nym_id;
     // Are usage credits REQUIRED in order to use this server?
@@ -45,6 +45,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace opentxs
 {
@@ -66,6 +67,12 @@ public:
 
     bool issueNextTransactionNumber(int64_t& txNumber);
     bool issueNextTransactionNumberToNym(Nym& nym, int64_t& txNumber);
+    // Issues count consecutive numbers with at most one reservation write.
+    bool issueNextTransactionNumbers(const int64_t count,
+                                     std::vector<int64_t>& numbers);
+    // As above, recording them on nym and saving its nymfile only once.
+    bool issueNextTransactionNumbersToNym(Nym& nym, const int64_t count,
+                                          std::vector<int64_t>& numbers);
     bool verifyTransactionNumber(Nym& nym, const int64_t& transactionNumber);
     bool removeTransactionNumber(Nym& nym, const int64_t& transactionNumber,
                                  bool save = false);
@@ -77,9 +84,19 @@ public:
         return transactionNumber_;
     }
 
+    // Sets the last issued transaction number. Any numbers which had been
+    // reserved beyond it are discarded.
     void transactionNumber(int64_t value)
     {
         transactionNumber_ = value;
+        reservedNumber_ = value;
+    }
+
+    // The highest transaction number which has been persisted as reserved.
+    // Every number up to and including this one may already have been issued.
+    int64_t reservedNumber() const
+    {
+        return reservedNumber_;
     }
 
     bool addBasketAccountID(const Identifier& basketId,
@@ -133,8 +150,16 @@ private:
     typedef std::map<std::string, std::string> BasketsMap;
 
 private:
+    // Transaction numbers are reserved from storage this many at a time.
+    static const int64_t TRANSACTION_NUMBER_BLOCK = 1000;
+
+    // Reserves enough numbers to issue count more, plus the rest of a block.
+    bool reserveTransactionNumbers(const int64_t count = 1);
+
     // This stores the last VALID AND ISSUED transaction number.
     int64_t transactionNumber_;
+    // This stores the high-water mark saved by the last reservation.
+    int64_t reservedNumber_;
     // maps basketId with basketAccountId
     BasketsMap idToBasketMap_;
     // basket issuer account ID, which is *different* on each server, using the
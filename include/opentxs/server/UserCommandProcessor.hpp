@@ -40,6 +40,7 @@
 #define OPENTXS_SERVER_USERCOMMANDPROCESSOR_HPP
 
 #include <cstdint>
+#include <mutex>
 
 namespace opentxs
 {
@@ -57,10 +58,16 @@ class UserCommandProcessor
 public:
     UserCommandProcessor(OTServer* server);
 
+    // If serverNymLock is set, it's held from the point where the request
+    // has been authenticated until the reply is signed, which covers every
+    // use of the server nym. Requests which run concurrently with each other
+    // pass it, since the server nym's keys can not be used from two threads
+    // at once.
     bool ProcessUserCommand(
         Message& msgIn,
         Message& msgOut,
-        ClientConnection* connection);
+        ClientConnection* connection,
+        std::mutex* serverNymLock = nullptr);
 
 private:
     OTServer* server_{nullptr};
@@ -45,6 +45,7 @@
 #include "opentxs/storage/StorageConfig.hpp"
 
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <ctime>
 #include <functional>
@@ -62,6 +63,7 @@ namespace opentxs
 {
 namespace storage
 {
+class Node;
 class Tree;
 }  // namespace storage
 
@@ -95,6 +97,9 @@ typedef std::function<void(const proto::UnitDefinition&)> UnitLambda;
 // to be implemented.
 class Storage
 {
+private:
+    friend class storage::Node;
+
 public:
     template <class T>
     bool LoadProto(
@@ -180,10 +185,30 @@ private:
     std::int64_t gc_interval_{std::numeric_limits<int64_t>::max()};
     std::unique_ptr<storage::Tree> tree_;
     std::unique_ptr<std::thread> gc_thread_;
+    mutable std::mutex transaction_lock_;
+    mutable std::condition_variable transaction_signal_;
+    // Depth of each thread's open batches. Guarded by transaction_lock_.
+    std::map<std::thread::id, std::size_t> batch_depth_;
+    // The thread whose batch holds the driver transaction, if any. Guarded
+    // by transaction_lock_.
+    mutable std::thread::id transaction_owner_;
+    // Maximum time in milliseconds index updates are held in memory before
+    // being written. Zero writes every change immediately.
+    std::int64_t commit_interval_{0};
+    // Set when the tree contains index changes which have not been written.
+    // Guarded by write_lock_.
+    bool dirty_{false};
+    std::atomic<bool> committing_{false};
+    std::condition_variable commit_signal_;
+    std::unique_ptr<std::thread> commit_thread_;
 
     void Cleanup_Storage();
     void CollectGarbage();
+    bool commit(const std::unique_lock<std::mutex>& lock);
+    bool commit_batch(const std::unique_lock<std::mutex>& lock);
+    bool defer_writes() const;
     bool MigrateKey(const std::string& key) const;
+    void PeriodicCommit();
     Editor<storage::Tree> tree();
     void RunMapPublicNyms(NymLambda lambda);
     void RunMapServers(ServerLambda lambda);
@@ -233,12 +258,36 @@ protected:
         const bool bucket) const = 0;
     virtual bool EmptyBucket(const bool bucket) = 0;
 
+    // Child classes which can group writes override these. Every write
+    // between StartTransaction and CommitTransaction should become durable
+    // together. Calls are never nested.
+    virtual bool StartTransaction() { return true; }
+    virtual bool CommitTransaction() { return true; }
+    // Child classes which override them run each write through this, so a
+    // write from a thread without a batch of its own waits for any other
+    // thread's batch to be committed instead of joining its transaction.
+    bool serialize_write(const std::function<bool()>& write) const;
+
     Storage(
         const StorageConfig& config,
         const Digest& hash,
         const Random& random);
 
 public:
+    // Write all deferred index changes and update the root hash
+    bool Commit();
+    // Writes between StartBatch and a matching CommitBatch are committed to
+    // the driver as a single transaction. Batches may be nested. Each
+    // Store/Set/Remove call is implicitly a batch of its own.
+    //
+    // Index changes made inside an explicit batch are held in memory and
+    // written once when the outermost batch is committed.
+    //
+    // Batches belong to the thread which opened them. While one thread has
+    // a batch open, writes from other threads wait for it to be committed,
+    // so they never become part of another thread's batch and are still
+    // durable when they return.
+    bool CommitBatch();
     ObjectList ContextList(const std::string& nymID);
     std::string DefaultSeed();
     bool Load(
@@ -342,6 +391,7 @@ public:
     bool SetUnitDefinitionAlias(
         const std::string& id,
         const std::string& alias);
+    bool StartBatch();
     bool Store(const proto::Context& data);
     bool Store(const proto::Credential& data);
     bool Store(
@@ -54,6 +54,9 @@ public:
     bool auto_publish_servers_ = true;
     bool auto_publish_units_ = true;
     int64_t gc_interval_ = 60 * 60 * 1;
+    // Milliseconds to hold index updates in memory before writing them.
+    // Zero makes every change durable before the call which made it returns.
+    int64_t commit_interval_ = 0;
     std::string path_;
     InsertCB dht_callback_;
 
@@ -70,6 +73,13 @@ public:
     std::string sqlite3_root_key_ = "a";
     std::string sqlite3_db_file_ = "opentxs.sqlite3";
 #endif
+
+#ifdef OT_STORAGE_JOURNAL
+    std::string journal_primary_bucket_ = "a";
+    std::string journal_secondary_bucket_ = "b";
+    std::string journal_root_file_ = "root";
+    int64_t journal_segment_size_ = 64 * 1024 * 1024;
+#endif
 };
 
 }  // namespace opentxs
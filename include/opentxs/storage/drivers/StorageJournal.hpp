@@ -0,0 +1,179 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#ifndef OPENTXS_STORAGE_STORAGEJOURNAL_HPP
+#define OPENTXS_STORAGE_STORAGEJOURNAL_HPP
+
+#include "opentxs/storage/Storage.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace opentxs
+{
+
+class OT;
+class StorageConfig;
+
+// Append-only journal implementation of opentxs::storage
+//
+// Each bucket is a directory of numbered segment files. Records are only ever
+// appended to the newest segment of a bucket, and an in-memory index maps
+// every key to the position of its value. The index is rebuilt by scanning
+// the segments at startup.
+//
+// Concurrent writers share fsync calls (group commit): a Store returns once
+// the segment data containing its record has been flushed, but only one
+// thread at a time issues the flush on behalf of everyone waiting.
+//
+// Garbage collection copies live keys into the other bucket, so emptying a
+// bucket amounts to compacting the store into fresh segments.
+class StorageJournal : public Storage
+{
+private:
+    typedef Storage ot_super;
+
+    friend class OT;
+
+    class Segment
+    {
+    public:
+        const int fd_;
+
+        explicit Segment(const int fd)
+            : fd_(fd)
+        {
+        }
+        ~Segment();
+
+    private:
+        Segment() = delete;
+        Segment(const Segment&) = delete;
+        Segment& operator=(const Segment&) = delete;
+    };
+
+    struct Position {
+        std::uint32_t segment_{0};
+        std::uint64_t offset_{0};
+        std::uint32_t size_{0};
+    };
+
+    struct Bucket {
+        std::string folder_;
+        std::map<std::uint32_t, std::shared_ptr<Segment>> segments_;
+        std::unordered_map<std::string, Position> index_;
+        std::uint32_t current_{0};
+        std::uint64_t tail_{0};
+    };
+
+    std::string folder_;
+    mutable std::mutex lock_;
+    mutable std::condition_variable sync_;
+    mutable Bucket buckets_[2];
+    mutable std::set<std::shared_ptr<Segment>> dirty_;
+    mutable std::uint64_t written_{0};
+    mutable std::uint64_t synced_{0};
+    mutable bool syncing_{false};
+    mutable bool failed_{false};
+
+    static std::uint32_t checksum(
+        const std::string& key,
+        const std::string& value);
+    static std::string segment_name(
+        const std::string& folder,
+        const std::uint32_t segment);
+
+    std::string GetBucketName(const bool bucket) const
+    {
+        return bucket ? config_.journal_secondary_bucket_
+                      : config_.journal_primary_bucket_;
+    }
+
+    bool append(
+        Bucket& bucket,
+        const std::string& key,
+        const std::string& value) const;
+    bool flush(
+        std::unique_lock<std::mutex>& lock,
+        const std::uint64_t sequence) const;
+    bool open_segment(Bucket& bucket, const std::uint32_t segment) const;
+    bool replay(Bucket& bucket, const std::uint32_t segment);
+    bool replay_bucket(Bucket& bucket);
+
+    void Init_StorageJournal();
+    void Purge(const std::string& path);
+
+    void Cleanup_StorageJournal();
+
+    StorageJournal(
+        const StorageConfig& config,
+        const Digest& hash,
+        const Random& random);
+    StorageJournal() = delete;
+    StorageJournal(const StorageJournal&) = delete;
+    StorageJournal(StorageJournal&&) = delete;
+    StorageJournal& operator=(const StorageJournal&) = delete;
+    StorageJournal& operator=(StorageJournal&&) = delete;
+
+public:
+    std::string LoadRoot() const override;
+    bool StoreRoot(const std::string& hash) override;
+    using ot_super::Load;
+    bool Load(
+        const std::string& key,
+        std::string& value,
+        const bool bucket) const override;
+    using ot_super::Store;
+    bool Store(
+        const std::string& key,
+        const std::string& value,
+        const bool bucket) const override;
+    bool EmptyBucket(const bool bucket) override;
+
+    void Cleanup() override;
+    ~StorageJournal();
+};
+
+}  // namespace opentxs
+#endif // OPENTXS_STORAGE_STORAGEJOURNAL_HPP
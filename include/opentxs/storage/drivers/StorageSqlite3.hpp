@@ -41,6 +41,9 @@
 
 #include "opentxs/storage/Storage.hpp"
 
+#include <map>
+#include <mutex>
+#include <string>
 
 extern "C"
 {
@@ -64,6 +67,11 @@ private:
 
     std::string folder_;
     sqlite3* db_ = nullptr;
+    // Compiled statements, keyed by table name. Guarded by statement_lock_
+    // since a statement can only be stepped by one thread at a time.
+    mutable std::mutex statement_lock_;
+    mutable std::map<std::string, sqlite3_stmt*> select_;
+    mutable std::map<std::string, sqlite3_stmt*> upsert_;
 
     std::string GetTableName(const bool bucket) const
     {
@@ -81,6 +89,11 @@ private:
         const std::string& tablename,
         const std::string& value) const;
     bool Create(const std::string& tablename);
+    void Finalize(const std::string& tablename) const;
+    sqlite3_stmt* Prepare(
+        std::map<std::string, sqlite3_stmt*>& cache,
+        const std::string& tablename,
+        const std::string& query) const;
     bool Purge(const std::string& tablename);
 
     void Init_StorageSqlite3();
@@ -109,6 +122,8 @@ public:
         const std::string& value,
         const bool bucket) const override;
     bool EmptyBucket(const bool bucket) override;
+    bool StartTransaction() override;
+    bool CommitTransaction() override;
 
     void Cleanup_StorageSqlite3();
     void Cleanup() override;
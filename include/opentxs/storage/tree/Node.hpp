@@ -45,6 +45,7 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <tuple>
@@ -131,6 +132,31 @@ protected:
         return storage_.LoadProto<T>(std::get<0>(it->second), output, checking);
     }
 
+    // Writes out a child node with deferred changes, then copies its root
+    // hash into the field used by this node's index
+    template <class T>
+    void flush_child(
+        std::mutex& childLock,
+        const std::unique_ptr<T>& child,
+        std::string& root) const
+    {
+        std::unique_lock<std::mutex> lock(childLock);
+        T* node = child.get();
+        lock.unlock();
+
+        if (nullptr == node) {
+            return;
+        }
+
+        if (!node->Flush()) {
+            std::cerr << __FUNCTION__ << ": Save error" << std::endl;
+            abort();
+        }
+
+        lock.lock();
+        root = node->Root();
+    }
+
     template <class T>
     void map(const std::function<void(const T&)> input) const
     {
@@ -165,11 +191,15 @@ protected:
 
     std::uint32_t version_{0};
     std::string root_;
+    // Set when a save was deferred, meaning root_ is out of date
+    bool dirty_{false};
 
     mutable std::mutex write_lock_;
     mutable Index item_map_;
 
     bool check_hash(const std::string& hash) const;
+    bool deferred(const std::unique_lock<std::mutex>& lock);
+    virtual void flush_children(const std::unique_lock<std::mutex>&) {}
     std::string get_alias(const std::string& id) const;
     bool load_raw(
         const std::string& id,
@@ -206,6 +236,7 @@ protected:
         const std::string& key);
 
 public:
+    bool Flush();
     ObjectList List() const;
     virtual bool Migrate() const;
     std::string Root() const;
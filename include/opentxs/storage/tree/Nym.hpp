@@ -137,6 +137,7 @@ private:
     void save(class Threads* input, const std::unique_lock<std::mutex>& lock);
     void save(class Contexts* input, const std::unique_lock<std::mutex>& lock);
 
+    void flush_children(const std::unique_lock<std::mutex>& lock) override;
     void init(const std::string& hash) override;
     bool save(const std::unique_lock<std::mutex>& lock) override;
     void update_hash(const StorageBox type, const std::string& root);
@@ -69,6 +69,7 @@ private:
         const std::unique_lock<std::mutex>& lock,
         const std::string& id);
 
+    void flush_children(const std::unique_lock<std::mutex>& lock) override;
     void init(const std::string& hash) override;
     bool save(const std::unique_lock<std::mutex>& lock) override;
     proto::StorageNymList serialize() const;
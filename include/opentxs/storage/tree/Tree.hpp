@@ -96,6 +96,7 @@ private:
     void save(Servers* servers, const std::unique_lock<std::mutex>& lock);
     void save(Units* units, const std::unique_lock<std::mutex>& lock);
 
+    void flush_children(const std::unique_lock<std::mutex>& lock) override;
     void init(const std::string& hash) override;
     bool save(const std::unique_lock<std::mutex>& lock) override;
     proto::StorageItems serialize() const;
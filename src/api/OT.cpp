@@ -62,6 +62,8 @@
 #include "opentxs/storage/drivers/StorageFS.hpp"
 #elif OT_STORAGE_SQLITE
 #include "opentxs/storage/drivers/StorageSqlite3.hpp"
+#elif OT_STORAGE_JOURNAL
+#include "opentxs/storage/drivers/StorageJournal.hpp"
 #endif
 
 #include <atomic>
@@ -200,6 +202,12 @@ void OT::Init_Storage()
         config.gc_interval_,
         config.gc_interval_,
         notUsed);
+    Config().CheckSet_long(
+        "storage",
+        "commit_interval",
+        config.commit_interval_,
+        config.commit_interval_,
+        notUsed);
     Config().CheckSet_str(
         "storage", "path", String(config.path_), config.path_, notUsed);
 #if OT_STORAGE_FS
@@ -254,6 +262,32 @@ void OT::Init_Storage()
         config.sqlite3_db_file_,
         notUsed);
 #endif
+#if OT_STORAGE_JOURNAL
+    Config().CheckSet_str(
+        "storage",
+        "journal_primary",
+        String(config.journal_primary_bucket_),
+        config.journal_primary_bucket_,
+        notUsed);
+    Config().CheckSet_str(
+        "storage",
+        "journal_secondary",
+        String(config.journal_secondary_bucket_),
+        config.journal_secondary_bucket_,
+        notUsed);
+    Config().CheckSet_str(
+        "storage",
+        "journal_root_file",
+        String(config.journal_root_file_),
+        config.journal_root_file_,
+        notUsed);
+    Config().CheckSet_long(
+        "storage",
+        "journal_segment_size",
+        config.journal_segment_size_,
+        config.journal_segment_size_,
+        notUsed);
+#endif
 
     if (dht_) {
         config.dht_callback_ = std::bind(
@@ -267,6 +301,8 @@ void OT::Init_Storage()
     storage_.reset(new StorageFS(config, hash, random));
 #elif OT_STORAGE_SQLITE
     storage_.reset(new StorageSqlite3(config, hash, random));
+#elif OT_STORAGE_JOURNAL
+    storage_.reset(new StorageJournal(config, hash, random));
 #endif
 }
 
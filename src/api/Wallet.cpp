@@ -44,10 +44,13 @@
 #include "opentxs/consensus/Context.hpp"
 #include "opentxs/consensus/ServerContext.hpp"
 #include "opentxs/core/contract/peer/PeerObject.hpp"
+#include "opentxs/core/crypto/CryptoEngine.hpp"
+#include "opentxs/core/crypto/CryptoHashEngine.hpp"
 #include "opentxs/core/Identifier.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/Message.hpp"
 #include "opentxs/core/Nym.hpp"
+#include "opentxs/core/OTData.hpp"
 #include "opentxs/core/Proto.hpp"
 #include "opentxs/core/String.hpp"
 #include "opentxs/storage/Storage.hpp"
@@ -199,6 +202,10 @@ void Wallet::save(class Context* context) const
 
     std::unique_lock<std::mutex> lock(context->lock_);
 
+    // An unchanged context is already stored with a current signature, so
+    // there is nothing to re-serialize, re-sign or write.
+    if (!context->dirty_.exchange(false)) { return; }
+
     context->update_signature(lock);
 
     OT_ASSERT(context->validate(lock));
@@ -289,6 +296,7 @@ ConstNym Wallet::Nym(
     std::unique_lock<std::mutex> mapLock(nym_map_lock_);
     bool inMap = (nym_map_.find(nym) != nym_map_.end());
     bool valid = false;
+    std::shared_ptr<class Nym> output;
 
     if (!inMap) {
         std::shared_ptr<proto::CredentialIndex> serialized;
@@ -302,8 +310,9 @@ ConstNym Wallet::Nym(
 
             if (pNym) {
                 if (pNym->LoadCredentialIndex(*serialized)) {
-                    valid = pNym->VerifyPseudonym();
                     pNym->alias_ = alias;
+                    output = pNym;
+                    valid = verify_nym(nym, *output, mapLock);
                 }
             }
         } else {
@@ -330,14 +339,15 @@ ConstNym Wallet::Nym(
             }
         }
     } else {
-        auto& pNym = nym_map_[nym].second;
-        if (pNym) {
-            valid = pNym->VerifyPseudonym();
+        output = nym_map_[nym].second;
+
+        if (output) {
+            valid = verify_nym(nym, *output, mapLock);
         }
     }
 
     if (valid) {
-        return nym_map_[nym].second;
+        return output;
     }
 
     return nullptr;
@@ -363,9 +373,13 @@ ConstNym Wallet::Nym(const proto::CredentialIndex& publicNym)
     if (candidate) {
         candidate->LoadCredentialIndex(publicNym);
 
-        if (candidate->VerifyPseudonym()) {
+        std::unique_lock<std::mutex> mapLock(nym_map_lock_);
+        const bool valid = verify_nym(id, *candidate, mapLock);
+        mapLock.unlock();
+
+        if (valid) {
             candidate->WriteCredentials();
-            std::unique_lock<std::mutex> mapLock(nym_map_lock_);
+            mapLock.lock();
             nym_map_.erase(id);
             mapLock.unlock();
         }
@@ -1021,6 +1035,54 @@ ConstServerContract Wallet::Server(
     return Server(Identifier(server));
 }
 
+bool Wallet::verify_nym(
+    const std::string& id,
+    const class Nym& nym,
+    std::unique_lock<std::mutex>& mapLock)
+{
+    // Caller must be holding nym_map_lock_ and keeping nym alive. The lock is
+    // released while the credentials are hashed and verified, and held again
+    // when this function returns.
+    OT_ASSERT(mapLock.owns_lock());
+
+    mapLock.unlock();
+    const auto serialized = proto::ProtoAsString(nym.asPublicNym());
+    OTData digest;
+    const bool hashed = OT::App().Crypto().Hash().Digest(
+        proto::HASHTYPE_BLAKE2B256,
+        OTData(serialized.data(), static_cast<uint32_t>(serialized.size())),
+        digest);
+
+    if (!hashed) {
+        const bool verified = nym.VerifyPseudonym();
+        mapLock.lock();
+
+        return verified;
+    }
+
+    const std::string key(
+        static_cast<const char*>(digest.GetPointer()), digest.GetSize());
+    mapLock.lock();
+    auto it = verified_nyms_.find(id);
+
+    if ((verified_nyms_.end() != it) && (key == it->second)) {
+
+        return true;
+    }
+
+    mapLock.unlock();
+    const bool verified = nym.VerifyPseudonym();
+    mapLock.lock();
+
+    if (verified) {
+        verified_nyms_[id] = key;
+    } else {
+        verified_nyms_.erase(id);
+    }
+
+    return verified;
+}
+
 ObjectList Wallet::ServerList() { return OT::App().DB().ServerList(); }
 
 bool Wallet::SetNymAlias(const Identifier& id, const std::string& alias)
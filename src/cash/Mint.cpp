@@ -48,6 +48,7 @@
 #include "opentxs/core/OTStringXML.hpp"
 #include "opentxs/core/String.hpp"
 #include "opentxs/core/crypto/OTASCIIArmor.hpp"
+#include "opentxs/core/crypto/OTEnvelope.hpp"
 #include "opentxs/core/util/Assert.hpp"
 #include "opentxs/core/util/Common.hpp"
 #include "opentxs/core/util/OTFolders.hpp"
@@ -56,11 +57,15 @@
 #include <irrxml/irrXML.hpp>
 #include <stdint.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace opentxs
 {
@@ -196,6 +201,7 @@ void Mint::Release()
 
 Mint::~Mint()
 {
+    join_next();
     Release_Mint();
 }
 
@@ -751,32 +757,147 @@ int32_t Mint::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
  pAcct = OTAccount::LoadExistingAccount(ACCOUNT_ID, NOTARY_ID);
  */
 
-// Lucre step 1: generate new mint
-// Make sure the issuer here has a private key
-// theMint.GenerateNewMint(nSeries, VALID_FROM, VALID_TO,
-// INSTRUMENT_DEFINITION_ID, m_nymServer,
-// 1, 5, 10, 20, 50, 100, 500, 1000, 10000, 100000);
-void Mint::GenerateNewMint(int32_t nSeries, time64_t VALID_FROM,
-                           time64_t VALID_TO, time64_t MINT_EXPIRATION,
-                           const Identifier& theInstrumentDefinitionID,
-                           const Identifier& theNotaryID, Nym& theNotary,
-                           int64_t nDenom1, int64_t nDenom2, int64_t nDenom3,
-                           int64_t nDenom4, int64_t nDenom5, int64_t nDenom6,
-                           int64_t nDenom7, int64_t nDenom8, int64_t nDenom9,
-                           int64_t nDenom10)
+// The mint has a different key pair for each denomination.
+// Pass the actual denomination such as 5, 10, 20, 50, 100...
+bool Mint::AddDenomination(Nym& theNotary, int64_t lDenomination,
+                           int32_t nPrimeLength)
 {
-    Release();
+    // Let's make sure it doesn't already exist
+    OTASCIIArmor theArmor;
+    if (GetPublic(theArmor, lDenomination)) {
+        otErr << "Error: Denomination public already exists in "
+                 "Mint::AddDenomination\n";
+        return false;
+    }
+    if (GetPrivate(theArmor, lDenomination)) {
+        otErr << "Error: Denomination private already exists in "
+                 "Mint::AddDenomination\n";
+        return false;
+    }
 
-    m_InstrumentDefinitionID = theInstrumentDefinitionID;
-    m_NotaryID = theNotaryID;
+    mapOfKeys keys;
+    generate_keys({lDenomination}, nPrimeLength, keys);
 
-    Identifier NOTARY_NYM_ID(theNotary);
-    m_ServerNymID = NOTARY_NYM_ID;
+    mapOfArmor thePublic, thePrivate;
 
-    m_nSeries = nSeries;
-    m_VALID_FROM = VALID_FROM;
-    m_VALID_TO = VALID_TO;
-    m_EXPIRATION = MINT_EXPIRATION;
+    if (!seal_keys(theNotary, keys, thePublic, thePrivate)) { return false; }
+
+    m_mapPublic.insert(thePublic.begin(), thePublic.end());
+    m_mapPrivate.insert(thePrivate.begin(), thePrivate.end());
+    m_nDenominationCount += static_cast<int32_t>(thePublic.size());
+
+    // Grab the Server Nym ID and save it with this Mint
+    theNotary.GetIdentifier(m_ServerNymID);
+
+    return true;
+}
+
+// Each denomination is an independent (and slow) prime search, so they are
+// spread across up to one worker per hardware thread. Denominations which
+// fail to generate are left out of output.
+void Mint::generate_keys(const std::vector<int64_t>& denominations,
+                         const int32_t nPrimeLength, mapOfKeys& output) const
+{
+    const std::size_t count = denominations.size();
+    std::vector<DenominationKey> keys(count);
+    // Not vector<bool>, since each worker writes its own elements.
+    std::vector<char> generated(count, 0);
+    std::atomic<std::size_t> next(0);
+
+    auto worker = [&]() -> void {
+        for (std::size_t i = next++; i < count; i = next++) {
+            generated[i] = GenerateDenominationKey(
+                nPrimeLength, keys[i].first, keys[i].second);
+        }
+    };
+
+    const std::size_t workers =
+        std::min<std::size_t>(std::thread::hardware_concurrency(), count);
+
+    if (2 > workers) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+
+        for (std::size_t i = 1; i < workers; ++i) {
+            pool.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (generated[i]) {
+            output[denominations[i]] = keys[i];
+        } else {
+            otErr << __FUNCTION__ << ": Failed to generate key for "
+                  << "denomination: " << denominations[i] << "\n";
+        }
+    }
+}
+
+// Seals the private half of each key pair to the notary. Either every key
+// ends up in thePublic / thePrivate, or none do.
+bool Mint::seal_keys(Nym& theNotary, const mapOfKeys& keys,
+                     mapOfArmor& thePublic, mapOfArmor& thePrivate) const
+{
+    bool bSuccess = !keys.empty();
+
+    for (auto& it : keys) {
+        if (!bSuccess) { break; }
+
+        const int64_t lDenomination = it.first;
+        OTEnvelope theEnvelope;
+        std::unique_ptr<OTASCIIArmor> pPublic(new OTASCIIArmor);
+        std::unique_ptr<OTASCIIArmor> pPrivate(new OTASCIIArmor);
+
+        // Set the public bank info onto pPublic
+        pPublic->SetString(it.second.first, true); // linebreaks = true
+
+        // Seal the private bank info up into an encrypted Envelope
+        // and set it onto pPrivate
+        bSuccess = theEnvelope.Seal(theNotary, it.second.second) &&
+                   theEnvelope.GetCiphertext(*pPrivate);
+
+        if (bSuccess) {
+            thePublic[lDenomination] = pPublic.release();
+            thePrivate[lDenomination] = pPrivate.release();
+            otWarn << "Successfully added denomination: " << lDenomination
+                   << "\n";
+        } else {
+            otErr << __FUNCTION__ << ": Failed to seal private key for "
+                  << "denomination: " << lDenomination << "\n";
+        }
+    }
+
+    if (!bSuccess) {
+        release_armor(thePublic);
+        release_armor(thePrivate);
+    }
+
+    return bSuccess;
+}
+
+// static
+void Mint::release_armor(mapOfArmor& theArmor)
+{
+    for (auto& it : theArmor) {
+        delete it.second;
+    }
+
+    theArmor.clear();
+}
+
+// Creates the cash reserve account for a new series of this mint.
+Account* Mint::create_reserve(const Identifier& theInstrumentDefinitionID,
+                              const Identifier& theNotaryID,
+                              Nym& theNotary) const
+{
+    Identifier NOTARY_NYM_ID(theNotary);
 
     // Normally asset accounts are created based on an incoming message,
     // so I'm just simulating that in order to make sure it gets its
@@ -793,8 +914,29 @@ void Mint::GenerateNewMint(int32_t nSeries, time64_t VALID_FROM,
      theMessage,
                         const AccountType eAcctType=simple);
      */
-    m_pReserveAcct = Account::GenerateNewAccount(
+    return Account::GenerateNewAccount(
         NOTARY_NYM_ID, theNotaryID, theNotary, theMessage, Account::mint);
+}
+
+void Mint::init_series(int32_t nSeries, time64_t VALID_FROM, time64_t VALID_TO,
+                       time64_t MINT_EXPIRATION,
+                       const Identifier& theInstrumentDefinitionID,
+                       const Identifier& theNotaryID, Nym& theNotary,
+                       Account* pReserve)
+{
+    Release();
+
+    m_InstrumentDefinitionID = theInstrumentDefinitionID;
+    m_NotaryID = theNotaryID;
+
+    Identifier NOTARY_NYM_ID(theNotary);
+    m_ServerNymID = NOTARY_NYM_ID;
+
+    m_nSeries = nSeries;
+    m_VALID_FROM = VALID_FROM;
+    m_VALID_TO = VALID_TO;
+    m_EXPIRATION = MINT_EXPIRATION;
+    m_pReserveAcct = pReserve;
 
     if (m_pReserveAcct) {
         m_pReserveAcct->GetIdentifier(m_CashAccountID);
@@ -803,47 +945,140 @@ void Mint::GenerateNewMint(int32_t nSeries, time64_t VALID_FROM,
     else {
         otErr << "Error creating cash reserve account for new mint.\n";
     }
+}
 
-    if (nDenom1) {
-        AddDenomination(theNotary,
-                        nDenom1); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom2) {
-        AddDenomination(theNotary,
-                        nDenom2); // int32_t nPrimeLength default = 1024
-    }
-    if (nDenom3) {
-        AddDenomination(theNotary,
-                        nDenom3); // int32_t nPrimeLength default = 1024
+void Mint::join_next()
+{
+    std::unique_ptr<std::thread> thread;
+
+    {
+        std::lock_guard<std::mutex> lock(next_lock_);
+        thread.swap(next_thread_);
     }
-    if (nDenom4) {
-        AddDenomination(theNotary,
-                        nDenom4); // int32_t nPrimeLength default = 1024
+
+    if (thread && thread->joinable()) { thread->join(); }
+}
+
+// Lucre step 1: generate new mint
+// Make sure the issuer here has a private key
+// theMint.GenerateNewMint(nSeries, VALID_FROM, VALID_TO,
+// INSTRUMENT_DEFINITION_ID, m_nymServer,
+// 1, 5, 10, 20, 50, 100, 500, 1000, 10000, 100000);
+void Mint::GenerateNewMint(int32_t nSeries, time64_t VALID_FROM,
+                           time64_t VALID_TO, time64_t MINT_EXPIRATION,
+                           const Identifier& theInstrumentDefinitionID,
+                           const Identifier& theNotaryID, Nym& theNotary,
+                           int64_t nDenom1, int64_t nDenom2, int64_t nDenom3,
+                           int64_t nDenom4, int64_t nDenom5, int64_t nDenom6,
+                           int64_t nDenom7, int64_t nDenom8, int64_t nDenom9,
+                           int64_t nDenom10)
+{
+    init_series(nSeries, VALID_FROM, VALID_TO, MINT_EXPIRATION,
+                theInstrumentDefinitionID, theNotaryID, theNotary,
+                create_reserve(theInstrumentDefinitionID, theNotaryID,
+                               theNotary));
+
+    std::vector<int64_t> denominations;
+
+    for (const int64_t lDenomination :
+         {nDenom1, nDenom2, nDenom3, nDenom4, nDenom5, nDenom6, nDenom7,
+          nDenom8, nDenom9, nDenom10}) {
+        if ((0 != lDenomination) &&
+            (denominations.end() == std::find(denominations.begin(),
+                                              denominations.end(),
+                                              lDenomination))) {
+            denominations.push_back(lDenomination);
+        }
     }
-    if (nDenom5) {
-        AddDenomination(theNotary,
-                        nDenom5); // int32_t nPrimeLength default = 1024
+
+    // Generate every key pair first, then assemble the mint in one pass.
+    mapOfKeys keys;
+    generate_keys(denominations, 1024, keys);
+
+    if (!seal_keys(theNotary, keys, m_mapPublic, m_mapPrivate)) {
+        otErr << __FUNCTION__ << ": Failed to add denominations to new mint.\n";
     }
-    if (nDenom6) {
-        AddDenomination(theNotary,
-                        nDenom6); // int32_t nPrimeLength default = 1024
+
+    m_nDenominationCount = static_cast<int32_t>(m_mapPublic.size());
+}
+
+bool Mint::PregenerateNextSeries(int32_t nPrimeLength)
+{
+    std::vector<int64_t> denominations;
+
+    for (auto& it : m_mapPublic) {
+        denominations.push_back(it.first);
     }
-    if (nDenom7) {
-        AddDenomination(theNotary,
-                        nDenom7); // int32_t nPrimeLength default = 1024
+
+    if (denominations.empty()) {
+        otErr << __FUNCTION__ << ": Mint has no denominations.\n";
+        return false;
     }
-    if (nDenom8) {
-        AddDenomination(theNotary,
-                        nDenom8); // int32_t nPrimeLength default = 1024
+
+    join_next();
+    next_ready_.store(false);
+
+    std::lock_guard<std::mutex> lock(next_lock_);
+    next_keys_.clear();
+    next_thread_.reset(new std::thread([=]() -> void {
+        mapOfKeys keys;
+        generate_keys(denominations, nPrimeLength, keys);
+
+        std::lock_guard<std::mutex> done(next_lock_);
+        next_keys_.swap(keys);
+        next_ready_.store(true);
+    }));
+
+    return true;
+}
+
+bool Mint::RolloverToNextSeries(time64_t VALID_FROM, time64_t VALID_TO,
+                                time64_t MINT_EXPIRATION, Nym& theNotary)
+{
+    join_next();
+
+    mapOfKeys keys;
+
+    {
+        std::lock_guard<std::mutex> lock(next_lock_);
+        keys.swap(next_keys_);
+        next_ready_.store(false);
     }
-    if (nDenom9) {
-        AddDenomination(theNotary,
-                        nDenom9); // int32_t nPrimeLength default = 1024
+
+    if (keys.size() != m_mapPublic.size()) {
+        otErr << __FUNCTION__ << ": Next series was not (fully) generated.\n";
+        return false;
     }
-    if (nDenom10) {
-        AddDenomination(theNotary,
-                        nDenom10); // int32_t nPrimeLength default = 1024
+
+    // Everything which can fail happens before the current series is
+    // released, so on failure this mint is still usable.
+    mapOfArmor thePublic, thePrivate;
+
+    if (!seal_keys(theNotary, keys, thePublic, thePrivate)) { return false; }
+
+    const Identifier theInstrumentDefinitionID(m_InstrumentDefinitionID);
+    const Identifier theNotaryID(m_NotaryID);
+    Account* pReserve =
+        create_reserve(theInstrumentDefinitionID, theNotaryID, theNotary);
+
+    if (nullptr == pReserve) {
+        otErr << __FUNCTION__
+              << ": Error creating cash reserve account for next series.\n";
+        release_armor(thePublic);
+        release_armor(thePrivate);
+
+        return false;
     }
+
+    // Nothing below can fail.
+    init_series(m_nSeries + 1, VALID_FROM, VALID_TO, MINT_EXPIRATION,
+                theInstrumentDefinitionID, theNotaryID, theNotary, pReserve);
+
+    m_mapPublic.swap(thePublic);
+    m_mapPrivate.swap(thePrivate);
+    m_nDenominationCount = static_cast<int32_t>(m_mapPublic.size());
+
+    return true;
 }
 
 } // namespace opentxs
@@ -56,7 +56,14 @@
 #include <openssl/ossl_typ.h>
 #include <stdio.h>
 #include <sys/types.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
 #include <ostream>
+#include <thread>
+#include <vector>
 
 #ifdef __APPLE__
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -86,28 +93,17 @@ MintLucre::MintLucre(const String& strNotaryID, const String& strServerNymID,
 
 MintLucre::~MintLucre()
 {
+    // Pregeneration calls GenerateDenominationKey, which is gone once this
+    // destructor returns.
+    join_next();
 }
 
-// The mint has a different key pair for each denomination.
-// Pass the actual denomination such as 5, 10, 20, 50, 100...
-bool MintLucre::AddDenomination(Nym& theNotary, int64_t lDenomination,
-                                int32_t nPrimeLength)
+// Generates the Lucre private and public bank information for one
+// denomination. Called concurrently by Mint::GenerateNewMint.
+bool MintLucre::GenerateDenominationKey(int32_t nPrimeLength,
+                                        String& strPublic,
+                                        String& strPrivate) const
 {
-    bool bReturnValue = false;
-
-    // Let's make sure it doesn't already exist
-    OTASCIIArmor theArmor;
-    if (GetPublic(theArmor, lDenomination)) {
-        otErr << "Error: Denomination public already exists in "
-                 "OTMint::AddDenomination\n";
-        return false;
-    }
-    if (GetPrivate(theArmor, lDenomination)) {
-        otErr << "Error: Denomination private already exists in "
-                 "OTMint::AddDenomination\n";
-        return false;
-    }
-
     if ((nPrimeLength / 8) < (MIN_COIN_LENGTH + DIGEST_LENGTH)) {
         otErr << "Prime must be at least "
               << (MIN_COIN_LENGTH + DIGEST_LENGTH) * 8 << " bits\n";
@@ -119,13 +115,18 @@ bool MintLucre::AddDenomination(Nym& theNotary, int64_t lDenomination,
         return false;
     }
 
+    // The Lucre dumper is global, so set it once rather than from every
+    // worker thread.
+    static std::once_flag dumper;
+    std::call_once(dumper, []() -> void {
 #ifdef _WIN32
-    BIO* out = BIO_new_file("openssl.dump", "w");
-    assert(out);
-    SetDumper(out);
+        BIO* out = BIO_new_file("openssl.dump", "w");
+        assert(out);
+        SetDumper(out);
 #else
-    SetMonitor(stderr);
+        SetMonitor(stderr);
 #endif
+    });
 
     OpenSSL_BIO bio = BIO_new(BIO_s_mem());
     OpenSSL_BIO bioPublic = BIO_new(BIO_s_mem());
@@ -148,148 +149,238 @@ bool MintLucre::AddDenomination(Nym& theNotary, int64_t lDenomination,
         BIO_read(bioPublic, publicBankBuffer,
                  4000); // Just makes me feel more comfortable for some reason.
 
-    if (privatebankLen && publicbankLen) {
+    if ((0 < privatebankLen) && (0 < publicbankLen)) {
         // With this, we have the Lucre public and private bank info converted
         // to OTStrings
-        String strPublicBank;
-        strPublicBank.Set(publicBankBuffer, publicbankLen);
-        String strPrivateBank;
-        strPrivateBank.Set(privateBankBuffer, privatebankLen);
-
-        OTASCIIArmor* pPublic = new OTASCIIArmor;
-        OTASCIIArmor* pPrivate = new OTASCIIArmor;
-
-        OT_ASSERT(nullptr != pPublic);
-        OT_ASSERT(nullptr != pPrivate);
-
-        // Set the public bank info onto pPublic
-        pPublic->SetString(strPublicBank, true); // linebreaks = true
-
-        // Seal the private bank info up into an encrypted Envelope
-        // and set it onto pPrivate
-        OTEnvelope theEnvelope;
-        theEnvelope.Seal(theNotary, strPrivateBank); // Todo check the return
-                                                     // values on these two
-                                                     // functions
-        theEnvelope.GetCiphertext(*pPrivate);
-
-        // Add the new key pair to the maps, using denomination as the key
-        m_mapPublic[lDenomination] = pPublic;
-        m_mapPrivate[lDenomination] = pPrivate;
-
-        // Grab the Server Nym ID and save it with this Mint
-        theNotary.GetIdentifier(m_ServerNymID);
-        m_nDenominationCount++;
-        bReturnValue = true;
-        otWarn << "Successfully added denomination: " << lDenomination << "\n";
+        strPublic.Set(publicBankBuffer, publicbankLen);
+        strPrivate.Set(privateBankBuffer, privatebankLen);
+
+        return true;
     }
 
-    return bReturnValue;
+    return false;
 }
 
 #if OT_CRYPTO_USING_OPENSSL
 
-// Lucre step 3: the mint signs the token
-//
-bool MintLucre::SignToken(Nym& theNotary, Token& theToken, String& theOutput,
-                          int32_t nTokenIndex)
+// Decrypts the private bank information for lDenomination.
+bool MintLucre::open_bank(Nym& theNotary, int64_t lDenomination,
+                          String& strBank)
 {
-    bool bReturnValue = false;
+    OTASCIIArmor thePrivate;
+    GetPrivate(thePrivate, lDenomination);
 
-    LucreDumper setDumper;
+    // The Mint private info is encrypted in m_mapPrivates[lDenomination].
+    // So I need to extract that first before I can use it.
+    OTEnvelope theEnvelope(thePrivate);
+
+    // Decrypt the Envelope into strBank
+    return theEnvelope.Open(theNotary, strBank);
+}
+
+// Blind-signs a single prototoken with the (already opened) private bank
+// information. Touches nothing but its arguments, so SignTokens runs it from
+// several threads at once.
+bool MintLucre::sign_prototoken(const String& strBank,
+                                const String& strPrototoken,
+                                String& theOutput) const
+{
+    bool bReturnValue = false;
 
     OpenSSL_BIO bioBank = BIO_new(BIO_s_mem());      // input
     OpenSSL_BIO bioRequest = BIO_new(BIO_s_mem());   // input
     OpenSSL_BIO bioSignature = BIO_new(BIO_s_mem()); // output
 
-    OTASCIIArmor thePrivate;
-    GetPrivate(thePrivate, theToken.GetDenomination());
+    // copy strBank to a BIO
+    BIO_puts(bioBank, strBank.Get());
 
-    // The Mint private info is encrypted in
-    // m_mapPrivates[theToken.GetDenomination()].
-    // So I need to extract that first before I can use it.
-    OTEnvelope theEnvelope(thePrivate);
+    // Instantiate the Bank with its private key
+    Bank bank(bioBank);
 
-    String strContents; // output from opening the envelope.
-    // Decrypt the Envelope into strContents
-    if (!theEnvelope.Open(theNotary, strContents)) return false;
+    // copy strPrototoken to a BIO
+    BIO_puts(bioRequest, strPrototoken.Get());
 
-    // copy strContents to a BIO
-    BIO_puts(bioBank, strContents.Get());
+    // Load up the coin request from the bio (the prototoken)
+    PublicCoinRequest req(bioRequest);
 
-    // Instantiate the Bank with its private key
-    Bank bank(bioBank);
+    // Sign it with the bank we previously instantiated.
+    // results will be in bnSignature (BIGNUM)
+    BIGNUM* bnSignature = bank.SignRequest(req);
+
+    if (nullptr == bnSignature) {
+        otErr << "MAJOR ERROR!: Bank.SignRequest failed in "
+                 "MintLucre::sign_prototoken\n";
+    }
+    else {
+
+        // Write the request contents, followed by the signature contents,
+        // to the Signature bio. Then free the BIGNUM.
+        req.WriteBIO(bioSignature); // the original request contents
+        DumpNumber(bioSignature, "signature=",
+                   bnSignature); // the new signature contents
+        BN_free(bnSignature);
+
+        // Read the signature bio into a C-style buffer...
+        char sig_buf[1024]; // todo stop hardcoding these string lengths
+
+        int32_t sig_len = BIO_read(bioSignature, sig_buf,
+                                   1000); // cutting it a little short on
+                                          // purpose, with the buffer. Just
+                                          // makes me feel more comfortable
+                                          // for some reason.
+
+        if (0 < sig_len) {
+            // Here we pass the signature back to the caller.
+            // He will probably set it onto the token.
+            theOutput.Set(sig_buf, sig_len);
+            bReturnValue = true;
+        }
+    }
+
+    return bReturnValue;
+}
+
+// Lucre step 3: the mint signs the token
+//
+bool MintLucre::SignToken(Nym& theNotary, Token& theToken, String& theOutput,
+                          int32_t nTokenIndex)
+{
+    LucreDumper setDumper;
+
+    String strContents; // output from opening the envelope.
+
+    if (!open_bank(theNotary, theToken.GetDenomination(), strContents)) {
+        return false;
+    }
 
     // I need the request. the prototoken.
     OTASCIIArmor ascPrototoken;
-    bool bFoundToken = theToken.GetPrototoken(ascPrototoken, nTokenIndex);
 
-    if (bFoundToken) {
-        // base64-Decode the prototoken
-        String strPrototoken(ascPrototoken);
+    if (!theToken.GetPrototoken(ascPrototoken, nTokenIndex)) { return false; }
+
+    // base64-Decode the prototoken
+    const String strPrototoken(ascPrototoken);
+
+    if (!sign_prototoken(strContents, strPrototoken, theOutput)) {
+        return false;
+    }
 
-        // copy strPrototoken to a BIO
-        BIO_puts(bioRequest, strPrototoken.Get());
+    // Copy the original coin request into the spendable field of
+    // the token object.
+    // (It won't actually be spendable until the client processes
+    // it, though.)
+    theToken.SetSpendable(ascPrototoken);
 
-        // Load up the coin request from the bio (the prototoken)
-        PublicCoinRequest req(bioRequest);
+    // This is also where we set the expiration date on the token.
+    // The client should have already done this, but we are
+    // explicitly
+    // setting the values here to prevent any funny business.
+    theToken.SetSeriesAndExpiration(m_nSeries, m_VALID_FROM, m_VALID_TO);
 
-        // Sign it with the bank we previously instantiated.
-        // results will be in bnSignature (BIGNUM)
-        BIGNUM* bnSignature = bank.SignRequest(req);
+    return true;
+}
 
-        if (nullptr == bnSignature) {
-            otErr << "MAJOR ERROR!: Bank.SignRequest failed in "
-                     "MintLucre::SignToken\n";
+bool MintLucre::SignTokens(Nym& theNotary, const std::vector<Token*>& tokens,
+                           const std::size_t threads)
+{
+    // The Lucre dumper is global, so it is set here and not by the workers.
+    LucreDumper setDumper;
+
+    const std::size_t count = tokens.size();
+    const auto start = std::chrono::steady_clock::now();
+
+    // Lucre only uses a single proto-token, so the token index is always 0.
+    // The prototokens are decoded here, since the workers only do the
+    // Lucre math.
+    std::vector<OTASCIIArmor> prototokens(count);
+    std::vector<String> requests(count);
+    std::map<int64_t, String> banks;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Token& theToken = *tokens[i];
+        const int64_t lDenomination = theToken.GetDenomination();
+
+        if (!theToken.GetPrototoken(prototokens[i], 0)) {
+            otErr << __FUNCTION__ << ": Token " << i
+                  << " has no prototoken.\n";
+
+            return false;
         }
-        else {
-
-            // Write the request contents, followed by the signature contents,
-            // to the Signature bio. Then free the BIGNUM.
-            req.WriteBIO(bioSignature); // the original request contents
-            DumpNumber(bioSignature, "signature=",
-                       bnSignature); // the new signature contents
-            BN_free(bnSignature);
-
-            // Read the signature bio into a C-style buffer...
-            char sig_buf[1024]; // todo stop hardcoding these string lengths
-
-            int32_t sig_len = BIO_read(bioSignature, sig_buf,
-                                       1000); // cutting it a little short on
-                                              // purpose, with the buffer. Just
-                                              // makes me feel more comfortable
-                                              // for some reason.
-
-            // Add the null terminator by hand (just in case.)
-            sig_buf[sig_len] = '\0';
-
-            if (sig_len) {
-                // Copy the original coin request into the spendable field of
-                // the token object.
-                // (It won't actually be spendable until the client processes
-                // it, though.)
-                theToken.SetSpendable(ascPrototoken);
-
-                // Base64-encode the signature contents into
-                // theToken.m_Signature.
-                String strSignature(sig_buf);
-
-                // Here we pass the signature back to the caller.
-                // He will probably set it onto the token.
-                theOutput.Set(sig_buf, sig_len);
-                bReturnValue = true;
-
-                // This is also where we set the expiration date on the token.
-                // The client should have already done this, but we are
-                // explicitly
-                // setting the values here to prevent any funny business.
-                theToken.SetSeriesAndExpiration(m_nSeries, m_VALID_FROM,
-                                                m_VALID_TO);
-            }
+
+        requests[i].Set(String(prototokens[i]));
+
+        if (banks.end() != banks.find(lDenomination)) { continue; }
+
+        if (!open_bank(theNotary, lDenomination, banks[lDenomination])) {
+            otErr << __FUNCTION__ << ": Unable to open private key for "
+                  << "denomination: " << lDenomination << "\n";
+
+            return false;
         }
     }
 
-    return bReturnValue;
+    std::vector<String> signatures(count);
+    // Not vector<bool>, since each worker writes its own elements.
+    std::vector<char> succeeded(count, 0);
+    std::atomic<std::size_t> next(0);
+
+    auto worker = [&]() -> void {
+        for (std::size_t i = next++; i < count; i = next++) {
+            const String& strBank = banks.at(tokens[i]->GetDenomination());
+            succeeded[i] =
+                sign_prototoken(strBank, requests[i], signatures[i]);
+        }
+    };
+
+    std::size_t workers =
+        (0 == threads) ? std::thread::hardware_concurrency() : threads;
+    workers = std::min(workers, count);
+
+    if (2 > workers) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+
+        for (std::size_t i = 1; i < workers; ++i) {
+            pool.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!succeeded[i]) {
+            otErr << __FUNCTION__ << ": Failed to sign token " << i << "\n";
+
+            return false;
+        }
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Token& theToken = *tokens[i];
+
+        theToken.SetSpendable(prototokens[i]);
+        theToken.SetSeriesAndExpiration(m_nSeries, m_VALID_FROM, m_VALID_TO);
+
+        // This releases the normal signatures, not the Lucre signed token.
+        theToken.ReleaseSignatures();
+        theToken.SetSignature(OTASCIIArmor(signatures[i]), 0);
+    }
+
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    otInfo << __FUNCTION__ << ": Signed " << count << " tokens on "
+           << std::max<std::size_t>(workers, 1) << " threads in "
+           << elapsed.count() << " seconds ("
+           << ((0 < elapsed.count()) ? (count / elapsed.count()) : 0)
+           << " tokens/second.)\n";
+
+    return true;
 }
 
 // Lucre step 5: mint verifies token when it is redeemed by merchant.
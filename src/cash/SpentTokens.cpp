@@ -0,0 +1,403 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include "opentxs/cash/SpentTokens.hpp"
+
+#include "opentxs/core/Identifier.hpp"
+#include "opentxs/core/Log.hpp"
+#include "opentxs/core/OTStorage.hpp"
+#include "opentxs/core/String.hpp"
+#include "opentxs/core/util/Assert.hpp"
+#include "opentxs/core/util/OTFolders.hpp"
+#include "opentxs/core/util/OTPaths.hpp"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+extern "C" {
+#include <unistd.h>
+}
+#endif
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#define OT_SPENT_TOKENS_SUFFIX ".log"
+
+namespace opentxs
+{
+
+SpentTokens::SpentTokens()
+    : folder_()
+{
+}
+
+SpentTokens::SpentTokens(const std::string& folder)
+    : folder_(folder)
+{
+}
+
+SpentTokens& SpentTokens::It()
+{
+    static SpentTokens instance;
+
+    return instance;
+}
+
+std::string SpentTokens::Hash(const String& theCleartextToken)
+{
+    Identifier theTokenHash;
+    theTokenHash.CalculateDigest(theCleartextToken);
+
+    return String(theTokenHash).Get();
+}
+
+bool SpentTokens::append(
+    const Store& store,
+    const std::string& line,
+    std::int64_t& position) const
+{
+    std::FILE* file = std::fopen(store.path_.c_str(), "ab");
+
+    if (nullptr == file) {
+        otErr << __FUNCTION__ << ": Failed to open " << store.path_ << "\n";
+        return false;
+    }
+
+    // Where the line starts, so that it can be truncated away again
+    if ((0 != std::fseek(file, 0, SEEK_END)) ||
+        (0 > (position = std::ftell(file)))) {
+        otErr << __FUNCTION__ << ": Failed to seek " << store.path_ << "\n";
+        std::fclose(file);
+        return false;
+    }
+
+    bool output = (line.size() == std::fwrite(
+                                      line.data(), 1, line.size(), file));
+    output &= (0 == std::fflush(file));
+#ifdef _WIN32
+    output &= (0 == ::_commit(::_fileno(file)));
+#else
+    output &= (0 == ::fsync(::fileno(file)));
+#endif
+    output &= (0 == std::fclose(file));
+
+    if (!output) {
+        otErr << __FUNCTION__ << ": Failed to write " << store.path_ << "\n";
+    }
+
+    return output;
+}
+
+bool SpentTokens::Exists(
+    const String& strInstrumentDefinitionID,
+    const std::int32_t series,
+    const std::string& hash)
+{
+    Lock lock(lock_);
+    auto store = get_store(lock, strInstrumentDefinitionID, series);
+
+    // A store which can not be loaded must not be mistaken for an empty one.
+    if (nullptr == store) {
+        return true;
+    }
+
+    return exists(*store, hash);
+}
+
+bool SpentTokens::exists(const Store& store, const std::string& hash) const
+{
+    if (0 < store.hashes_.count(hash)) {
+        return true;
+    }
+
+    if (store.legacy_) {
+        String strPath(store.legacy_folder_.c_str());
+        strPath.Concatenate("%s%s", Log::PathSeparator(), hash.c_str());
+        std::int64_t length = 0;
+
+        return OTPaths::FileExists(strPath, length);
+    }
+
+    return false;
+}
+
+bool SpentTokens::ExpireSeries(
+    const String& strInstrumentDefinitionID,
+    const std::int32_t series)
+{
+    Lock lock(lock_);
+    const auto name = store_name(strInstrumentDefinitionID, series);
+    stores_.erase(name);
+    std::string path;
+
+    if (!form_path(name + OT_SPENT_TOKENS_SUFFIX, path)) {
+        return false;
+    }
+
+    if ((0 != std::remove(path.c_str())) && (errno != ENOENT)) {
+        otErr << __FUNCTION__ << ": Failed to remove " << path << "\n";
+        return false;
+    }
+
+    otWarn << __FUNCTION__ << ": Dropped spent token database " << name
+           << "\n";
+
+    return true;
+}
+
+bool SpentTokens::form_path(const std::string& name, std::string& output) const
+{
+    if (!folder_.empty()) {
+        output = folder_ + Log::PathSeparator() + name;
+
+        return true;
+    }
+
+    return (0 <= OTDB::FormPathString(output, OTFolders::Spent().Get(), name));
+}
+
+SpentTokens::Store* SpentTokens::get_store(
+    const Lock& lock,
+    const String& strInstrumentDefinitionID,
+    const std::int32_t series)
+{
+    OT_ASSERT(lock.owns_lock());
+
+    const auto name = store_name(strInstrumentDefinitionID, series);
+    auto it = stores_.find(name);
+
+    if (stores_.end() != it) {
+        return it->second.get();
+    }
+
+    std::unique_ptr<Store> store(new Store);
+
+    if (!form_path(name + OT_SPENT_TOKENS_SUFFIX, store->path_)) {
+        otErr << __FUNCTION__ << ": Failed to create spent token folder.\n";
+        return nullptr;
+    }
+
+    if (!form_path(name, store->legacy_folder_)) {
+        return nullptr;
+    }
+
+    store->legacy_ = OTPaths::PathExists(
+        String((store->legacy_folder_ + Log::PathSeparator()).c_str()));
+
+    if (!load(*store)) {
+        return nullptr;
+    }
+
+    auto& output = stores_[name];
+    output.swap(store);
+
+    return output.get();
+}
+
+bool SpentTokens::Insert(
+    const String& strInstrumentDefinitionID,
+    const Batch& batch)
+{
+    Lock lock(lock_);
+    std::vector<std::pair<Store*, const std::set<std::string>*>> stores;
+    std::size_t count = 0;
+
+    for (const auto& series : batch) {
+        auto store =
+            get_store(lock, strInstrumentDefinitionID, series.first);
+
+        if (nullptr == store) {
+            return false;
+        }
+
+        for (const auto& hash : series.second) {
+            if (exists(*store, hash)) {
+                otOut << __FUNCTION__ << ": Token was already spent: "
+                      << hash << "\n";
+                return false;
+            }
+        }
+
+        if (!series.second.empty()) {
+            stores.push_back({store, &series.second});
+            count += series.second.size();
+        }
+    }
+
+    if (0 == count) {
+        return false;
+    }
+
+    // Every series is written before any hash is published. If one of the
+    // appends fails, the lines already written (and any partial line) are
+    // truncated away so the batch is recorded in no series at all.
+    std::vector<std::pair<const Store*, std::int64_t>> written;
+
+    for (const auto& it : stores) {
+        const auto& store = *it.first;
+        const auto& hashes = *it.second;
+        std::string line;
+
+        for (const auto& hash : hashes) {
+            if (!line.empty()) {
+                line += ' ';
+            }
+
+            line += hash;
+        }
+
+        line += '\n';
+        std::int64_t position = -1;
+        const bool appended = append(store, line, position);
+
+        if (0 <= position) {
+            written.push_back({&store, position});
+        }
+
+        if (!appended) {
+            for (const auto& undo : written) {
+                if (!truncate(*undo.first, undo.second)) {
+                    // The tokens stay recorded as spent, which is the only
+                    // safe way for this to fail.
+                    otErr << __FUNCTION__ << ": Failed to roll back "
+                          << undo.first->path_ << "\n";
+                }
+            }
+
+            return false;
+        }
+    }
+
+    for (const auto& it : stores) {
+        it.first->hashes_.insert(it.second->begin(), it.second->end());
+    }
+
+    return true;
+}
+
+bool SpentTokens::load(Store& store) const
+{
+    std::ifstream file(store.path_, std::ios::in | std::ios::binary);
+
+    if (!file.good()) {
+        // No tokens from this series have been spent yet.
+        return true;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    file.close();
+    const std::string contents = buffer.str();
+    const auto end = contents.rfind('\n');
+    const std::size_t valid = (std::string::npos == end) ? 0 : end + 1;
+    std::istringstream lines(contents.substr(0, valid));
+    std::string hash;
+
+    while (lines >> hash) {
+        store.hashes_.insert(hash);
+    }
+
+    if (valid != contents.size()) {
+        otErr << __FUNCTION__ << ": Discarding incomplete batch at the end of "
+              << store.path_ << "\n";
+        const std::string temp = store.path_ + ".tmp";
+
+        {
+            std::ofstream repaired(
+                temp, std::ios::out | std::ios::binary | std::ios::trunc);
+            repaired.write(contents.data(), valid);
+
+            if (!repaired.good()) {
+                otErr << __FUNCTION__ << ": Failed to write " << temp << "\n";
+                return false;
+            }
+        }
+
+        std::remove(store.path_.c_str());
+
+        if (0 != std::rename(temp.c_str(), store.path_.c_str())) {
+            otErr << __FUNCTION__ << ": Failed to replace " << store.path_
+                  << "\n";
+            return false;
+        }
+    }
+
+    otInfo << __FUNCTION__ << ": Loaded " << store.hashes_.size()
+           << " spent tokens from " << store.path_ << "\n";
+
+    return true;
+}
+
+bool SpentTokens::truncate(
+    const Store& store,
+    const std::int64_t position) const
+{
+#ifdef _WIN32
+    const int file = ::_open(store.path_.c_str(), _O_WRONLY | _O_BINARY);
+
+    if (0 > file) {
+        return false;
+    }
+
+    bool output = (0 == ::_chsize_s(file, position));
+    output &= (0 == ::_commit(file));
+    output &= (0 == ::_close(file));
+
+    return output;
+#else
+    return (0 == ::truncate(store.path_.c_str(), position));
+#endif
+}
+
+std::string SpentTokens::store_name(
+    const String& strInstrumentDefinitionID,
+    const std::int32_t series)
+{
+    String strAssetFolder;
+    strAssetFolder.Format(
+        "%s.%d", strInstrumentDefinitionID.Get(), series);
+
+    return strAssetFolder.Get();
+}
+}  // namespace opentxs
@@ -40,6 +40,7 @@
 
 #include "opentxs/cash/Mint.hpp"
 #include "opentxs/cash/Purse.hpp"
+#include "opentxs/cash/SpentTokens.hpp"
 #if defined(OT_CASH_USING_LUCRE)
 #include "opentxs/cash/TokenLucre.hpp"
 #endif
@@ -48,7 +49,6 @@
 #include "opentxs/core/Instrument.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/Nym.hpp"
-#include "opentxs/core/OTStorage.hpp"
 #include "opentxs/core/OTStringXML.hpp"
 #include "opentxs/core/String.hpp"
 #include "opentxs/core/crypto/OTASCIIArmor.hpp"
@@ -56,7 +56,6 @@
 #include "opentxs/core/crypto/OTNymOrSymmetricKey.hpp"
 #include "opentxs/core/util/Assert.hpp"
 #include "opentxs/core/util/Common.hpp"
-#include "opentxs/core/util/OTFolders.hpp"
 #include "opentxs/core/util/Tag.hpp"
 
 #include <irrxml/irrXML.hpp>
@@ -468,26 +467,14 @@ Token* Token::TokenFactory(String strInput)
 //
 bool Token::IsTokenAlreadySpent(String& theCleartextToken)
 {
-    String strInstrumentDefinitionID(GetInstrumentDefinitionID());
+    const String strInstrumentDefinitionID(GetInstrumentDefinitionID());
+    const auto hash = SpentTokens::Hash(theCleartextToken);
 
-    // Calculate the filename (a hash of the Lucre cleartext token ID)
-    Identifier theTokenHash;
-    theTokenHash.CalculateDigest(theCleartextToken);
-
-    // Grab the new hash into a string (for use as a filename)
-    String strTokenHash(theTokenHash);
-
-    String strAssetFolder;
-    strAssetFolder.Format("%s.%d", strInstrumentDefinitionID.Get(),
-                          GetSeries());
-
-    bool bTokenIsPresent = OTDB::Exists(
-        OTFolders::Spent().Get(), strAssetFolder.Get(), strTokenHash.Get());
-
-    if (bTokenIsPresent) {
+    if (SpentTokens::It().Exists(
+            strInstrumentDefinitionID, GetSeries(), hash)) {
         otOut << "\nToken::IsTokenAlreadySpent: Token was already spent: "
-              << OTFolders::Spent() << Log::PathSeparator() << strAssetFolder
-              << Log::PathSeparator() << strTokenHash << "\n";
+              << strInstrumentDefinitionID << "." << GetSeries() << " "
+              << hash << "\n";
         return true; // all errors must return true in this function.
                      // But this is not an error. Token really WAS already
     }                // spent, and this true is for real. The others are just
@@ -500,62 +487,24 @@ bool Token::IsTokenAlreadySpent(String& theCleartextToken)
     return false;
 }
 
+// Deposits of more than one token should collect the hashes and record them
+// with a single SpentTokens::Insert instead, so that either all or none of the
+// tokens in the purse end up spent.
 bool Token::RecordTokenAsSpent(String& theCleartextToken)
 {
-    String strInstrumentDefinitionID(GetInstrumentDefinitionID());
-
-    // Calculate the filename (a hash of the Lucre cleartext token ID)
-    Identifier theTokenHash;
-    theTokenHash.CalculateDigest(theCleartextToken);
-
-    // Grab the new hash into a string (for use as a filename)
-    String strTokenHash(theTokenHash);
-
-    String strAssetFolder;
-    strAssetFolder.Format("%s.%d", strInstrumentDefinitionID.Get(),
-                          GetSeries());
+    const String strInstrumentDefinitionID(GetInstrumentDefinitionID());
+    SpentTokens::Batch batch;
+    batch[GetSeries()].insert(SpentTokens::Hash(theCleartextToken));
 
-    // See if the spent token file ALREADY EXISTS...
-    bool bTokenIsPresent = OTDB::Exists(
-        OTFolders::Spent().Get(), strAssetFolder.Get(), strTokenHash.Get());
+    if (!SpentTokens::It().Insert(strInstrumentDefinitionID, batch)) {
+        otErr << "Token::RecordTokenAsSpent: Failed to record token as "
+                 "spent: " << strInstrumentDefinitionID << "." << GetSeries()
+              << "\n";
 
-    // If so, we're trying to record a token that was already recorded...
-    if (bTokenIsPresent) {
-        otErr << "Token::RecordTokenAsSpent: Trying to record token as spent,"
-                 " but it was already recorded: " << OTFolders::Spent()
-              << Log::PathSeparator() << strAssetFolder << Log::PathSeparator()
-              << strTokenHash << "\n";
         return false;
     }
 
-    // FINISHED:
-    //
-    // We actually save the token itself into the file, which is named based
-    // on a hash of the Lucre data.
-    // The success of that operation is also now the success of this one.
-
-    String strFinal;
-    OTASCIIArmor ascTemp(m_strRawFile);
-
-    if (false ==
-        ascTemp.WriteArmoredString(strFinal, m_strContractType.Get())) {
-        otErr << "Token::RecordTokenAsSpent: Error recording token as "
-                 "spent (failed writing armored string):\n"
-              << OTFolders::Spent() << Log::PathSeparator() << strAssetFolder
-              << Log::PathSeparator() << strTokenHash << "\n";
-        return false;
-    }
-
-    const bool bSaved =
-        OTDB::StorePlainString(strFinal.Get(), OTFolders::Spent().Get(),
-                               strAssetFolder.Get(), strTokenHash.Get());
-    if (!bSaved) {
-        otErr << "Token::RecordTokenAsSpent: Error saving file: "
-              << OTFolders::Spent() << Log::PathSeparator() << strAssetFolder
-              << Log::PathSeparator() << strTokenHash << "\n";
-    }
-
-    return bSaved;
+    return true;
 }
 
 // OTSymmetricKey:
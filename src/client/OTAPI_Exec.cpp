@@ -95,6 +95,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -2148,6 +2149,63 @@ int32_t OTAPI_Exec::getBoxReceipt(
         static_cast<int64_t>(lTransactionNum));
 }
 
+// Requests several box receipts at once. TRANSACTION_NUMBERS is a
+// comma-separated list.
+//
+// Returns the number of replies received, or -1 on error. Any receipt which
+// is still missing afterwards should be requested with getBoxReceipt.
+//
+int32_t OTAPI_Exec::getBoxReceipts(
+    const std::string& NOTARY_ID,
+    const std::string& NYM_ID,
+    const std::string& ACCOUNT_ID,
+    const int32_t& nBoxType,
+    const std::string& TRANSACTION_NUMBERS) const
+{
+    std::lock_guard<std::recursive_mutex> lock(lock_);
+
+    if (NOTARY_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: NOTARY_ID passed in!\n";
+        return OT_ERROR;
+    }
+    if (NYM_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: NYM_ID passed in!\n";
+        return OT_ERROR;
+    }
+    if (ACCOUNT_ID.empty()) {
+        otErr << __FUNCTION__ << ": Null: ACCOUNT_ID passed in!\n";
+        return OT_ERROR;
+    }
+    if (!((0 == nBoxType) || (1 == nBoxType) || (2 == nBoxType))) {
+        otErr << __FUNCTION__
+              << ": nBoxType is of wrong type: value: " << nBoxType << "\n";
+        return OT_ERROR;
+    }
+
+    std::set<int64_t> numbers;
+    const NumList list(TRANSACTION_NUMBERS);
+
+    if (!list.Output(numbers)) {
+        otErr << __FUNCTION__ << ": Empty: TRANSACTION_NUMBERS passed in!\n";
+        return OT_ERROR;
+    }
+
+    for (const auto& number : numbers) {
+        if (0 >= number) {
+            otErr << __FUNCTION__
+                  << ": Bad transaction number passed in: " << number << "\n";
+            return OT_ERROR;
+        }
+    }
+
+    return ot_api_.getBoxReceipts(
+        Identifier(NOTARY_ID),
+        Identifier(NYM_ID),
+        Identifier(ACCOUNT_ID),
+        nBoxType,
+        numbers);
+}
+
 // Returns int32_t:
 // -1 means error; no message was sent.
 //  0 means NO error, but also: no message was sent.
@@ -585,6 +585,17 @@ int32_t OTAPI_Wrap::getBoxReceipt(
         NOTARY_ID, NYM_ID, ACCOUNT_ID, nBoxType, TRANSACTION_NUMBER);
 }
 
+int32_t OTAPI_Wrap::getBoxReceipts(
+    const std::string& NOTARY_ID,
+    const std::string& NYM_ID,
+    const std::string& ACCOUNT_ID,
+    const int32_t& nBoxType,
+    const std::string& TRANSACTION_NUMBERS)
+{
+    return Exec()->getBoxReceipts(
+        NOTARY_ID, NYM_ID, ACCOUNT_ID, nBoxType, TRANSACTION_NUMBERS);
+}
+
 int32_t OTAPI_Wrap::deleteAssetAccount(
     const std::string& NOTARY_ID,
     const std::string& NYM_ID,
@@ -75,6 +75,7 @@
 #include <ostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace opentxs
 {
@@ -89,6 +90,8 @@ OTWallet::~OTWallet() { Release(); }
 
 void OTWallet::Release()
 {
+    nym_index_.clear();
+    account_index_.clear();
     m_mapPrivateNyms.clear();
 
     // Go through the map of Accounts and delete them. (They were dynamically
@@ -274,14 +277,13 @@ Nym* OTWallet::GetNymByIDPartialMatch(std::string PARTIAL_ID)  // works
                                                                // name as
                                                                // well.
 {
-    for (auto& it : m_mapPrivateNyms) {
-        String strTemp;
-        it.second->GetIdentifier(strTemp);
-        std::string strIdentifier = strTemp.Get();
-
-        if (strIdentifier.compare(0, PARTIAL_ID.length(), PARTIAL_ID) == 0)
+    // The map is keyed and sorted by ID, so the first ID carrying this prefix
+    // (if any) is the first key not less than the prefix.
+    auto found = m_mapPrivateNyms.lower_bound(PARTIAL_ID);
 
-            return it.second.get();
+    if ((m_mapPrivateNyms.end() != found) &&
+        (found->first.compare(0, PARTIAL_ID.length(), PARTIAL_ID) == 0)) {
+        return found->second.get();
     }
 
     // OK, let's try it by the name, then...
@@ -308,23 +310,50 @@ int32_t OTWallet::GetAccountCount()
     return static_cast<int32_t>(m_mapAccounts.size());
 }
 
+// The index views hold the map entries in the same (ID) order as the maps
+// themselves, so an index means exactly what it meant when GetNym and
+// GetAccount walked the maps. They are emptied on every change to the maps and
+// rebuilt here, once, on the next indexed lookup.
+const std::vector<Nym*>& OTWallet::nym_index()
+{
+    if (nym_index_.size() != m_mapPrivateNyms.size()) {
+        nym_index_.clear();
+        nym_index_.reserve(m_mapPrivateNyms.size());
+
+        for (auto& it : m_mapPrivateNyms) {
+            nym_index_.push_back(it.second.get());
+        }
+    }
+
+    return nym_index_;
+}
+
+const std::vector<Account*>& OTWallet::account_index()
+{
+    if (account_index_.size() != m_mapAccounts.size()) {
+        account_index_.clear();
+        account_index_.reserve(m_mapAccounts.size());
+
+        for (auto& it : m_mapAccounts) {
+            account_index_.push_back(it.second);
+        }
+    }
+
+    return account_index_;
+}
+
 // used by high-level wrapper.
 bool OTWallet::GetNym(int32_t iIndex, Identifier& NYM_ID, String& NYM_NAME)
 {
     // if iIndex is within proper bounds (0 through count minus 1)
     if (iIndex < GetNymCount() && iIndex >= 0) {
-        int32_t iCurrentIndex = (-1);
+        Nym* pNym = nym_index().at(iIndex);
 
-        for (auto& it : m_mapPrivateNyms) {
-            iCurrentIndex++;  // On first iteration, this becomes 0 here. (For 0
-                              // index.) Increments thereafter.
-
-            if (iIndex == iCurrentIndex) {
-                it.second->GetIdentifier(NYM_ID);
-                NYM_NAME.Set(String(it.second->Alias()));
+        if (nullptr != pNym) {
+            pNym->GetIdentifier(NYM_ID);
+            NYM_NAME.Set(String(pNym->Alias()));
 
-                return true;
-            }
+            return true;
         }
     }
 
@@ -336,22 +365,13 @@ bool OTWallet::GetAccount(int32_t iIndex, Identifier& THE_ID, String& THE_NAME)
 {
     // if iIndex is within proper bounds (0 through count minus 1)
     if (iIndex < GetAccountCount() && iIndex >= 0) {
-        int32_t iCurrentIndex = (-1);
-
-        for (auto& it : m_mapAccounts) {
-            Account* pAccount = it.second;
-            OT_ASSERT(nullptr != pAccount);
+        Account* pAccount = account_index().at(iIndex);
+        OT_ASSERT(nullptr != pAccount);
 
-            iCurrentIndex++;  // On first iteration, this becomes 0 here. (For 0
-                              // index.) Increments thereafter.
+        pAccount->GetIdentifier(THE_ID);
+        pAccount->GetName(THE_NAME);
 
-            if (iIndex == iCurrentIndex)  // if not null
-            {
-                pAccount->GetIdentifier(THE_ID);
-                pAccount->GetName(THE_NAME);
-                return true;
-            }
-        }
+        return true;
     }
 
     return false;
@@ -406,6 +426,7 @@ void OTWallet::AddPrivateNym(const Nym& theNym)
 void OTWallet::AddNym(const Nym& theNym, mapOfNymsSP& map)
 {
     const std::string id = String(Identifier(theNym)).Get();
+    nym_index_.clear();
     auto& it = map[id];
     const bool haveExisting = bool(it);
     Nym* input = const_cast<Nym*>(&theNym);
@@ -426,36 +447,32 @@ void OTWallet::AddNym(const Nym& theNym, mapOfNymsSP& map)
 
 void OTWallet::AddAccount(const Account& theAcct)
 {
-    const Identifier ACCOUNT_ID(theAcct);
+    const String strAcctID(Identifier(theAcct));
+    account_index_.clear();
 
     // See if there is already an account object on this wallet with the same ID
     // (Otherwise if we don't delete it, this would be a memory leak.)
     // Should use a smart pointer.
-    Identifier anAccountID;
+    auto it = m_mapAccounts.find(strAcctID.Get());
 
-    for (auto it(m_mapAccounts.begin()); it != m_mapAccounts.end(); ++it) {
+    if (m_mapAccounts.end() != it) {
         Account* pAccount = it->second;
         OT_ASSERT(nullptr != pAccount);
 
-        pAccount->GetIdentifier(anAccountID);
-
-        if (anAccountID == ACCOUNT_ID) {
-            String strName;
-            pAccount->GetName(strName);
-
-            if (strName.Exists()) {
-                const_cast<Account&>(theAcct).SetName(strName);
-            }
+        if (pAccount == &theAcct) { return; }
 
-            m_mapAccounts.erase(it);
-            delete pAccount;
-            pAccount = nullptr;
+        String strName;
+        pAccount->GetName(strName);
 
-            break;
+        if (strName.Exists()) {
+            const_cast<Account&>(theAcct).SetName(strName);
         }
+
+        m_mapAccounts.erase(it);
+        delete pAccount;
+        pAccount = nullptr;
     }
 
-    const String strAcctID(ACCOUNT_ID);
     m_mapAccounts[strAcctID.Get()] = const_cast<Account*>(&theAcct);
 }
 
@@ -463,19 +480,13 @@ void OTWallet::AddAccount(const Account& theAcct)
 // If it is, return a pointer to it, otherwise return nullptr.
 Account* OTWallet::GetAccount(const Identifier& theAccountID)
 {
-    // loop through the accounts and find one with a specific ID.
-    //
-    for (auto& it : m_mapAccounts) {
-        Account* pAccount = it.second;
-        OT_ASSERT(nullptr != pAccount);
+    auto it = m_mapAccounts.find(String(theAccountID).Get());
 
-        Identifier anAccountID;
-        pAccount->GetIdentifier(anAccountID);
+    if (m_mapAccounts.end() == it) { return nullptr; }
 
-        if (anAccountID == theAccountID) return pAccount;
-    }
+    OT_ASSERT(nullptr != it->second);
 
-    return nullptr;
+    return it->second;
 }
 
 Account* OTWallet::GetAccountPartialMatch(std::string PARTIAL_ID)  // works
@@ -483,18 +494,15 @@ Account* OTWallet::GetAccountPartialMatch(std::string PARTIAL_ID)  // works
                                                                    // name,
                                                                    // too.
 {
-    // loop through the accounts and find one with a specific ID.
-    for (auto& it : m_mapAccounts) {
-        Account* pAccount = it.second;
-        OT_ASSERT(nullptr != pAccount);
+    // The map is keyed and sorted by ID, so the first ID carrying this prefix
+    // (if any) is the first key not less than the prefix.
+    auto found = m_mapAccounts.lower_bound(PARTIAL_ID);
 
-        Identifier anAccountID;
-        pAccount->GetIdentifier(anAccountID);
-        String strTemp(anAccountID);
-        std::string strIdentifier = strTemp.Get();
+    if ((m_mapAccounts.end() != found) &&
+        (found->first.compare(0, PARTIAL_ID.length(), PARTIAL_ID) == 0)) {
+        OT_ASSERT(nullptr != found->second);
 
-        if (strIdentifier.compare(0, PARTIAL_ID.length(), PARTIAL_ID) == 0)
-            return pAccount;
+        return found->second;
     }
 
     // Okay, let's try it by name, then...
@@ -802,6 +810,7 @@ bool OTWallet::RemoveNym(
         }
 
         map.erase(id);
+        nym_index_.clear();
 
         if (bRemoveFromCachedKey) {
             m_setNymsOnCachedKey.erase(theTargetID);
@@ -819,23 +828,18 @@ bool OTWallet::RemoveNym(
 // removing from wallet.
 bool OTWallet::RemoveAccount(const Identifier& theTargetID)
 {
-    // loop through the accounts and find one with a specific ID.
-    Identifier anAccountID;
+    auto it = m_mapAccounts.find(String(theTargetID).Get());
 
-    for (auto it(m_mapAccounts.begin()); it != m_mapAccounts.end(); ++it) {
-        Account* pAccount = it->second;
-        OT_ASSERT(nullptr != pAccount);
+    if (m_mapAccounts.end() == it) { return false; }
 
-        pAccount->GetIdentifier(anAccountID);
+    Account* pAccount = it->second;
+    OT_ASSERT(nullptr != pAccount);
 
-        if (anAccountID == theTargetID) {
-            m_mapAccounts.erase(it);
-            delete pAccount;
-            return true;
-        }
-    }
+    m_mapAccounts.erase(it);
+    account_index_.clear();
+    delete pAccount;
 
-    return false;
+    return true;
 }
 
 bool OTWallet::SaveContract(String& strContract)
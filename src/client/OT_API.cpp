@@ -117,9 +117,11 @@
 #include <stdlib.h>
 #include <cassert>
 #include <fstream>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 #ifndef WIN32
 #include <unistd.h>
 #endif
@@ -683,6 +685,16 @@ bool OT_API::LoadConfigFile()
         Log::SetLogLevel(static_cast<std::int32_t>(lValue));
     }
 
+    // ARMOR COMPRESSION (none, fast, best)
+    {
+        bool bIsNewKey = false;
+        String strValue;
+        config_.CheckSet_str(
+            "armor", "compression", "best", strValue, bIsNewKey);
+        OTASCIIArmor::SetCompression(
+            OTASCIIArmor::ParseCompression(strValue.Get()));
+    }
+
     // WALLET
 
     // WALLET FILENAME
@@ -8721,6 +8733,7 @@ int32_t OT_API::issueBasket(
     theMessage.m_ascPayload.SetData(proto::ProtoAsData(basket));
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -9231,6 +9244,7 @@ int32_t OT_API::exchangeBasket(
                     }
 
                     // (2) Sign the Message
+                    theMessage.SetBinary(binary_messages(NOTARY_ID));
                     theMessage.SignContract(*pNym);
 
                     // (3) Save the Message (with signatures and all, back to
@@ -9282,6 +9296,7 @@ int32_t OT_API::getTransactionNumbers(
     }
     Message theMessage;
 
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     int32_t nReturnValue = m_pClient->ProcessUserCommand(
         ClientCommandType::getTransactionNumbers,
         theMessage,
@@ -9535,6 +9550,7 @@ int32_t OT_API::notarizeWithdrawal(
         }
 
         // (2) Sign the Message
+        theMessage.SetBinary(binary_messages(NOTARY_ID));
         theMessage.SignContract(*pNym);
 
         // (3) Save the Message (with signatures and all, back to its internal
@@ -9806,6 +9822,7 @@ int32_t OT_API::notarizeDeposit(
         }
 
         // (2) Sign the Message
+        theMessage.SetBinary(binary_messages(NOTARY_ID));
         theMessage.SignContract(*pNym);
 
         // (3) Save the Message (with signatures and all, back to its internal
@@ -10159,6 +10176,7 @@ int32_t OT_API::payDividend(
             }
 
             // (2) Sign the Message
+            theMessage.SetBinary(binary_messages(NOTARY_ID));
             theMessage.SignContract(*pNym);
 
             // (3) Save the Message (with signatures and all, back to its
@@ -10394,6 +10412,7 @@ int32_t OT_API::withdrawVoucher(
         }
 
         // (2) Sign the Message
+        theMessage.SetBinary(binary_messages(NOTARY_ID));
         theMessage.SignContract(*pNym);
 
         // (3) Save the Message (with signatures and all, back to its internal
@@ -10827,6 +10846,7 @@ int32_t OT_API::depositCheque(
             }
 
             // (2) Sign the Message
+            theMessage.SetBinary(binary_messages(NOTARY_ID));
             theMessage.SignContract(*pNym);
 
             // (3) Save the Message (with signatures and all, back to its
@@ -11015,6 +11035,7 @@ int32_t OT_API::depositPaymentPlan(
         }
 
         // (2) Sign the Message
+        theMessage.SetBinary(binary_messages(NOTARY_ID));
         theMessage.SignContract(*pNym);
 
         // (3) Save the Message (with signatures and all, back to its internal
@@ -11086,6 +11107,7 @@ int32_t OT_API::triggerClause(
     }
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -11460,6 +11482,7 @@ int32_t OT_API::activateSmartContract(
                 << strNotaryID << std::endl;
         }
         // (2) Sign the Message
+        theMessage.SetBinary(binary_messages(NOTARY_ID));
         theMessage.SignContract(*pNym);
 
         // (3) Save the Message (with signatures and all, back to its internal
@@ -11660,6 +11683,7 @@ int32_t OT_API::cancelCronItem(
         }
 
         // (2) Sign the Message
+        theMessage.SetBinary(binary_messages(NOTARY_ID));
         theMessage.SignContract(*pNym);
 
         // (3) Save the Message (with signatures and all, back to its internal
@@ -12011,6 +12035,7 @@ int32_t OT_API::issueMarketOffer(
             }
 
             // (2) Sign the Message
+            theMessage.SetBinary(binary_messages(NOTARY_ID));
             theMessage.SignContract(*pNym);
 
             // (3) Save the Message (with signatures and all, back to its
@@ -12089,6 +12114,7 @@ int32_t OT_API::getMarketList(
     theMessage.SetAcknowledgments(context.It());
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12141,6 +12167,7 @@ int32_t OT_API::getMarketOffers(
     theMessage.m_lDepth = lDepth;
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12197,6 +12224,7 @@ int32_t OT_API::getMarketRecentTrades(
     theMessage.m_strNymID2 = strMarketID;
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12246,6 +12274,7 @@ int32_t OT_API::getNymMarketOffers(
     theMessage.m_strNotaryID = strNotaryID;
     theMessage.SetAcknowledgments(context.It());
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12441,6 +12470,7 @@ int32_t OT_API::notarizeTransfer(
             }
 
             // (2) Sign the Message
+            theMessage.SetBinary(binary_messages(NOTARY_ID));
             theMessage.SignContract(*pNym);
 
             // (3) Save the Message (with signatures and all, back to its
@@ -12494,6 +12524,7 @@ int32_t OT_API::getNymbox(const Identifier& NOTARY_ID, const Identifier& NYM_ID)
     theMessage.SetAcknowledgments(context.It());
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12527,6 +12558,7 @@ int32_t OT_API::processNymbox(
     if (!pServer) { return (-1); }
 
     Message theMessage;
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     bool bSuccess = false;
     int32_t nReceiptCount = (-1);
     int32_t nRequestNum = (-1);
@@ -12674,6 +12706,7 @@ int32_t OT_API::processInbox(
     }
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12745,6 +12778,7 @@ int32_t OT_API::registerInstrumentDefinition(
         proto::ProtoAsData<proto::UnitDefinition>(pContract->PublicContract()));
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12792,6 +12826,7 @@ int32_t OT_API::getInstrumentDefinition(
     theMessage.m_strInstrumentDefinitionID = strInstrumentDefinitionID;
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12843,6 +12878,7 @@ int32_t OT_API::getMint(
     theMessage.m_strInstrumentDefinitionID = strInstrumentDefinitionID;
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12899,6 +12935,7 @@ int32_t OT_API::queryInstrumentDefinitions(
     theMessage.m_ascPayload = ENCODED_MAP;
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -12959,6 +12996,7 @@ int32_t OT_API::registerAccount(
     theMessage.m_strInstrumentDefinitionID = strInstrumentDefinitionID;
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -13007,6 +13045,7 @@ int32_t OT_API::deleteAssetAccount(
     theMessage.m_strAcctID = strAcctID;
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -13090,6 +13129,7 @@ int32_t OT_API::getBoxReceipt(
     theMessage.m_lTransactionNum = lTransactionNum;
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -13102,6 +13142,79 @@ int32_t OT_API::getBoxReceipt(
     return static_cast<int32_t>(lRequestNumber);
 }
 
+// Requests every receipt in numbers without waiting for each reply before
+// sending the next request. The replies are processed in request order once
+// they have all arrived (or timed out).
+//
+// Returns the number of replies which were received and processed, or -1 if
+// nothing could be sent. Receipts whose reply did not arrive should be
+// requested again individually with getBoxReceipt.
+int32_t OT_API::getBoxReceipts(
+    const Identifier& NOTARY_ID,
+    const Identifier& NYM_ID,
+    const Identifier& ACCOUNT_ID,
+    int32_t nBoxType,
+    const std::set<int64_t>& numbers) const
+{
+    std::lock_guard<std::recursive_mutex> lock(lock_);
+
+    Nym* pNym = GetOrLoadPrivateNym(NYM_ID, false, __FUNCTION__);
+
+    if (nullptr == pNym) { return (-1); }
+
+    if (NYM_ID != ACCOUNT_ID) {
+        Account* pAccount =
+            GetOrLoadAccount(*pNym, ACCOUNT_ID, NOTARY_ID, __FUNCTION__);
+        if (nullptr == pAccount) return (-1);
+    }
+
+    if (numbers.empty()) { return 0; }
+
+    auto& connection = zeromq_.Server(String(NOTARY_ID).Get());
+    const bool binary = connection.Binary();
+    const String strNotaryID(NOTARY_ID), strNymID(NYM_ID), strAcctID(ACCOUNT_ID);
+    std::vector<std::future<NetworkReplyMessage>> replies;
+
+    {
+        auto context =
+            OT::App().Contract().mutable_ServerContext(NYM_ID, NOTARY_ID);
+
+        for (const auto& number : numbers) {
+            Message theMessage;
+            theMessage.m_strRequestNum.Format(
+                "%" PRId64, context.It().Request());
+            context.It().IncrementRequest();
+            theMessage.m_strCommand = "getBoxReceipt";
+            theMessage.m_strNymID = strNymID;
+            theMessage.m_strNotaryID = strNotaryID;
+            theMessage.SetAcknowledgments(context.It());
+            theMessage.m_strAcctID = strAcctID;
+            theMessage.m_lDepth = static_cast<int64_t>(nBoxType);
+            theMessage.m_lTransactionNum = number;
+            theMessage.SetBinary(binary);
+            theMessage.SignContract(*pNym);
+            theMessage.SaveContract();
+            m_pClient->QueueOutgoingMessage(theMessage);
+            replies.emplace_back(connection.SendAsync(theMessage));
+        }
+    }
+
+    int32_t received = 0;
+
+    for (auto& future : replies) {
+        auto result = future.get();
+
+        if (SendResult::HAVE_REPLY != result.first) { continue; }
+
+        if (result.second->m_bBinaryMessages) { connection.EnableBinary(); }
+
+        m_pClient->processServerReply(NOTARY_ID, pNym, result.second);
+        ++received;
+    }
+
+    return received;
+}
+
 int32_t OT_API::getAccountData(
     const Identifier& NOTARY_ID,
     const Identifier& NYM_ID,
@@ -13139,6 +13252,7 @@ int32_t OT_API::getAccountData(
     theMessage.m_strAcctID = strAcctID;
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -13167,6 +13281,7 @@ int32_t OT_API::getRequestNumber(
 
     Message theMessage;
 
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     int32_t nReturnValue = m_pClient->ProcessUserCommand(
         ClientCommandType::getRequestNumber,
         theMessage,
@@ -13219,6 +13334,7 @@ int32_t OT_API::usageCredits(
     // regardless.)
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -13268,6 +13384,7 @@ int32_t OT_API::checkNym(
     theMessage.SetAcknowledgments(context.It());
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its internal
@@ -13426,6 +13543,7 @@ int32_t OT_API::registerContract(
     }
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its
@@ -13496,6 +13614,7 @@ int32_t OT_API::sendNymObject(
     }
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its
@@ -13658,6 +13777,7 @@ int32_t OT_API::sendNymInstrument(
             theEnvelope.Seal(recipientPubkey, strInstrument) &&
             theEnvelope.GetCiphertext(theMessage.m_ascPayload)) {
             // (2) Sign the Message
+            theMessage.SetBinary(binary_messages(NOTARY_ID));
             theMessage.SignContract(*pNym);
 
             // (3) Save the Message (with signatures and all, back to its
@@ -13764,6 +13884,7 @@ int32_t OT_API::registerNym(
 
     Message theMessage;
 
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     int32_t nReturnValue = m_pClient->ProcessUserCommand(
         ClientCommandType::registerNym,
         theMessage,
@@ -13798,6 +13919,7 @@ int32_t OT_API::unregisterNym(
     // By this point, pServer is a good pointer.  (No need to cleanup.)
     Message theMessage;
 
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     int32_t nReturnValue = m_pClient->ProcessUserCommand(
         ClientCommandType::unregisterNym,
         theMessage,
@@ -13832,6 +13954,7 @@ int32_t OT_API::pingNotary(
 
     Message theMessage;
 
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     int32_t nReturnValue = m_pClient->ProcessUserCommand(
         ClientCommandType::pingNotary,
         theMessage,
@@ -13855,11 +13978,13 @@ SendResult OT_API::SendMessage(
 {
     std::lock_guard<std::recursive_mutex> lock(lock_);
 
-    m_pClient->QueueOutgoingMessage(message);
     auto& connection = zeromq_.Server(String(server).Get());
+    m_pClient->QueueOutgoingMessage(message);
     auto result = connection.Send(message);
 
     if (SendResult::HAVE_REPLY == result.first) {
+        if (result.second->m_bBinaryMessages) { connection.EnableBinary(); }
+
         m_pClient->processServerReply(
             server, nym, result.second);
     }
@@ -13867,6 +13992,14 @@ SendResult OT_API::SendMessage(
     return result.first;
 }
 
+// Whether requests to this server should be signed in the binary encoding.
+// The encoding must be chosen before the request is signed, since the
+// signature covers the encoded form.
+bool OT_API::binary_messages(const Identifier& server) const
+{
+    return zeromq_.Server(String(server).Get()).Binary();
+}
+
 int32_t OT_API::initiatePeerRequest(
     const Identifier& sender,
     const Identifier& recipient,
@@ -14021,6 +14154,7 @@ int32_t OT_API::requestAdmin(
     theMessage.SetAcknowledgments(context.It());
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(NOTARY_ID));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its
@@ -14068,6 +14202,7 @@ int32_t OT_API::serverAddClaim(
     theMessage.SetAcknowledgments(context.It());
 
     // (2) Sign the Message
+    theMessage.SetBinary(binary_messages(notary));
     theMessage.SignContract(*pNym);
 
     // (3) Save the Message (with signatures and all, back to its
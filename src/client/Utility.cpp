@@ -45,6 +45,7 @@
 #include <stdint.h>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace opentxs
 {
@@ -1969,6 +1970,7 @@ OT_UTILITY_OT bool Utility::insureHaveAllBoxReceipts(
 
     int32_t nReceiptCount =
         OTAPI_Wrap::Ledger_GetCount(notaryID, nymID, accountID, ledger);
+    std::vector<int64_t> missing;
     if (nReceiptCount > 0) {
         for (int32_t i_loop = 0; i_loop < nReceiptCount; ++i_loop) {
             int64_t lTransactionNum =
@@ -2036,36 +2038,8 @@ OT_UTILITY_OT bool Utility::insureHaveAllBoxReceipts(
                                     notaryID, nymID, accountID, nBoxType,
                                     lTransactionNum);
                             if (!bHaveBoxReceipt) {
-                                otWarn << strLocation << ": Downloading box "
-                                                         "receipt to add to my "
-                                                         "collection...\n";
-
-                                bool bDownloaded =
-                                    getBoxReceiptWithErrorCorrection(
-                                        notaryID, nymID, accountID, nBoxType,
-                                        lTransactionNum);
-                                if (!bDownloaded) {
-                                    otOut
-                                        << strLocation
-                                        << ": Failed downloading box receipt. "
-                                           "(Skipping any others.) Transaction "
-                                           "number: " << lTransactionNum
-                                        << "\n";
-
-                                    bReturnValue = false;
-                                    break;
-                                    // No point continuing to loop and fail 500
-                                    // times, when
-                                    // getBoxReceiptWithErrorCorrection()
-                                    // already failed
-                                    // even doing the getRequestNumber() trick
-                                    // and
-                                    // everything, and whatever retries are
-                                    // inside OT, before it finally
-                                    // gave up.
-                                }
-                                // else (Download success.)
-                            } // if (!bHaveBoxReceipt)
+                                missing.push_back(lTransactionNum);
+                            }
                         }
 
                         // else we already have the box receipt, no need to
@@ -2086,6 +2060,42 @@ OT_UTILITY_OT bool Utility::insureHaveAllBoxReceipts(
         } // ************* FOR LOOP ******************
     }     // if (nReceiptCount > 0)
 
+    // Request all the missing receipts at once, so their round trips overlap.
+    // Whatever that fails to deliver is downloaded again one at a time, with
+    // the usual error correction.
+    if (!missing.empty()) {
+        otWarn << strLocation << ": Downloading " << missing.size()
+               << " box receipts to add to my collection...\n";
+
+        string strNumbers;
+        for (const auto& number : missing) {
+            if (!strNumbers.empty()) { strNumbers += ","; }
+            strNumbers += std::to_string(number);
+        }
+
+        OTAPI_Wrap::getBoxReceipts(notaryID, nymID, accountID, nBoxType,
+                                   strNumbers);
+
+        for (const auto& lTransactionNum : missing) {
+            if (OTAPI_Wrap::DoesBoxReceiptExist(notaryID, nymID, accountID,
+                                                nBoxType, lTransactionNum)) {
+                continue;
+            }
+
+            bool bDownloaded = getBoxReceiptWithErrorCorrection(
+                notaryID, nymID, accountID, nBoxType, lTransactionNum);
+            if (!bDownloaded) {
+                otOut << strLocation
+                      << ": Failed downloading box receipt. (Skipping any "
+                         "others.) Transaction number: " << lTransactionNum
+                      << "\n";
+
+                bReturnValue = false;
+                break;
+            }
+        }
+    }
+
     //
     // if nRequestSeeking is >0, that means the caller wants to know if there is
     // a receipt present for that request number.
@@ -71,6 +71,8 @@ bool ClientContext::CloseCronItem(const TransactionNumber number)
 
     auto output = open_cron_items_.erase(number);
 
+    if (0 < output) { dirty_.store(true); }
+
     lock.unlock();
 
     return (0 < output);
@@ -82,6 +84,8 @@ bool ClientContext::OpenCronItem(const TransactionNumber number)
 
     auto output = open_cron_items_.insert(number);
 
+    if (output.second) { dirty_.store(true); }
+
     lock.unlock();
 
     return output.second;
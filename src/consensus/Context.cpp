@@ -73,41 +73,47 @@ Context::Context(
     request_number_.store(serialized.requestnumber());
 
     for (const auto& it : serialized.acknowledgedrequestnumber()) {
-        acknowledged_request_numbers_.insert(it);
+        acknowledged_request_numbers_.Add(it);
     }
 
     for (const auto& it : serialized.availabletransactionnumber()) {
-        available_transaction_numbers_.insert(it);
+        available_transaction_numbers_.Add(it);
     }
 
     for (const auto& it : serialized.issuedtransactionnumber()) {
-        issued_transaction_numbers_.insert(it);
+        issued_transaction_numbers_.Add(it);
     }
 
     signatures_.push_front(
         SerializedSignature(
             std::make_shared<proto::Signature>(serialized.signature())));
+    dirty_.store(false);
 }
 
 std::set<RequestNumber> Context::AcknowledgedNumbers() const
 {
     Lock lock(lock_);
 
-    return acknowledged_request_numbers_;
+    return std::set<RequestNumber>(
+        acknowledged_request_numbers_.begin(),
+        acknowledged_request_numbers_.end());
 }
 
 bool Context::AddAcknowledgedNumber(const RequestNumber req)
 {
     Lock lock(lock_);
 
-    auto output = acknowledged_request_numbers_.insert(req);
+    const bool output = acknowledged_request_numbers_.Add(req);
+    RequestNumber oldest = 0;
 
-    while (OT_MAX_ACK_NUMS < acknowledged_request_numbers_.size()) {
-        acknowledged_request_numbers_.erase(
-            acknowledged_request_numbers_.begin());
+    while ((OT_MAX_ACK_NUMS < acknowledged_request_numbers_.Count()) &&
+           acknowledged_request_numbers_.Peek(oldest)) {
+        acknowledged_request_numbers_.Remove(oldest);
     }
 
-    return output.second;
+    if (output) { dirty_.store(true); }
+
+    return output;
 }
 
 proto::Context Context::contract(const Lock& lock) const
@@ -137,8 +143,10 @@ void Context::finish_acknowledgements(
     }
 
     for (const auto& it : toErase) {
-        acknowledged_request_numbers_.erase(it);
+        acknowledged_request_numbers_.Remove(it);
     }
+
+    if (!toErase.empty()) { dirty_.store(true); }
 }
 
 Identifier Context::GetID(const Lock& lock) const
@@ -210,7 +218,10 @@ proto::Context Context::IDVersion(const Lock& lock) const
 
 RequestNumber Context::IncrementRequest()
 {
-    return ++request_number_;
+    const RequestNumber output = ++request_number_;
+    dirty_.store(true);
+
+    return output;
 }
 
 Identifier Context::LocalNymboxHash() const
@@ -250,9 +261,11 @@ bool Context::RemoveAcknowledgedNumber(const std::set<RequestNumber>& req)
     std::size_t removed = 0;
 
     for (const auto& number : req) {
-        removed += acknowledged_request_numbers_.erase(number);
+        if (acknowledged_request_numbers_.Remove(number)) { ++removed; }
     }
 
+    if (0 < removed) { dirty_.store(true); }
+
     lock.unlock();
 
     return (0 < removed);
@@ -286,14 +299,25 @@ proto::Context Context::serialize(
     output.set_remotenymboxhash(String(remote_nymbox_hash_).Get());
     output.set_requestnumber(request_number_.load());
 
+    // The number sets are held as ranges, but version 1 has no range fields,
+    // so each number is still written as its own entry.
+    output.mutable_acknowledgedrequestnumber()->Reserve(
+        acknowledged_request_numbers_.Count());
+
     for (const auto& it : acknowledged_request_numbers_) {
         output.add_acknowledgedrequestnumber(it);
     }
 
+    output.mutable_availabletransactionnumber()->Reserve(
+        available_transaction_numbers_.Count());
+
     for (const auto& it : available_transaction_numbers_) {
         output.add_availabletransactionnumber(it);
     }
 
+    output.mutable_issuedtransactionnumber()->Reserve(
+        issued_transaction_numbers_.Count());
+
     for (const auto& it : issued_transaction_numbers_) {
         output.add_issuedtransactionnumber(it);
     }
@@ -318,6 +342,7 @@ void Context::SetLocalNymboxHash(const Identifier& hash)
     Lock lock(lock_);
 
     local_nymbox_hash_ = hash;
+    dirty_.store(true);
 
     CalculateID(lock);
 }
@@ -327,6 +352,7 @@ void Context::SetRemoteNymboxHash(const Identifier& hash)
     Lock lock(lock_);
 
     remote_nymbox_hash_ = hash;
+    dirty_.store(true);
 
     CalculateID(lock);
 }
@@ -334,6 +360,7 @@ void Context::SetRemoteNymboxHash(const Identifier& hash)
 void Context::SetRequest(const RequestNumber req)
 {
     request_number_.store(req);
+    dirty_.store(true);
 }
 
 proto::Context Context::SigVersion(const Lock& lock) const
@@ -378,7 +405,7 @@ bool Context::validate(const Lock& lock) const
 
 bool Context::VerifyAcknowledgedNumber(const RequestNumber req) const
 {
-    return (0 < acknowledged_request_numbers_.count(req));
+    return acknowledged_request_numbers_.Verify(req);
 }
 
 bool Context::verify_signature(
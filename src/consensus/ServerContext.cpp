@@ -77,6 +77,8 @@ bool ServerContext::AddTentativeNumber(const TransactionNumber& number)
 
     auto output = tentative_transaction_numbers_.insert(number);
 
+    if (output.second) { dirty_.store(true); }
+
     lock.unlock();
 
     return output.second;
@@ -93,6 +95,8 @@ bool ServerContext::RemoveTentativeNumber(const TransactionNumber& number)
 
     auto output = tentative_transaction_numbers_.erase(number);
 
+    if (0 < output) { dirty_.store(true); }
+
     lock.unlock();
 
     return (0 < output);
@@ -134,7 +138,9 @@ bool ServerContext::SetHighest(const TransactionNumber& highest)
     Lock lock(lock_);
 
     if (highest >= highest_transaction_number_.load()) {
-        highest_transaction_number_.store(highest);
+        if (highest != highest_transaction_number_.exchange(highest)) {
+            dirty_.store(true);
+        }
 
         return true;
     }
@@ -180,6 +186,7 @@ TransactionNumber ServerContext::UpdateHighest(
         }
 
         highest_transaction_number_.store(highest);
+        dirty_.store(true);
     }
 
     return output;
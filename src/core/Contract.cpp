@@ -41,6 +41,7 @@
 #include "opentxs/core/Identifier.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/Nym.hpp"
+#include "opentxs/core/OTData.hpp"
 #include "opentxs/core/OTStorage.hpp"
 #include "opentxs/core/OTStringXML.hpp"
 #include "opentxs/core/Proto.hpp"
@@ -60,6 +61,8 @@
 #include <cstring>
 #include <fstream>
 #include <irrxml/irrXML.hpp>
+#include <algorithm>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -766,6 +769,89 @@ bool Contract::VerifySignature(
     return true;
 }
 
+bool Contract::VerifySignatures(
+    const std::vector<const Contract*>& contracts,
+    const Nym& theNym,
+    std::vector<bool>& output,
+    const OTPasswordData* pPWData)
+{
+    String strNymID;
+    theNym.GetIdentifier(strNymID);
+    char cNymID = '0';
+    uint32_t uIndex = 3;
+    const bool bNymID = strNymID.At(uIndex, cNymID);
+    const OTAsymmetricKey* defaultKey = &theNym.GetPublicSignKey();
+
+    // These own the buffers referenced by the entries in batch.
+    std::list<OTData> plaintexts;
+    std::list<OTData> signatures;
+    std::vector<CryptoAsymmetric::Verification> batch;
+    // Which contract each entry in batch belongs to
+    std::vector<std::size_t> owner;
+
+    for (std::size_t i = 0; i < contracts.size(); ++i) {
+        const Contract* pContract = contracts[i];
+        OT_ASSERT(nullptr != pContract);
+
+        const String strUnsigned(trim(pContract->m_xmlUnsigned));
+        plaintexts.emplace_back(
+            strUnsigned.Get(),
+            strUnsigned.GetLength() + 1);  // include null terminator
+        const OTData& plaintext = plaintexts.back();
+
+        for (auto& it : pContract->m_listSignatures) {
+            OTSignature* pSig = it;
+            OT_ASSERT(nullptr != pSig);
+
+            if (bNymID && pSig->getMetaData().HasMetadata()) {
+                if (pSig->getMetaData().FirstCharNymID() != cNymID) continue;
+            }
+
+            signatures.emplace_back();
+            OTData& signature = signatures.back();
+            pSig->GetData(signature);
+
+            // Same candidates VerifySignature(theNym, theSignature) would
+            // try: the keys matching the signature metadata, then the Nym's
+            // default signing key.
+            listOfAsymmetricKeys listOutput;
+            theNym.GetPublicKeysBySignature(listOutput, *pSig, 'S');
+            std::vector<const OTAsymmetricKey*> keys(
+                listOutput.begin(), listOutput.end());
+
+            if (keys.end() == std::find(keys.begin(), keys.end(), defaultKey)) {
+                keys.push_back(defaultKey);
+            }
+
+            for (auto& pKey : keys) {
+                OT_ASSERT(nullptr != pKey);
+
+                if ((nullptr != pKey->m_pMetadata) &&
+                    pKey->m_pMetadata->HasMetadata() &&
+                    pSig->getMetaData().HasMetadata()) {
+                    if (pSig->getMetaData() != *(pKey->m_pMetadata)) continue;
+                }
+
+                batch.emplace_back(
+                    plaintext, *pKey, signature, pContract->m_strSigHashType);
+                owner.push_back(i);
+            }
+        }
+    }
+
+    OTPasswordData thePWData("Contract::VerifySignatures");
+    std::vector<bool> results;
+    CryptoAsymmetric::VerifyBatch(
+        batch, results, 0, (nullptr != pPWData) ? pPWData : &thePWData);
+    output.assign(contracts.size(), false);
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (results[i]) { output[owner[i]] = true; }
+    }
+
+    return output.end() == std::find(output.begin(), output.end(), false);
+}
+
 void Contract::ReleaseSignatures()
 {
 
@@ -52,6 +52,8 @@
 #include "opentxs/core/OTData.hpp"
 #include "opentxs/core/String.hpp"
 
+#include <cstring>
+
 namespace opentxs
 {
 
@@ -139,40 +141,64 @@ Identifier& Identifier::operator=(Identifier rhs)
     return *this;
 }
 
+// Identifiers compare equal if their encoded strings would be equal, but
+// without paying for the encoding.
+int Identifier::compare(const Identifier& rhs) const
+{
+    const auto lSize = GetSize();
+    const auto rSize = rhs.GetSize();
+
+    // An empty identifier encodes to an empty string, regardless of type.
+    if ((0 == lSize) || (0 == rSize)) {
+        return (lSize == rSize) ? 0 : ((0 == lSize) ? -1 : 1);
+    }
+
+    if (type_ != rhs.type_) {
+        return (type_ < rhs.type_) ? -1 : 1;
+    }
+
+    const int result = std::memcmp(
+        GetPointer(), rhs.GetPointer(), (lSize < rSize) ? lSize : rSize);
+
+    if (0 != result) {
+        return result;
+    }
+
+    if (lSize == rSize) {
+        return 0;
+    }
+
+    return (lSize < rSize) ? -1 : 1;
+}
+
 bool Identifier::operator==(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.Compare(ots2);
+    return 0 == compare(s2);
 }
 
 bool Identifier::operator!=(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return !(ots1.Compare(ots2));
+    return 0 != compare(s2);
 }
 
 bool Identifier::operator>(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.operator>(ots2);
+    return 0 < compare(s2);
 }
 
 bool Identifier::operator<(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.operator<(ots2);
+    return 0 > compare(s2);
 }
 
 bool Identifier::operator<=(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.operator<=(ots2);
+    return 0 >= compare(s2);
 }
 
 bool Identifier::operator>=(const Identifier& s2) const
 {
-    const String ots1(*this), ots2(s2);
-    return ots1.operator>=(ots2);
+    return 0 <= compare(s2);
 }
 
 bool Identifier::CalculateDigest(const String& strInput, const ID type)
@@ -756,14 +756,13 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
     //
     for (auto& it : THE_NYM.GetMapIssuedNum()) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-        OT_ASSERT(nullptr != pDeque);
+        const NumRanges& theNumbers = it.second;
 
         const Identifier theNotaryID(strNotaryID);
 
-        if (!(pDeque->empty()) && (theNotaryID == GetPurportedNotaryID())) {
+        if (!(theNumbers.empty()) && (theNotaryID == GetPurportedNotaryID())) {
             nNumberOfTransactionNumbers1 +=
-                static_cast<int32_t>(pDeque->size());
+                static_cast<int32_t>(theNumbers.Count());
             break; // There's only one, in this loop, that would/could/should
                    // match. (Therefore, break after finding it.)
         }
@@ -779,18 +778,17 @@ bool Item::VerifyBalanceStatement(int64_t lActualAdjustment, Nym& THE_NYM,
         theMessageNym.LoadNymFromString(strMessageNym)) {
         for (auto& it : theMessageNym.GetMapIssuedNum()) {
             std::string strNotaryID = it.first;
-            dequeOfTransNums* pDeque = it.second;
-            OT_ASSERT(nullptr != pDeque);
+            const NumRanges& theNumbers = it.second;
 
             const Identifier theNotaryID(strNotaryID);
             const String OTstrNotaryID(theNotaryID);
 
-            if (!(pDeque->empty()) && (theNotaryID == GetPurportedNotaryID())) {
+            if (!(theNumbers.empty()) &&
+                (theNotaryID == GetPurportedNotaryID())) {
                 nNumberOfTransactionNumbers2 +=
-                    static_cast<int32_t>(pDeque->size());
+                    static_cast<int32_t>(theNumbers.Count());
 
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    int64_t lTransactionNumber = pDeque->at(i);
+                for (const auto& lTransactionNumber : theNumbers) {
                     if (false ==
                         THE_NYM.VerifyIssuedNum(OTstrNotaryID,
                                                 lTransactionNumber)) // FAILURE
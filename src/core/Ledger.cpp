@@ -1104,6 +1104,7 @@ bool Ledger::RemoveTransaction(int64_t lTransactionNum, bool bDeleteIt)
     else {
         OTTransaction* pTransaction = it->second;
         OT_ASSERT(nullptr != pTransaction);
+        unindex_transaction(*pTransaction);
         m_mapTransactions.erase(it);
 
         if (bDeleteIt) {
@@ -1124,6 +1125,7 @@ bool Ledger::AddTransaction(OTTransaction& theTransaction)
     if (it == m_mapTransactions.end()) {
         m_mapTransactions[theTransaction.GetTransactionNum()] = &theTransaction;
         theTransaction.SetParent(*this);  // for convenience
+        index_transaction(theTransaction);
         return true;
     }
     // Otherwise, if it was already there, log an error.
@@ -1136,6 +1138,138 @@ bool Ledger::AddTransaction(OTTransaction& theTransaction)
     return false;
 }
 
+// Copies the cheque attached to the original depositCheque item inside a
+// chequeReceipt or voucherReceipt. The receipt has already decoded it (see
+// OTTransaction::GetReferenceCheque), so only the cheque itself is loaded
+// again, to give the caller a copy of its own. CALLER RESPONSIBLE TO DELETE.
+static Cheque* LoadReceiptCheque(
+    OTTransaction& theReceipt,
+    const Identifier& theNotaryID)
+{
+    const Cheque* pReference = theReceipt.GetReferenceCheque(theNotaryID);
+
+    if (nullptr == pReference) {
+        otErr << __FUNCTION__
+              << ": Expected original depositCheque request item, with a "
+                 "cheque attached, to be inside the chequeReceipt "
+                 "(but failed to load it...)\n";
+        return nullptr;
+    }
+
+    String strCheque;
+    pReference->SaveContractRaw(strCheque);
+
+    std::unique_ptr<Cheque> pCheque(new Cheque);
+    OT_ASSERT(nullptr != pCheque);
+
+    if (!pCheque->LoadContractFromString(strCheque)) {
+        otErr << __FUNCTION__ << ": Error copying cheque:\n"
+              << strCheque << "\n";
+        return nullptr;
+    }
+
+    return pCheque.release();
+}
+
+OTTransaction* Ledger::find_receipt(
+    const setOfReceipts& theIndex,
+    int64_t lKey) const
+{
+    // If there is more than one, the one with the lowest transaction number
+    // wins, same as the order of m_mapTransactions.
+    auto it = theIndex.lower_bound({lKey, INT64_MIN});
+
+    if ((theIndex.end() == it) || (it->first != lKey)) {
+        return nullptr;
+    }
+
+    return GetTransaction(it->second);
+}
+
+void Ledger::index_receipt(OTTransaction& theTransaction)
+{
+    // Abbreviated receipts don't contain the item to index by. They are
+    // indexed when the full box receipt replaces them (LoadBoxReceipt.)
+    if (theTransaction.IsAbbreviated()) {
+        return;
+    }
+
+    const int64_t lTransactionNum = theTransaction.GetTransactionNum();
+
+    switch (theTransaction.GetType()) {
+        case OTTransaction::transferReceipt: {
+            const Item* pOriginalItem = theTransaction.GetReferenceItem(
+                theTransaction.GetPurportedNotaryID());
+
+            if (nullptr == pOriginalItem) {
+                otErr << "OTLedger::" << __FUNCTION__
+                      << ": Failed loading the item attached to "
+                         "transferReceipt "
+                      << lTransactionNum << "\n";
+            } else if (pOriginalItem->GetType() != Item::acceptPending) {
+                otErr << "OTLedger::" << __FUNCTION__
+                      << ": Wrong item type attached to transferReceipt!\n";
+            } else {
+                const int64_t lKey = pOriginalItem->GetRawNumberOfOrigin();
+                m_setTransferReceipts.emplace(lKey, lTransactionNum);
+                m_mapReceiptKeys[lTransactionNum] = lKey;
+            }
+        } break;
+        case OTTransaction::chequeReceipt:
+        case OTTransaction::voucherReceipt: {
+            const Cheque* pCheque =
+                theTransaction.GetReferenceCheque(GetPurportedNotaryID());
+
+            if (nullptr != pCheque) {
+                const int64_t lKey = pCheque->GetTransactionNum();
+                m_setChequeReceipts.emplace(lKey, lTransactionNum);
+                m_mapReceiptKeys[lTransactionNum] = lKey;
+            }
+        } break;
+        default: {
+        }
+    }
+}
+
+void Ledger::index_receipts()
+{
+    if (m_bReceiptIndexes) {
+        return;
+    }
+
+    m_bReceiptIndexes = true;
+
+    for (auto& it : m_mapTransactions) {
+        OT_ASSERT(nullptr != it.second);
+
+        index_receipt(*it.second);
+    }
+}
+
+void Ledger::index_transaction(OTTransaction& theTransaction)
+{
+    m_setInRefTo.emplace(
+        theTransaction.GetReferenceToNum(), theTransaction.GetTransactionNum());
+
+    if (m_bReceiptIndexes) {
+        index_receipt(theTransaction);
+    }
+}
+
+void Ledger::unindex_transaction(OTTransaction& theTransaction)
+{
+    const int64_t lTransactionNum = theTransaction.GetTransactionNum();
+    m_setInRefTo.erase({theTransaction.GetReferenceToNum(), lTransactionNum});
+
+    auto it = m_mapReceiptKeys.find(lTransactionNum);
+
+    if (m_mapReceiptKeys.end() != it) {
+        m_setTransferReceipts.erase({it->second, lTransactionNum});
+        m_setChequeReceipts.erase({it->second, lTransactionNum});
+        m_mapReceiptKeys.erase(it);
+    }
+}
+
 OTTransaction* Ledger::GetTransaction(OTTransaction::transactionType theType)
 {
     // loop through the items that make up this transaction
@@ -1175,17 +1309,15 @@ int32_t Ledger::GetTransactionIndex(int64_t lTransactionNum)
 // If it is, return a pointer to it, otherwise return nullptr.
 OTTransaction* Ledger::GetTransaction(int64_t lTransactionNum) const
 {
-    // loop through the transactions inside this ledger
-
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pTransaction = it.second;
-        OT_ASSERT(nullptr != pTransaction);
+    auto it = m_mapTransactions.find(lTransactionNum);
 
-        if (pTransaction->GetTransactionNum() == lTransactionNum) {
-            return pTransaction;
-        }
+    if (m_mapTransactions.end() == it) {
+        return nullptr;
     }
-    return nullptr;
+
+    OT_ASSERT(nullptr != it->second);
+
+    return it->second;
 }
 
 // Return a count of all the transactions in this ledger that are IN REFERENCE
@@ -1197,9 +1329,12 @@ int32_t Ledger::GetTransactionCountInRefTo(int64_t lReferenceNum) const
 {
     int32_t nCount = 0;
 
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pTransaction = it.second;
-        OT_ASSERT(nullptr != pTransaction);
+    for (auto it = m_setInRefTo.lower_bound({lReferenceNum, INT64_MIN});
+         (m_setInRefTo.end() != it) && (it->first == lReferenceNum);
+         ++it) {
+        OTTransaction* pTransaction = GetTransaction(it->second);
+
+        if (nullptr == pTransaction) continue;
 
         if (pTransaction->GetReferenceToNum() == lReferenceNum) nCount++;
     }
@@ -1251,78 +1386,30 @@ OTTransaction* Ledger::GetReplyNotice(const int64_t& lRequestNum)
 
 OTTransaction* Ledger::GetTransferReceipt(int64_t lNumberOfOrigin)
 {
-    // loop through the transactions that make up this ledger.
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pTransaction = it.second;
-        OT_ASSERT(nullptr != pTransaction);
-
-        if (OTTransaction::transferReceipt == pTransaction->GetType()) {
-            String strReference;
-            pTransaction->GetReferenceString(strReference);
-
-            std::unique_ptr<Item> pOriginalItem(
-                Item::CreateItemFromString(
-                    strReference,
-                    pTransaction->GetPurportedNotaryID(),
-                    pTransaction->GetReferenceToNum()));
-            OT_ASSERT(nullptr != pOriginalItem);
+    index_receipts();
 
-            if (pOriginalItem->GetType() != Item::acceptPending) {
-                otErr << "OTLedger::" << __FUNCTION__
-                      << ": Wrong item type attached to transferReceipt!\n";
-                return nullptr;
-            } else {
-                // Note: the acceptPending USED to be "in reference to" whatever
-                // the pending
-                // was in reference to. (i.e. the original transfer.) But since
-                // the KacTech
-                // bug fix (for accepting multiple transfer receipts) the
-                // acceptPending is now
-                // "in reference to" the pending itself, instead of the original
-                // transfer.
-                //
-                // It used to be that a caller of GetTransferReceipt would pass
-                // in the InRefTo
-                // expected from the pending in the outbox, and match it to the
-                // InRefTo found
-                // on the acceptPending (inside the transferReceipt) in the
-                // inbox.
-                // But this is no longer possible, since the acceptPending is no
-                // longer InRefTo
-                // whatever the pending is InRefTo.
-                //
-                // Therefore, in this place, it is now necessary to pass in the
-                // NumberOfOrigin,
-                // and compare it to the NumberOfOrigin, to find the match.
-                //
-                if (pOriginalItem->GetNumberOfOrigin() == lNumberOfOrigin)
-                    //              if (pOriginalItem->GetReferenceToNum() ==
-                    // lTransactionNum)
-                    return pTransaction;  // FOUND IT!
-            }
-        }
-    }
-
-    return nullptr;
+    // Note: the acceptPending USED to be "in reference to" whatever the
+    // pending was in reference to. (i.e. the original transfer.) But since the
+    // KacTech bug fix (for accepting multiple transfer receipts) the
+    // acceptPending is now "in reference to" the pending itself, instead of
+    // the original transfer.
+    //
+    // Therefore it is necessary to pass in the NumberOfOrigin, and compare it
+    // to the NumberOfOrigin on the acceptPending, to find the match. (That is
+    // what m_setTransferReceipts is keyed on.)
+    //
+    return find_receipt(m_setTransferReceipts, lNumberOfOrigin);
 }
 
-// This method loops through all the receipts in the ledger (inbox usually),
-// to see if there's a chequeReceipt for a given cheque. For each cheque
-// receipt,
-// it will load up the original depositCheque item it references, and then load
-// up
-// the actual cheque which is attached to that item. At this point it can verify
-// whether lChequeNum matches the transaction number on the cheque itself, and
-// if
-// so, return a pointer to the relevant chequeReceipt.
+// This method looks for a chequeReceipt (or voucherReceipt) for a given cheque
+// in the ledger (inbox usually). Each receipt is indexed by the transaction
+// number on the cheque attached to the original depositCheque item it
+// references, so the receipts are only parsed once.
 //
 // The caller has the option of passing ppChequeOut if he wants the cheque
-// returned
-// (if he's going to load it anyway, no sense in loading it twice.) If the
-// caller
-// elects this option, he needs to delete the cheque when he's done with it.
-// (But of course do NOT delete the OTTransaction that's returned, since that is
-// owned by the ledger.)
+// returned. If the caller elects this option, he needs to delete the cheque
+// when he's done with it. (But of course do NOT delete the OTTransaction that's
+// returned, since that is owned by the ledger.)
 //
 OTTransaction* Ledger::GetChequeReceipt(
     int64_t lChequeNum,
@@ -1330,90 +1417,23 @@ OTTransaction* Ledger::GetChequeReceipt(
                            // RESPONSIBLE
                            // TO DELETE.
 {
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pCurrentReceipt = it.second;
-        OT_ASSERT(nullptr != pCurrentReceipt);
+    index_receipts();
 
-        if ((pCurrentReceipt->GetType() != OTTransaction::chequeReceipt) &&
-            (pCurrentReceipt->GetType() != OTTransaction::voucherReceipt))
-            continue;
+    OTTransaction* pCurrentReceipt =
+        find_receipt(m_setChequeReceipts, lChequeNum);
 
-        String strDepositChequeMsg;
-        pCurrentReceipt->GetReferenceString(strDepositChequeMsg);
-
-        std::unique_ptr<Item> pOriginalItem(
-            Item::CreateItemFromString(
-                strDepositChequeMsg,
-                GetPurportedNotaryID(),
-                pCurrentReceipt->GetReferenceToNum()));
-
-        if (nullptr == pOriginalItem) {
-            otErr << __FUNCTION__
-                  << ": Expected original depositCheque request item to be "
-                     "inside the chequeReceipt "
-                     "(but failed to load it...)\n";
-        } else if (Item::depositCheque != pOriginalItem->GetType()) {
-            String strItemType;
-            pOriginalItem->GetTypeString(strItemType);
-            otErr << __FUNCTION__
-                  << ": Expected original depositCheque request item to be "
-                     "inside the chequeReceipt, "
-                     "but somehow what we found instead was a "
-                  << strItemType << "...\n";
-        } else {
-            // Get the cheque from the Item and load it up into a Cheque object.
-            //
-            String strCheque;
-            pOriginalItem->GetAttachment(strCheque);
-
-            Cheque* pCheque = new Cheque;
-            OT_ASSERT(nullptr != pCheque);
-            std::unique_ptr<Cheque> theChequeAngel(pCheque);
-
-            if (!((strCheque.GetLength() > 2) &&
-                  pCheque->LoadContractFromString(strCheque))) {
-                otErr << __FUNCTION__ << ": Error loading cheque from string:\n"
-                      << strCheque << "\n";
-            }
-            // NOTE: Technically we don'T NEED to load up the cheque anymore,
-            // since
-            // we could just check the NumberOfOrigin, which should already
-            // match the
-            // transaction number on the cheque.
-            // However, even that would have to load up the cheque once, if it
-            // wasn't
-            // already set, and this function already must RETURN a copy of the
-            // cheque
-            // (at least optionally), so we might as well just load it up,
-            // verify it,
-            // and return it. (That's why we are still loading the cheque here
-            // instead
-            // of checking the number of origin.)
-            else {
-                // Success loading the cheque.
-                // Let's see if it's the right cheque...
-                if (pCheque->GetTransactionNum() == lChequeNum) {
-                    // We found it! Let's return a pointer to pCurrentReceipt
+    if ((nullptr != pCurrentReceipt) && (nullptr != ppChequeOut)) {
+        (*ppChequeOut) = LoadReceiptCheque(
+            *pCurrentReceipt, GetPurportedNotaryID());  // now caller is
+                                                        // responsible to
+                                                        // delete.
 
-                    // Also return pCheque, if the caller wants it (otherwise
-                    // delete it.)
-                    //
-                    if (nullptr !=
-                        ppChequeOut)  // caller wants us to return the
-                                      // cheque pointer as well.
-                    {
-                        (*ppChequeOut) =
-                            pCheque;  // now caller is responsible to delete.
-                        theChequeAngel.release();
-                    }
-
-                    return pCurrentReceipt;
-                }
-            }
+        if (nullptr == (*ppChequeOut)) {
+            return nullptr;
         }
     }
 
-    return nullptr;
+    return pCurrentReceipt;
 }
 
 // Find the finalReceipt in this Inbox, that has lTransactionNum as its "in
@@ -1432,10 +1452,13 @@ OTTransaction* Ledger::GetChequeReceipt(
 //
 OTTransaction* Ledger::GetFinalReceipt(int64_t lReferenceNum)
 {
-    // loop through the transactions that make up this ledger.
-    for (auto& it : m_mapTransactions) {
-        OTTransaction* pTransaction = it.second;
-        OT_ASSERT(nullptr != pTransaction);
+    // loop through the transactions in reference to lReferenceNum.
+    for (auto it = m_setInRefTo.lower_bound({lReferenceNum, INT64_MIN});
+         (m_setInRefTo.end() != it) && (it->first == lReferenceNum);
+         ++it) {
+        OTTransaction* pTransaction = GetTransaction(it->second);
+
+        if (nullptr == pTransaction) continue;
 
         if (OTTransaction::finalReceipt != pTransaction->GetType())  // <=======
             continue;
@@ -2139,6 +2162,7 @@ int32_t Ledger::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
                         m_mapTransactions[pTransaction->GetTransactionNum()] =
                             pTransaction;
                         pTransaction->SetParent(*this);
+                        index_transaction(*pTransaction);
                         //                      otLog5 << "Loaded abbreviated
                         // transaction and adding to m_mapTransactions in
                         // OTLedger\n");
@@ -2307,6 +2331,7 @@ int32_t Ledger::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
                 m_mapTransactions[pTransaction->GetTransactionNum()] =
                     pTransaction;
                 pTransaction->SetParent(*this);
+                index_transaction(*pTransaction);
                 //                otLog5 << "Loaded full transaction and adding
                 // to m_mapTransactions in OTLedger\n");
 
@@ -2403,6 +2428,12 @@ void Ledger::ReleaseTransactions()
 {
     // If there were any dynamically allocated objects, clean them up here.
 
+    m_setInRefTo.clear();
+    m_setTransferReceipts.clear();
+    m_setChequeReceipts.clear();
+    m_mapReceiptKeys.clear();
+    m_bReceiptIndexes = false;
+
     while (!m_mapTransactions.empty()) {
         OTTransaction* pTransaction = m_mapTransactions.begin()->second;
         m_mapTransactions.erase(m_mapTransactions.begin());
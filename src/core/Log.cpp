@@ -41,6 +41,7 @@
 #include "opentxs/api/Settings.hpp"
 #include "opentxs/core/util/Assert.hpp"
 #include "opentxs/core/util/Common.hpp"
+#include "opentxs/core/util/LogWriter.hpp"
 #include "opentxs/core/util/OTPaths.hpp"
 #include "opentxs/core/util/stacktrace.h"
 #include "opentxs/core/String.hpp"
@@ -77,8 +78,11 @@
 #include <deque>
 #include <exception>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
 #include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <typeinfo>
@@ -136,6 +140,8 @@ struct sigcontext
 #define LOGFILE_EXT ".log"
 #define GLOBAL_LOGNAME "init"
 #define GLOBAL_LOGFILE "init.log"
+#define LOGFILE_MAX_SIZE 0
+#define LOGFILE_MAX_FILES 5
 
 //  OTLog Static Variables and Constants.
 
@@ -143,6 +149,8 @@ namespace opentxs
 {
 
 Log* Log::pLogger = nullptr;
+std::atomic<std::size_t> Log::s_nUsers{0};
+std::atomic<bool> Log::s_bReplacing{false};
 
 const String Log::m_strVersion = OPENTXS_VERSION_STRING;
 const String Log::m_strPathSeparator = "/";
@@ -158,41 +166,82 @@ OTLOG_IMPORT OTLogStream otLog5(5); // logs using OTLog::vOutput(5)
 OTLogStream::OTLogStream(int _logLevel)
     : std::ostream(this)
     , logLevel(_logLevel)
-    , next(0)
-    , pBuffer(new char[1024])
 {
+    SetLogLevel(0);
 }
 
-OTLogStream::~OTLogStream()
+OTLogStream::~OTLogStream() {}
+
+void OTLogStream::SetLogLevel(int32_t nLogLevel)
 {
-    delete[] pBuffer;
-    pBuffer = nullptr;
+    if ((logLevel < 0) || (logLevel <= nLogLevel)) {
+        clear();
+    } else {
+        clear(std::ios::badbit);
+    }
 }
 
 int OTLogStream::overflow(int c)
 {
-    pBuffer[next++] = c;
-    if (c != '\n' && next < 1000) {
+    thread_local std::map<const OTLogStream*, std::string> buffers;
+    auto& buffer = buffers[this];
+    buffer.push_back(static_cast<char>(c));
+
+    if (c != '\n' && buffer.size() < 1000) {
         return 0;
     }
 
-    pBuffer[next++] = '\0';
-    next = 0;
+    const std::string line(buffer);
+    buffer.clear();
 
     if (logLevel < 0) {
-        Log::Error(pBuffer);
+        Log::Error(line.c_str());
         return 0;
     }
 
-    Log::Output(logLevel, pBuffer);
+    Log::Output(logLevel, line.c_str());
     return 0;
 }
 
+Log::Lease::Lease()
+{
+    ++s_nUsers;
+
+    // Both flags are sequentially consistent, so either Exclusive sees this
+    // lease or this lease sees Exclusive.
+    if (s_bReplacing.load()) {
+        --s_nUsers;
+    } else {
+        held_ = true;
+    }
+}
+
+Log::Lease::~Lease()
+{
+    if (held_) { --s_nUsers; }
+}
+
+Log::Exclusive::Exclusive()
+{
+    bool expected = false;
+
+    while (!s_bReplacing.compare_exchange_weak(expected, true)) {
+        expected = false;
+        std::this_thread::yield();
+    }
+
+    while (0 < s_nUsers.load()) { std::this_thread::yield(); }
+}
+
+Log::Exclusive::~Exclusive() { s_bReplacing.store(false); }
+
 //  OTLog Init, must run this before using any OTLog function.
 
 // static
 bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
 {
+    const Exclusive exclusive;
+
     if (nullptr == pLogger) {
         pLogger = new Log;
         pLogger->m_bInitialized = false;
@@ -206,6 +255,10 @@ bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
 
         pLogger->m_nLogLevel = nLogLevel;
 
+        int64_t lMaxSize = LOGFILE_MAX_SIZE;
+        int64_t lMaxFiles = LOGFILE_MAX_FILES;
+        bool bStructured = false;
+
         if (!strThreadContext.Exists() ||
             strThreadContext.Compare("")) // global
         {
@@ -231,6 +284,24 @@ bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
                 return false;
             }
 
+            if (!config.CheckSet_long(
+                    "logging", "max_size", LOGFILE_MAX_SIZE, lMaxSize, bIsNew,
+                    "; Rotate the log file at this many bytes. (0 = never)")) {
+                return false;
+            }
+
+            if (!config.CheckSet_long(
+                    "logging", "max_files", LOGFILE_MAX_FILES, lMaxFiles,
+                    bIsNew, "; Number of rotated log files to keep.")) {
+                return false;
+            }
+
+            if (!config.CheckSet_bool(
+                    "logging", "structured", false, bStructured, bIsNew,
+                    "; Write log lines as key=value records.")) {
+                return false;
+            }
+
             if (!config.Save()) {
                 return false;
             }
@@ -246,7 +317,13 @@ bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
                 return false;
             }
 
+        pLogger->m_bStructured = bStructured;
+        pLogger->m_pWriter.reset(new LogWriter(
+            pLogger->m_strLogFilePath.Get(),
+            (0 < lMaxSize) ? static_cast<uint64_t>(lMaxSize) : 0,
+            (0 < lMaxFiles) ? static_cast<uint32_t>(lMaxFiles) : 0));
         pLogger->m_bInitialized = true;
+        update_streams();
 
         // Set the new log-assert function pointer.
         Assert* pLogAssert = new Assert(Log::logAssert);
@@ -264,15 +341,22 @@ bool Log::Init(const String& strThreadContext, const int32_t& nLogLevel)
 // static
 bool Log::IsInitialized()
 {
-    return nullptr != pLogger && pLogger->m_bInitialized;
+    const Lease lease;
+
+    return lease && (nullptr != pLogger) && pLogger->m_bInitialized;
 }
 
 // static
 bool Log::Cleanup()
 {
+    // Once every other thread has stopped using the logger, deleting it
+    // drains whatever is still queued and joins the writer thread.
+    const Exclusive exclusive;
+
     if (nullptr != pLogger) {
         delete pLogger;
         pLogger = nullptr;
+        update_streams();
         return true;
     }
     return false;
@@ -326,9 +410,21 @@ const String& Log::GetLogFilePath()
 
 // static
 int32_t Log::LogLevel()
+{
+    const Lease lease;
+
+    if (!lease) return 0;
+
+    return log_level();
+}
+
+// Caller must hold a Lease or an Exclusive.
+//
+// static
+int32_t Log::log_level()
 {
     if (nullptr != pLogger)
-        return pLogger->m_nLogLevel;
+        return pLogger->m_nLogLevel.load();
     else
         return 0;
 }
@@ -336,11 +432,16 @@ int32_t Log::LogLevel()
 // static
 bool Log::SetLogLevel(const int32_t& nLogLevel)
 {
+    const Lease lease;
+
+    if (!lease) return false;
+
     if (nullptr == pLogger) {
         OT_FAIL;
     }
     else {
         pLogger->m_nLogLevel = nLogLevel;
+        update_streams();
         return true;
     }
 }
@@ -355,48 +456,123 @@ bool Log::SetLogLevel(const int32_t& nLogLevel)
 // static
 bool Log::LogToFile(const String& strOutput)
 {
-    // We now do this either way.
-    {
-        std::cerr << strOutput;
-        std::cerr.flush();
+    if (!strOutput.Exists()) return false;
+
+    const Lease lease;
+
+    if (!lease) {
+        std::cerr << strOutput.Get();
+
+        return false;
     }
 
-    // now log to file, if we can.
+    return log_to_file(strOutput.Get());
+}
 
-    bool bHaveLogger(false);
-    if (nullptr != pLogger)
-        if (pLogger->IsInitialized()) bHaveLogger = true;
+// Caller must hold a Lease.
+//
+// static
+bool Log::log_to_file(std::string&& strOutput)
+{
+    if (strOutput.empty()) return false;
 
-    // lets check if we are Initialized in this context
-    if (bHaveLogger) CheckLogger(Log::pLogger);
+    // Once initialized, the writer thread sends it to stderr and the logfile.
+    if (IsInitialized() && (nullptr != pLogger->m_pWriter)) {
+        pLogger->m_pWriter->Push(std::move(strOutput));
+
+        return true;
+    }
+
+    std::cerr << strOutput;
+    std::cerr.flush();
+
+    return false;
+}
+
+// static
+void Log::Flush()
+{
+    const Lease lease;
+
+    if (lease && IsInitialized() && (nullptr != pLogger->m_pWriter)) {
+        pLogger->m_pWriter->Flush();
+    }
+}
+
+// static
+void Log::update_streams()
+{
+    const int32_t nLogLevel = log_level();
+
+    for (auto pStream :
+         {&otErr, &otInfo, &otOut, &otWarn, &otLog3, &otLog4, &otLog5}) {
+        pStream->SetLogLevel(nLogLevel);
+    }
+}
+
+// In structured mode every call becomes one key=value record:
+// time=<unix seconds> level=<verbosity|error> context=<thread context>
+// thread=<thread id> msg="<escaped message>"
+//
+// static
+void Log::write(const char* szLevel, const char* szOutput)
+{
+    if (!IsInitialized() || !pLogger->m_bStructured) {
+        log_to_file(szOutput);
+
+        return;
+    }
 
-    bool bSuccess = false;
+    std::string strMessage(szOutput);
 
-    if (bHaveLogger) {
-        // Append to logfile
-        if ((strOutput.Exists()) && (Log::pLogger->m_strLogFilePath.Exists())) {
-            std::ofstream logfile;
-            logfile.open(Log::LogFilePath(), std::ios::app);
+    while (!strMessage.empty() &&
+           (('\n' == strMessage.back()) || ('\r' == strMessage.back()))) {
+        strMessage.pop_back();
+    }
 
-            if (!logfile.fail()) {
-                logfile << strOutput;
-                logfile.close();
-                bSuccess = true;
+    if (strMessage.empty()) return;
+
+    const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    std::ostringstream record;
+    record << "time=" << (now.count() / 1000) << "." << std::setfill('0')
+           << std::setw(3) << (now.count() % 1000) << " level=" << szLevel
+           << " context=" << pLogger->m_strThreadContext
+           << " thread=" << std::this_thread::get_id() << " msg=\"";
+
+    for (const auto& c : strMessage) {
+        switch (c) {
+            case '\n': {
+                record << "\\n";
+            } break;
+            case '\r': {
+                record << "\\r";
+            } break;
+            case '"':
+            case '\\': {
+                record << '\\' << c;
+            } break;
+            default: {
+                record << c;
             }
         }
     }
 
-    return bSuccess;
+    record << "\"\n";
+    log_to_file(record.str());
 }
 
 String Log::GetMemlogAtIndex(int32_t nIndex)
 {
     // lets check if we are Initialized in this context
-    CheckLogger(Log::pLogger);
+    const Lease lease;
+    CheckLogger(lease ? Log::pLogger : nullptr);
 
+    std::unique_lock<std::mutex> lock(Log::pLogger->m_memlogLock);
     uint32_t uIndex = static_cast<uint32_t>(nIndex);
 
     if ((nIndex < 0) || (uIndex >= Log::pLogger->logDeque.size())) {
+        lock.unlock();
         otErr << __FUNCTION__ << ": index out of bounds: " << nIndex << "\n";
         return "";
     }
@@ -419,7 +595,10 @@ String Log::GetMemlogAtIndex(int32_t nIndex)
 int32_t Log::GetMemlogSize()
 {
     // lets check if we are Initialized in this context
-    CheckLogger(Log::pLogger);
+    const Lease lease;
+    CheckLogger(lease ? Log::pLogger : nullptr);
+
+    std::lock_guard<std::mutex> lock(Log::pLogger->m_memlogLock);
 
     return static_cast<int32_t>(Log::pLogger->logDeque.size());
 }
@@ -427,7 +606,10 @@ int32_t Log::GetMemlogSize()
 String Log::PeekMemlogFront()
 {
     // lets check if we are Initialized in this context
-    CheckLogger(Log::pLogger);
+    const Lease lease;
+    CheckLogger(lease ? Log::pLogger : nullptr);
+
+    std::lock_guard<std::mutex> lock(Log::pLogger->m_memlogLock);
 
     if (Log::pLogger->logDeque.size() <= 0) return nullptr;
 
@@ -447,7 +629,10 @@ String Log::PeekMemlogFront()
 String Log::PeekMemlogBack()
 {
     // lets check if we are Initialized in this context
-    CheckLogger(Log::pLogger);
+    const Lease lease;
+    CheckLogger(lease ? Log::pLogger : nullptr);
+
+    std::lock_guard<std::mutex> lock(Log::pLogger->m_memlogLock);
 
     if (Log::pLogger->logDeque.size() <= 0) return nullptr;
 
@@ -468,7 +653,10 @@ String Log::PeekMemlogBack()
 bool Log::PopMemlogFront()
 {
     // lets check if we are Initialized in this context
-    CheckLogger(Log::pLogger);
+    const Lease lease;
+    CheckLogger(lease ? Log::pLogger : nullptr);
+
+    std::lock_guard<std::mutex> lock(Log::pLogger->m_memlogLock);
 
     if (Log::pLogger->logDeque.size() <= 0) return false;
 
@@ -485,8 +673,19 @@ bool Log::PopMemlogFront()
 bool Log::PopMemlogBack()
 {
     // lets check if we are Initialized in this context
-    CheckLogger(Log::pLogger);
+    const Lease lease;
+    CheckLogger(lease ? Log::pLogger : nullptr);
+
+    std::lock_guard<std::mutex> lock(Log::pLogger->m_memlogLock);
 
+    return pop_memlog_back();
+}
+
+// Caller must hold m_memlogLock.
+//
+// static
+bool Log::pop_memlog_back()
+{
     if (Log::pLogger->logDeque.size() <= 0) return false;
 
     String* strLogBack = Log::pLogger->logDeque.back();
@@ -502,15 +701,18 @@ bool Log::PopMemlogBack()
 bool Log::PushMemlogFront(const String& strLog)
 {
     // lets check if we are Initialized in this context
-    CheckLogger(Log::pLogger);
+    const Lease lease;
+    CheckLogger(lease ? Log::pLogger : nullptr);
 
     OT_ASSERT(strLog.Exists());
 
+    std::lock_guard<std::mutex> lock(Log::pLogger->m_memlogLock);
+
     Log::pLogger->logDeque.push_front(new String(strLog));
 
     if (Log::pLogger->logDeque.size() > LOG_DEQUE_SIZE) {
-        Log::PopMemlogBack(); // We start removing from the back when it
-                              // reaches this size.
+        pop_memlog_back(); // We start removing from the back when it
+                           // reaches this size.
     }
 
     return true;
@@ -570,6 +772,7 @@ size_t Log::logAssert(const char* szFilename, size_t nLinenumber,
     }
 
     print_stacktrace();
+    Flush();
 
     return 1; // normal
 }
@@ -579,26 +782,30 @@ size_t Log::logAssert(const char* szFilename, size_t nLinenumber,
 
 void Log::Output(int32_t nVerbosity, const char* szOutput)
 {
-    bool bHaveLogger(false);
-    if (nullptr != pLogger)
-        if (pLogger->IsInitialized()) bHaveLogger = true;
+    const Lease lease;
 
-    // lets check if we are Initialized in this context
-    if (bHaveLogger) CheckLogger(Log::pLogger);
+    if (!lease) {
+        // The logger is being replaced. Keep only what always logs.
+        if ((0 >= nVerbosity) && (nullptr != szOutput)) std::cerr << szOutput;
+
+        return;
+    }
 
     // If log level is 0, and verbosity of this message is 2, don't bother
     // logging it.
     //    if (nVerbosity > OTLog::__CurrentLogLevel || (nullptr == szOutput))
-    if ((nVerbosity > LogLevel()) || (nullptr == szOutput) ||
-        (LogLevel() == (-1)))
+    if ((nVerbosity > log_level()) || (nullptr == szOutput) ||
+        (log_level() == (-1)))
         return;
 
+    const bool bHaveLogger = (nullptr != pLogger) && pLogger->m_bInitialized;
+
     // We store the last 1024 logs so programmers can access them via the API.
     if (bHaveLogger) Log::PushMemlogFront(szOutput);
 
 #ifndef ANDROID // if NOT android
 
-    LogToFile(szOutput);
+    write(std::to_string(nVerbosity).c_str(), szOutput);
 
 #else // if IS Android
     /*
@@ -637,17 +844,10 @@ void Log::Output(int32_t nVerbosity, const char* szOutput)
 // the vOutput is to avoid name conflicts.
 void Log::vOutput(int32_t nVerbosity, const char* szOutput, ...)
 {
-    bool bHaveLogger(false);
-    if (nullptr != pLogger)
-        if (pLogger->IsInitialized()) bHaveLogger = true;
-
-    // lets check if we are Initialized in this context
-    if (bHaveLogger) CheckLogger(Log::pLogger);
-
     // If log level is 0, and verbosity of this message is 2, don't bother
-    // logging it.
-    if (((0 != LogLevel()) && (nVerbosity > LogLevel())) ||
-        (nullptr == szOutput))
+    // formatting it.
+    if ((nVerbosity > LogLevel()) || (nullptr == szOutput) ||
+        (LogLevel() == (-1)))
         return;
 
     va_list args;
@@ -669,13 +869,6 @@ void Log::vOutput(int32_t nVerbosity, const char* szOutput, ...)
 // the vError name is to avoid name conflicts
 void Log::vError(const char* szError, ...)
 {
-    bool bHaveLogger(false);
-    if (nullptr != pLogger)
-        if (pLogger->IsInitialized()) bHaveLogger = true;
-
-    // lets check if we are Initialized in this context
-    if (bHaveLogger) CheckLogger(Log::pLogger);
-
     if ((nullptr == szError)) return;
 
     va_list args;
@@ -700,21 +893,25 @@ void Log::vError(const char* szError, ...)
 
 void Log::Error(const char* szError)
 {
-    bool bHaveLogger(false);
-    if (nullptr != pLogger)
-        if (pLogger->IsInitialized()) bHaveLogger = true;
+    if ((nullptr == szError)) return;
 
-    // lets check if we are Initialized in this context
-    if (bHaveLogger) CheckLogger(Log::pLogger);
+    const Lease lease;
 
-    if ((nullptr == szError)) return;
+    if (!lease) {
+        // The logger is being replaced.
+        std::cerr << szError;
+
+        return;
+    }
+
+    const bool bHaveLogger = (nullptr != pLogger) && pLogger->m_bInitialized;
 
     // We store the last 1024 logs so programmers can access them via the API.
     if (bHaveLogger) Log::PushMemlogFront(szError);
 
 #ifndef ANDROID // if NOT android
 
-    LogToFile(szError);
+    write("error", szError);
 
 #else // if Android
     __android_log_write(ANDROID_LOG_ERROR, "OT Error", szError);
@@ -728,13 +925,6 @@ void Log::Error(const char* szError)
 // static
 void Log::Errno(const char* szLocation) // stderr
 {
-    bool bHaveLogger(false);
-    if (nullptr != pLogger)
-        if (pLogger->IsInitialized()) bHaveLogger = true;
-
-    // lets check if we are Initialized in this context
-    if (bHaveLogger) CheckLogger(Log::pLogger);
-
     const int32_t errnum = errno;
     char buf[128];
     buf[0] = '\0';
@@ -53,21 +53,31 @@
 #include "opentxs/core/OTTransaction.hpp"
 #include "opentxs/core/Proto.hpp"
 #include "opentxs/core/String.hpp"
+#include "opentxs/core/crypto/CryptoAsymmetric.hpp"
 #include "opentxs/core/crypto/OTASCIIArmor.hpp"
 #include "opentxs/core/crypto/OTAsymmetricKey.hpp"
+#include "opentxs/core/crypto/OTPasswordData.hpp"
+#include "opentxs/core/crypto/OTSignature.hpp"
 #include "opentxs/core/util/Assert.hpp"
 #include "opentxs/core/util/Common.hpp"
 #include "opentxs/core/util/Tag.hpp"
 
+#include "NotaryMessage.pb.h"
+
 #include <stdint.h>
 #include <stdexcept>
 #include <fstream>
 #include <irrxml/irrXML.hpp>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 
+#define OT_BINARY_MESSAGE_VERSION 1
+#define OT_BEGIN_NOTARY_MESSAGE "-----BEGIN OT NOTARY MESSAGE-----"
+#define OT_END_NOTARY_MESSAGE "-----END OT NOTARY MESSAGE-----"
+
 // PROTOCOL DOCUMENT
 
 // --- This is the file that implements the entire message protocol.
@@ -216,6 +226,10 @@ void Message::UpdateContents()
     tag.add_attribute("version", m_strVersion.Get());
     tag.add_attribute("dateSigned", formatTimestamp(m_lTime));
 
+    if (m_bBinaryMessages) {
+        tag.add_attribute("binaryMessages", formatBool(true));
+    }
+
     if (!updateContentsByType(tag)) {
         TagPtr pTag(new Tag(m_strCommand.Get()));
         pTag->add_attribute("requestNum", m_strRequestNum.Get());
@@ -340,6 +354,9 @@ int32_t Message::processXmlNodeNotaryMessage(
 
     if (strDateSigned.Exists()) m_lTime = parseTimestamp(strDateSigned.Get());
 
+    m_bBinaryMessages =
+        String(xml->getAttributeValue("binaryMessages")).Compare("true");
+
     otInfo << "\n===> Loading XML for Message into memory structures...\n";
 
     return 1;
@@ -387,7 +404,11 @@ bool Message::SignContract(const Nym& theNym, const OTPasswordData* pPWData)
 
     // Use the authentication key instead of the signing key.
     //
-    m_bIsSigned = Contract::SignContractAuthent(theNym, pPWData);
+    if (binary_) {
+        m_bIsSigned = sign_binary(theNym, pPWData);
+    } else {
+        m_bIsSigned = Contract::SignContractAuthent(theNym, pPWData);
+    }
 
     if (m_bIsSigned) {
         //        otErr <<
@@ -418,6 +439,8 @@ bool Message::VerifySignature(const Nym& theNym, const OTPasswordData* pPWData)
     // probably be
     // the same way. (Maybe it already is, by the time you are reading this.)
     //
+    if (binary_) { return verify_binary(theNym, pPWData); }
+
     return VerifySigAuthent(theNym, pPWData);
 }
 
@@ -434,6 +457,387 @@ bool Message::VerifySignature(const Nym& theNym, const OTPasswordData* pPWData)
 //
 bool Message::VerifyContractID() const { return true; }
 
+namespace
+{
+void armor_to_bytes(const OTASCIIArmor& input, std::string* output)
+{
+    if (!input.Exists()) { return; }
+
+    OTData data;
+    input.GetData(data);
+    output->assign(static_cast<const char*>(data.GetPointer()), data.GetSize());
+}
+
+void bytes_to_armor(const std::string& input, OTASCIIArmor& output)
+{
+    output.Release();
+
+    if (input.empty()) { return; }
+
+    output.SetData(OTData(input.data(), input.size()));
+}
+}  // namespace
+
+// static
+bool Message::IsBinary(const std::string& wire)
+{
+    return (1 < wire.size()) && ('\0' == wire[0]);
+}
+
+void Message::SetBinary(const bool binary)
+{
+    binary_ = binary;
+
+    if (!binary_) { binary_body_.clear(); }
+}
+
+bool Message::LoadBinary(const std::string& wire)
+{
+    Release();
+    binary_body_.clear();
+
+    if (!IsBinary(wire)) {
+        otErr << __FUNCTION__ << ": Not a binary message." << std::endl;
+
+        return false;
+    }
+
+    OTDB::NotaryMessage_InternalPB envelope;
+
+    if (!envelope.ParseFromArray(wire.data() + 1, wire.size() - 1)) {
+        otErr << __FUNCTION__ << ": Unable to parse envelope." << std::endl;
+
+        return false;
+    }
+
+    if (OT_BINARY_MESSAGE_VERSION < envelope.version()) {
+        otErr << __FUNCTION__ << ": Unsupported version "
+              << envelope.version() << std::endl;
+
+        return false;
+    }
+
+    binary_ = true;
+    binary_body_ = envelope.body();
+    m_strSigHashType = static_cast<proto::HashType>(envelope.hash_type());
+
+    for (const auto& signature : envelope.signature()) {
+        std::unique_ptr<OTSignature> pSig(new OTSignature);
+
+        OT_ASSERT(pSig);
+
+        pSig->SetData(OTData(
+            signature.signature().data(), signature.signature().size()));
+        const auto& metadata = signature.metadata();
+
+        if (4 == metadata.size()) {
+            pSig->getMetaData().SetMetadata(
+                metadata[0], metadata[1], metadata[2], metadata[3]);
+        }
+
+        m_listSignatures.push_back(pSig.release());
+    }
+
+    if (!load_binary_body()) {
+        otErr << __FUNCTION__ << ": Unable to parse message body."
+              << std::endl;
+
+        return false;
+    }
+
+    update_binary_contents();
+
+    return true;
+}
+
+bool Message::LoadContractFromString(const String& theStr)
+{
+    String strContract(theStr);
+
+    if (!strContract.Exists() || !strContract.DecodeIfArmored()) {
+        // Let Contract report the error
+        return Contract::LoadContractFromString(theStr);
+    }
+
+    if (!strContract.Contains(OT_BEGIN_NOTARY_MESSAGE)) {
+        binary_ = false;
+        binary_body_.clear();
+
+        return Contract::LoadContractFromString(strContract);
+    }
+
+    const std::string input(strContract.Get(), strContract.GetLength());
+    const auto begin = input.find('\n', input.find(OT_BEGIN_NOTARY_MESSAGE));
+    const auto end = input.find(OT_END_NOTARY_MESSAGE);
+
+    if ((std::string::npos == begin) || (std::string::npos == end) ||
+        (end < begin)) {
+        otErr << __FUNCTION__ << ": Malformed binary message." << std::endl;
+
+        return false;
+    }
+
+    OTASCIIArmor armored;
+    armored.Set(input.substr(begin + 1, end - begin - 1).c_str());
+    OTData wire;
+
+    if (!armored.GetData(wire)) {
+        otErr << __FUNCTION__ << ": Unable to decode binary message."
+              << std::endl;
+
+        return false;
+    }
+
+    return LoadBinary(std::string(
+        static_cast<const char*>(wire.GetPointer()), wire.GetSize()));
+}
+
+bool Message::SaveContract()
+{
+    if (!binary_) { return Contract::SaveContract(); }
+
+    if (binary_body_.empty()) {
+        otErr << __FUNCTION__ << ": Binary message has not been signed."
+              << std::endl;
+
+        return false;
+    }
+
+    update_binary_contents();
+
+    return true;
+}
+
+bool Message::SerializeBinary(std::string& wire) const
+{
+    wire.clear();
+
+    if (!binary_ || binary_body_.empty()) {
+        otErr << __FUNCTION__ << ": Message is not a signed binary message."
+              << std::endl;
+
+        return false;
+    }
+
+    OTDB::NotaryMessage_InternalPB envelope;
+    envelope.set_version(OT_BINARY_MESSAGE_VERSION);
+    envelope.set_body(binary_body_);
+    envelope.set_hash_type(m_strSigHashType);
+
+    for (const auto& pSig : m_listSignatures) {
+        OT_ASSERT(nullptr != pSig);
+
+        auto& signature = *envelope.add_signature();
+        armor_to_bytes(*pSig, signature.mutable_signature());
+        const auto& metadata = pSig->getMetaData();
+
+        if (metadata.HasMetadata()) {
+            const char chars[] = {metadata.GetKeyType(),
+                                  metadata.FirstCharNymID(),
+                                  metadata.FirstCharMasterCredID(),
+                                  metadata.FirstCharChildCredID()};
+            signature.set_metadata(chars, sizeof(chars));
+        }
+    }
+
+    wire.assign(1, '\0');
+    wire.append(proto::ProtoAsString(envelope));
+
+    return true;
+}
+
+bool Message::load_binary_body()
+{
+    OTDB::NotaryMessageBody_InternalPB body;
+
+    if (!body.ParseFromString(binary_body_)) { return false; }
+
+    m_strVersion.Set(body.version().c_str());
+    m_lTime = body.date_signed();
+    m_strCommand.Set(body.command().c_str());
+    m_strNotaryID.Set(body.notary_id().c_str());
+    m_strNymID.Set(body.nym_id().c_str());
+    m_strNymboxHash.Set(body.nymbox_hash().c_str());
+    m_strInboxHash.Set(body.inbox_hash().c_str());
+    m_strOutboxHash.Set(body.outbox_hash().c_str());
+    m_strNymID2.Set(body.nym_id2().c_str());
+    m_strNymPublicKey.Set(body.nym_public_key().c_str());
+    m_strInstrumentDefinitionID.Set(body.instrument_definition_id().c_str());
+    m_strAcctID.Set(body.acct_id().c_str());
+    m_strType.Set(body.type().c_str());
+    m_strRequestNum.Set(body.request_num().c_str());
+    bytes_to_armor(body.in_reference_to(), m_ascInReferenceTo);
+    bytes_to_armor(body.payload(), m_ascPayload);
+    bytes_to_armor(body.payload2(), m_ascPayload2);
+    bytes_to_armor(body.payload3(), m_ascPayload3);
+    m_AcknowledgedReplies.Release();
+
+    for (const auto& number : body.acknowledged_replies()) {
+        m_AcknowledgedReplies.Add(number);
+    }
+
+    m_lNewRequestNum = body.new_request_num();
+    m_lDepth = body.depth();
+    m_lTransactionNum = body.transaction_num();
+    keytypeAuthent_ = body.keytype_authent();
+    keytypeEncrypt_ = body.keytype_encrypt();
+    enum_ = static_cast<std::uint8_t>(body.enum_value());
+    enum2_ = body.enum2_value();
+    m_bSuccess = body.success();
+    m_bBool = body.bool_value();
+    m_bBinaryMessages = body.binary_messages();
+
+    return true;
+}
+
+bool Message::sign_binary(const Nym& theNym, const OTPasswordData* pPWData)
+{
+    const auto& key = theNym.GetPrivateAuthKey();
+    m_strSigHashType = key.SigHashType();
+    m_lTime = OTTimeGetCurrentTime();
+    m_xmlUnsigned.Release();
+
+    OTDB::NotaryMessageBody_InternalPB body;
+    body.set_version(m_strVersion.Get());
+    body.set_date_signed(m_lTime);
+    body.set_command(m_strCommand.Get());
+    body.set_notary_id(m_strNotaryID.Get());
+    body.set_nym_id(m_strNymID.Get());
+    body.set_nymbox_hash(m_strNymboxHash.Get());
+    body.set_inbox_hash(m_strInboxHash.Get());
+    body.set_outbox_hash(m_strOutboxHash.Get());
+    body.set_nym_id2(m_strNymID2.Get());
+    body.set_nym_public_key(m_strNymPublicKey.Get());
+    body.set_instrument_definition_id(m_strInstrumentDefinitionID.Get());
+    body.set_acct_id(m_strAcctID.Get());
+    body.set_type(m_strType.Get());
+    body.set_request_num(m_strRequestNum.Get());
+    armor_to_bytes(m_ascInReferenceTo, body.mutable_in_reference_to());
+    armor_to_bytes(m_ascPayload, body.mutable_payload());
+    armor_to_bytes(m_ascPayload2, body.mutable_payload2());
+    armor_to_bytes(m_ascPayload3, body.mutable_payload3());
+    std::set<int64_t> acknowledged;
+    m_AcknowledgedReplies.Output(acknowledged);
+
+    for (const auto& number : acknowledged) {
+        body.add_acknowledged_replies(number);
+    }
+
+    body.set_new_request_num(m_lNewRequestNum);
+    body.set_depth(m_lDepth);
+    body.set_transaction_num(m_lTransactionNum);
+    body.set_keytype_authent(keytypeAuthent_);
+    body.set_keytype_encrypt(keytypeEncrypt_);
+    body.set_enum_value(enum_);
+    body.set_enum2_value(enum2_);
+    body.set_success(m_bSuccess);
+    body.set_bool_value(m_bBool);
+    body.set_binary_messages(m_bBinaryMessages);
+    binary_body_ = proto::ProtoAsString(body);
+
+    const OTData plaintext(binary_body_.data(), binary_body_.size());
+    OTData signature;
+
+    if (!key.engine().Sign(
+            plaintext, key, m_strSigHashType, signature, pPWData)) {
+        otErr << __FUNCTION__ << ": Failed to sign message." << std::endl;
+        binary_body_.clear();
+
+        return false;
+    }
+
+    std::unique_ptr<OTSignature> pSig(new OTSignature);
+
+    OT_ASSERT(pSig);
+
+    if (nullptr != key.m_pMetadata) { pSig->getMetaData() = *key.m_pMetadata; }
+
+    pSig->SetData(signature, true);
+    m_listSignatures.push_back(pSig.release());
+
+    return true;
+}
+
+// Binary messages are kept in m_strRawFile in the bookended form, so that
+// String(message) and SaveContractRaw() work the same for both encodings.
+void Message::update_binary_contents()
+{
+    std::string wire;
+    m_strRawFile.Release();
+
+    if (!SerializeBinary(wire)) { return; }
+
+    const OTASCIIArmor armored(
+        OTData(wire.data(), static_cast<uint32_t>(wire.size())));
+    m_strRawFile.Concatenate(
+        "%s\n%s\n%s\n",
+        OT_BEGIN_NOTARY_MESSAGE,
+        armored.Get(),
+        OT_END_NOTARY_MESSAGE);
+}
+
+bool Message::verify_binary(
+    const OTAsymmetricKey& theKey,
+    const OTSignature& theSignature,
+    const OTPasswordData* pPWData) const
+{
+    if ((nullptr != theKey.m_pMetadata) && theKey.m_pMetadata->HasMetadata() &&
+        theSignature.getMetaData().HasMetadata()) {
+        if (theSignature.getMetaData() != *(theKey.m_pMetadata)) {
+            return false;
+        }
+    }
+
+    const OTData plaintext(binary_body_.data(), binary_body_.size());
+    OTData signature;
+    theSignature.GetData(signature);
+
+    return theKey.engine().Verify(
+        plaintext, theKey, signature, m_strSigHashType, pPWData);
+}
+
+// Same key selection as Contract::VerifySigAuthent, over the binary body
+bool Message::verify_binary(const Nym& theNym, const OTPasswordData* pPWData)
+    const
+{
+    if (binary_body_.empty()) { return false; }
+
+    OTPasswordData thePWData("Message::verify_binary");
+    const auto* pw = (nullptr != pPWData) ? pPWData : &thePWData;
+    String strNymID;
+    theNym.GetIdentifier(strNymID);
+    char cNymID = '0';
+    uint32_t uIndex = 3;
+    const bool bNymID = strNymID.At(uIndex, cNymID);
+
+    for (const auto& pSig : m_listSignatures) {
+        OT_ASSERT(nullptr != pSig);
+
+        const auto& metadata = pSig->getMetaData();
+
+        if (bNymID && metadata.HasMetadata() &&
+            (metadata.FirstCharNymID() != cNymID)) {
+            continue;
+        }
+
+        listOfAsymmetricKeys keys;
+
+        if (0 < theNym.GetPublicKeysBySignature(keys, *pSig, 'A')) {
+            for (const auto& pKey : keys) {
+                OT_ASSERT(nullptr != pKey);
+
+                if (verify_binary(*pKey, *pSig, pw)) { return true; }
+            }
+        }
+
+        if (verify_binary(theNym.GetPublicAuthKey(), *pSig, pw)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 Message::Message()
     : Contract()
     , m_bIsSigned(false)
@@ -442,6 +846,7 @@ Message::Message()
     , m_lTransactionNum(0)
     , m_bSuccess(false)
     , m_bBool(false)
+    , m_bBinaryMessages(false)
     , m_lTime(0)
 
 {
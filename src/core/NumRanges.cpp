@@ -0,0 +1,309 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include "opentxs/core/NumRanges.hpp"
+
+#include "opentxs/core/Log.hpp"
+#include "opentxs/core/String.hpp"
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdlib>
+#include <locale>
+#include <ostream>
+
+namespace opentxs
+{
+
+NumRanges::const_iterator::const_iterator(
+    const Ranges::const_iterator& range,
+    const Ranges::const_iterator& end)
+    : range_(range)
+    , end_(end)
+{
+    if (range_ != end_) { value_ = range_->first; }
+}
+
+NumRanges::const_iterator& NumRanges::const_iterator::operator++()
+{
+    if (range_ == end_) { return *this; }
+
+    if (value_ < range_->second) {
+        ++value_;
+    } else {
+        ++range_;
+
+        if (range_ != end_) { value_ = range_->first; }
+    }
+
+    return *this;
+}
+
+NumRanges::const_iterator NumRanges::const_iterator::operator++(int)
+{
+    const_iterator output(*this);
+    ++(*this);
+
+    return output;
+}
+
+NumRanges::NumRanges()
+{
+}
+
+NumRanges::NumRanges(const String& strRanges)
+{
+    Add(strRanges);
+}
+
+NumRanges::Ranges::iterator NumRanges::find_range(const int64_t& theValue)
+{
+    auto it = m_mapRanges.upper_bound(theValue);
+
+    if (m_mapRanges.begin() == it) { return m_mapRanges.end(); }
+
+    --it;
+
+    return (theValue <= it->second) ? it : m_mapRanges.end();
+}
+
+NumRanges::Ranges::const_iterator NumRanges::find_range(
+    const int64_t& theValue) const
+{
+    auto it = m_mapRanges.upper_bound(theValue);
+
+    if (m_mapRanges.begin() == it) { return m_mapRanges.end(); }
+
+    --it;
+
+    return (theValue <= it->second) ? it : m_mapRanges.end();
+}
+
+bool NumRanges::Add(const int64_t& theValue)
+{
+    if (m_mapRanges.end() != find_range(theValue)) { return false; }
+
+    auto next = m_mapRanges.upper_bound(theValue);
+    auto prev = next;
+    const bool joinNext =
+        (m_mapRanges.end() != next) && (next->first - 1 == theValue);
+    const bool joinPrev = (m_mapRanges.begin() != next) &&
+                          ((--prev)->second + 1 == theValue);
+
+    if (joinPrev && joinNext) {
+        prev->second = next->second;
+        m_mapRanges.erase(next);
+    } else if (joinPrev) {
+        prev->second = theValue;
+    } else if (joinNext) {
+        const int64_t lLast = next->second;
+        m_mapRanges.erase(next);
+        m_mapRanges[theValue] = lLast;
+    } else {
+        m_mapRanges[theValue] = theValue;
+    }
+
+    ++m_lCount;
+
+    return true;
+}
+
+void NumRanges::AddRange(const int64_t& lFirst, const int64_t& lLast)
+{
+    if (lFirst > lLast) { return; }
+
+    int64_t lNewFirst = lFirst;
+    int64_t lNewLast = lLast;
+    auto it = m_mapRanges.upper_bound(lFirst);
+
+    if (m_mapRanges.begin() != it) {
+        auto prev = std::prev(it);
+
+        // Overlapping or adjacent runs are merged into the new one.
+        if ((prev->second >= lFirst) || (prev->second + 1 == lFirst)) {
+            it = prev;
+        }
+    }
+
+    while ((m_mapRanges.end() != it) &&
+           ((it->first <= lLast) || (it->first - 1 == lLast))) {
+        if (it->first < lNewFirst) { lNewFirst = it->first; }
+        if (it->second > lNewLast) { lNewLast = it->second; }
+
+        m_lCount -= static_cast<std::size_t>(it->second - it->first) + 1;
+        it = m_mapRanges.erase(it);
+    }
+
+    m_mapRanges[lNewFirst] = lNewLast;
+    m_lCount += static_cast<std::size_t>(lNewLast - lNewFirst) + 1;
+}
+
+bool NumRanges::Add(const String& strRanges)
+{
+    if (!strRanges.Exists()) { return true; }
+
+    const char* pChar = strRanges.Get();
+    std::locale loc;
+
+    for (;;) {
+        while (std::isspace(*pChar, loc) || (',' == *pChar)) pChar++;
+
+        if ('\0' == *pChar) { break; }
+
+        char* pEnd = nullptr;
+        const int64_t lFirst = std::strtoll(pChar, &pEnd, 10);
+        int64_t lLast = lFirst;
+        bool bValid = (pEnd != pChar);
+        pChar = pEnd;
+
+        if (bValid && ('-' == *pChar)) {
+            pChar++;
+            lLast = std::strtoll(pChar, &pEnd, 10);
+            bValid = (pEnd != pChar) && (lLast >= lFirst);
+            pChar = pEnd;
+        }
+
+        if (!bValid) {
+            otErr << __FUNCTION__ << ": Error: Malformed list of number "
+                                     "ranges: " << strRanges << "\n";
+
+            return false;
+        }
+
+        AddRange(lFirst, lLast);
+    }
+
+    return true;
+}
+
+bool NumRanges::Remove(const int64_t& theValue)
+{
+    auto it = find_range(theValue);
+
+    if (m_mapRanges.end() == it) { return false; }
+
+    const int64_t lFirst = it->first;
+    const int64_t lLast = it->second;
+
+    if (lFirst == lLast) {
+        m_mapRanges.erase(it);
+    } else if (theValue == lFirst) {
+        m_mapRanges.erase(it);
+        m_mapRanges[theValue + 1] = lLast;
+    } else if (theValue == lLast) {
+        it->second = theValue - 1;
+    } else {
+        it->second = theValue - 1;
+        m_mapRanges[theValue + 1] = lLast;
+    }
+
+    --m_lCount;
+
+    return true;
+}
+
+bool NumRanges::Verify(const int64_t& theValue) const
+{
+    return m_mapRanges.end() != find_range(theValue);
+}
+
+bool NumRanges::At(const std::size_t nIndex, int64_t& lOutput) const
+{
+    std::size_t nSkipped = 0;
+
+    for (auto& it : m_mapRanges) {
+        const std::size_t nSize =
+            static_cast<std::size_t>(it.second - it.first) + 1;
+
+        if (nIndex < nSkipped + nSize) {
+            lOutput = it.first + static_cast<int64_t>(nIndex - nSkipped);
+
+            return true;
+        }
+
+        nSkipped += nSize;
+    }
+
+    return false;
+}
+
+bool NumRanges::Peek(int64_t& lPeek) const
+{
+    if (m_mapRanges.empty()) { return false; }
+
+    lPeek = m_mapRanges.begin()->first;
+
+    return true;
+}
+
+NumRanges::const_iterator NumRanges::begin() const
+{
+    return const_iterator(m_mapRanges.begin(), m_mapRanges.end());
+}
+
+NumRanges::const_iterator NumRanges::end() const
+{
+    return const_iterator(m_mapRanges.end(), m_mapRanges.end());
+}
+
+bool NumRanges::Output(String& strOutput) const
+{
+    bool bFirst = true;
+
+    for (auto& it : m_mapRanges) {
+        const char* szSeparator = bFirst ? "" : ",";
+        bFirst = false;
+
+        if (it.first == it.second) {
+            strOutput.Concatenate("%s%" PRId64, szSeparator, it.first);
+        } else {
+            strOutput.Concatenate(
+                "%s%" PRId64 "-%" PRId64, szSeparator, it.first, it.second);
+        }
+    }
+
+    return !m_mapRanges.empty();
+}
+
+void NumRanges::Release()
+{
+    m_mapRanges.clear();
+    m_lCount = 0;
+}
+
+}  // namespace opentxs
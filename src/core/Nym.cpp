@@ -402,9 +402,7 @@ Item* Nym::GenerateTransactionStatement(const OTTransaction& theOwner)
 #define CLEAR_MAP_AND_DEQUE(the_map)                                           \
     for (auto& it : the_map) {                                                 \
         if ((nullptr != pstrNotaryID) && (str_NotaryID != it.first)) continue; \
-        dequeOfTransNums* pDeque = (it.second);                                \
-        OT_ASSERT(nullptr != pDeque);                                          \
-        if (!(pDeque->empty())) pDeque->clear();                               \
+        it.second.Release();                                                   \
     }
 #endif  // CLEAR_MAP_AND_DEQUE
 
@@ -540,21 +538,10 @@ bool Nym::SetHash(
     return bSuccess;
 }
 
-#ifndef WIPE_MAP_AND_DEQUE
-#define WIPE_MAP_AND_DEQUE(the_map)                                            \
-    while (!the_map.empty()) {                                                 \
-        dequeOfTransNums* pDeque = the_map.begin()->second;                    \
-        OT_ASSERT(nullptr != pDeque);                                          \
-        the_map.erase(the_map.begin());                                        \
-        delete pDeque;                                                         \
-        pDeque = nullptr;                                                      \
-    }
-#endif  // WIPE_MAP_AND_DEQUE
-
 void Nym::ReleaseTransactionNumbers()
 {
-    WIPE_MAP_AND_DEQUE(m_mapTransNum)
-    WIPE_MAP_AND_DEQUE(m_mapIssuedNum)
+    m_mapTransNum.clear();
+    m_mapIssuedNum.clear();
 }
 
 /*
@@ -788,39 +775,15 @@ bool Nym::VerifyGenericNum(
     const String& strNotaryID,
     const int64_t& lTransNum) const
 {
-    std::string strID = strNotaryID.Get();
-
-    // The Pseudonym has a deque of transaction numbers for each servers.
-    // These deques are mapped by Notary ID.
+    // The Pseudonym has a set of transaction numbers for each server, mapped
+    // by Notary ID, and each set stores its numbers as sorted ranges. So this
+    // is two logarithmic lookups rather than a scan.
     //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then find the transaction
-    // number on
-    // that list, and then return true. Else return false.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            if (!(pDeque->empty()))  // there are some numbers for that server
-                                     // ID
-            {
-                // Let's loop through them and see if the culprit is there
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    // Found it!
-                    if (lTransNum == pDeque->at(i)) {
-                        return true;
-                    }
-                }
-            }
-            break;
-        }
-    }
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    return false;
+    if (THE_MAP.end() == it) { return false; }
+
+    return it->second.Verify(lTransNum);
 }
 
 // On the server side: A user has submitted a specific transaction number.
@@ -850,43 +813,11 @@ bool Nym::RemoveGenericNum(
     const String& strNotaryID,
     const int64_t& lTransNum)
 {
-    bool bRetVal = false;
-    std::string strID = strNotaryID.Get();
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    // The Pseudonym has a deque of transaction numbers for each servers.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then find the transaction
-    // number on
-    // that list, and then remove it, and return true. Else return false.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-
-            OT_ASSERT(nullptr != pDeque);
-
-            if (!(pDeque->empty()))  // there are some numbers for that server
-                                     // ID
-            {
-                // Let's loop through them and see if the culprit is there
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    // Found it!
-                    if (lTransNum == pDeque->at(i)) {
-                        pDeque->erase(pDeque->begin() + i);
-                        bRetVal = true;
-                        break;
-                    }
-                }
-            }
-            break;
-        }
-    }
+    if (THE_MAP.end() == it) { return false; }
 
-    return bRetVal;
+    return it->second.Remove(lTransNum);
 }
 
 // No signer needed for this one, and save is false.
@@ -896,51 +827,11 @@ bool Nym::AddGenericNum(
     const String& strNotaryID,
     int64_t lTransNum)
 {
-    bool bSuccessFindingNotaryID = false, bSuccess = false;
-    std::string strID = strNotaryID.Get();
-
-    // The Pseudonym has a deque of transaction numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then add the transaction
-    // number.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            auto iter = std::find(pDeque->begin(), pDeque->end(), lTransNum);
-
-            if (iter ==
-                pDeque->end())  // Only add it if it's not already there.
-                                // No duplicates!
-                pDeque->push_front(lTransNum);
-
-            bSuccess = true;
-            bSuccessFindingNotaryID = true;
-
-            break;
-        }
-    }
-
-    // Apparently there is not yet a deque stored for this specific notaryID.
-    // Fine. Let's create it then, and then add the transaction num to that new
-    // deque.
-    if (!bSuccessFindingNotaryID) {
-        dequeOfTransNums* pDeque = new dequeOfTransNums;
-
-        OT_ASSERT(nullptr != pDeque);
-
-        THE_MAP[strID] = pDeque;
-        pDeque->push_front(lTransNum);
-        bSuccess = true;
-    }
+    // If there is not yet a set stored for this specific notaryID, this
+    // creates it. Duplicates are ignored.
+    THE_MAP[strNotaryID.Get()].Add(lTransNum);
 
-    return bSuccess;
+    return true;
 }
 
 // Returns count of transaction numbers available for a given server.
@@ -949,39 +840,15 @@ int32_t Nym::GetGenericNumCount(
     const mapOfTransNums& THE_MAP,
     const Identifier& theNotaryID) const
 {
-    int32_t nReturnValue = 0;
-
     const String strNotaryID(theNotaryID);
-    std::string strID = strNotaryID.Get();
-
-    dequeOfTransNums* pDeque = nullptr;
-
-    // The Pseudonym has a deque of transaction numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then we found the right server.
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            break;
-        }
-    }
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    // We found the right server, so let's count the transaction numbers
-    // that this nym has already stored for it.
-    if (nullptr != pDeque) {
-        nReturnValue = static_cast<int32_t>(pDeque->size());
-    }
+    if (THE_MAP.end() == it) { return 0; }
 
-    return nReturnValue;
+    return static_cast<int32_t>(it->second.Count());
 }
 
-// by index.
+// by index. (Numbers are indexed in ascending order.)
 int64_t Nym::GetGenericNum(
     const mapOfTransNums& THE_MAP,
     const Identifier& theNotaryID,
@@ -990,35 +857,10 @@ int64_t Nym::GetGenericNum(
     int64_t lRetVal = 0;
 
     const String strNotaryID(theNotaryID);
-    std::string strID = strNotaryID.Get();
+    auto it = THE_MAP.find(strNotaryID.Get());
 
-    // The Pseudonym has a deque of numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // maps matches the Notary ID that was passed in, then find the number on
-    // that list, and then return it.
-    //
-    for (auto& it : THE_MAP) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
-
-            if (!(pDeque->empty()))  // there are some numbers for that server
-                                     // ID
-            {
-                // Let's loop through them and see if the culprit is there
-                for (uint32_t i = 0; i < pDeque->size(); i++) {
-                    // Found it!
-                    if (static_cast<uint32_t>(nIndex) == i) {
-                        lRetVal = pDeque->at(i);  // <==== Got the number here.
-                        break;
-                    }
-                }
-            }
-            break;
-        }
+    if ((THE_MAP.end() != it) && (0 <= nIndex)) {
+        it->second.At(static_cast<std::size_t>(nIndex), lRetVal);
     }
 
     return lRetVal;
@@ -1203,18 +1045,16 @@ void Nym::HarvestTransactionNumbers(
 
     for (auto& it : theOtherNym.GetMapIssuedNum()) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        OT_ASSERT(nullptr != pDeque);
+        const NumRanges& theNumbers = it.second;
 
         String OTstrNotaryID = strNotaryID.c_str();
         const Identifier theTempID(OTstrNotaryID);
 
-        if (!(pDeque->empty()) &&
+        if (!(theNumbers.empty()) &&
             (theNotaryID == theTempID))  // only for the matching notaryID.
         {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+            for (const auto& lNumber : theNumbers) {
+                lTransactionNumber = lNumber;
 
                 // If number wasn't already on issued list, then add to BOTH
                 // lists. Otherwise do nothing (it's already on the issued list,
@@ -1305,17 +1145,15 @@ void Nym::HarvestIssuedNumbers(
 
     for (auto& it : theOtherNym.GetMapIssuedNum()) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        OT_ASSERT(nullptr != pDeque);
+        const NumRanges& theNumbers = it.second;
 
         String OTstrNotaryID =
             ((strNotaryID.size()) > 0 ? strNotaryID.c_str() : "");
         const Identifier theTempID(OTstrNotaryID);
 
-        if (!(pDeque->empty()) && (theNotaryID == theTempID)) {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+        if (!(theNumbers.empty()) && (theNotaryID == theTempID)) {
+            for (const auto& lNumber : theNumbers) {
+                lTransactionNumber = lNumber;
 
                 // If number wasn't already on issued list, then add to BOTH
                 // lists.
@@ -1385,32 +1223,18 @@ bool Nym::GetNextTransactionNum(
     bool bSave)
 {
     bool bRetVal = false;
-    std::string strID = strNotaryID.Get();
 
-    // The Pseudonym has a deque of transaction numbers for each server.
-    // These deques are mapped by Notary ID.
-    //
-    // So let's loop through all the deques I have, and if the server ID on the
-    // map
-    // matches the Notary ID that was passed in, then send out the transaction
-    // number.
+    // The Pseudonym has a set of transaction numbers for each server, mapped
+    // by Notary ID. Send out the lowest number for the Notary ID that was
+    // passed in.
     //
-    for (auto& it : m_mapTransNum) {
-        // if the NotaryID passed in matches the notaryID for the current deque
-        if (strID == it.first) {
-            dequeOfTransNums* pDeque = (it.second);
-            OT_ASSERT(nullptr != pDeque);
+    auto it = m_mapTransNum.find(strNotaryID.Get());
 
-            if (!(pDeque->empty())) {
-                lTransNum = pDeque->back();
+    if ((m_mapTransNum.end() != it) && it->second.Peek(lTransNum)) {
+        it->second.Remove(lTransNum);
 
-                pDeque->pop_back();
-
-                // The call has succeeded
-                bRetVal = true;
-            }
-            break;
-        }
+        // The call has succeeded
+        bRetVal = true;
     }
 
     if (bRetVal && bSave) {
@@ -1550,20 +1374,19 @@ void Nym::DisplayStatistics(String& strOutput)
 {
     for (auto& it : m_mapIssuedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        OT_ASSERT(nullptr != pDeque);
+        const NumRanges& theNumbers = it.second;
 
-        if (!(pDeque->empty())) {
+        if (!(theNumbers.empty())) {
             strOutput.Concatenate(
                 "---- Transaction numbers still signed out from server: %s\n",
                 strNotaryID.c_str());
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                int64_t lTransactionNumber = pDeque->at(i);
+            bool bFirst = true;
 
+            for (const auto& lTransactionNumber : theNumbers) {
                 strOutput.Concatenate(
-                    0 == i ? "%" PRId64 : ", %" PRId64, lTransactionNumber);
+                    bFirst ? "%" PRId64 : ", %" PRId64, lTransactionNumber);
+                bFirst = false;
             }
             strOutput.Concatenate("\n");
         }
@@ -1571,19 +1394,19 @@ void Nym::DisplayStatistics(String& strOutput)
 
     for (auto& it : m_mapTransNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        const NumRanges& theNumbers = it.second;
 
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty())) {
+        if (!(theNumbers.empty())) {
             strOutput.Concatenate(
                 "---- Transaction numbers still usable on server: %s\n",
                 strNotaryID.c_str());
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                int64_t lTransactionNumber = pDeque->at(i);
+            bool bFirst = true;
+
+            for (const auto& lTransactionNumber : theNumbers) {
                 strOutput.Concatenate(
-                    0 == i ? "%" PRId64 : ", %" PRId64, lTransactionNumber);
+                    bFirst ? "%" PRId64 : ", %" PRId64, lTransactionNumber);
+                bFirst = false;
             }
             strOutput.Concatenate("\n");
         }
@@ -1970,24 +1793,15 @@ bool Nym::SavePseudonym(String& strNym)
             "FOR DELETION AT ITS OWN REQUEST");
     }
 
-    int64_t lTransactionNumber = 0;
-
     for (auto& it : m_mapTransNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
-            NumList theList;
+        const NumRanges& theNumbers = it.second;
 
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
-                theList.Add(lTransactionNumber);
-            }
+        if (!(theNumbers.empty()) && (strNotaryID.size() > 0)) {
+            // Stored as ranges ("1-50,52"), so the nymfile grows with the
+            // number of gaps rather than the number of numbers.
             String strTemp;
-            if ((theList.Count() > 0) && theList.Output(strTemp) &&
-                strTemp.Exists()) {
+            if (theNumbers.Output(strTemp) && strTemp.Exists()) {
                 const OTASCIIArmor ascTemp(strTemp);
 
                 if (ascTemp.Exists()) {
@@ -1999,24 +1813,13 @@ bool Nym::SavePseudonym(String& strNym)
         }
     }  // for
 
-    lTransactionNumber = 0;
-
     for (auto& it : m_mapIssuedNum) {
         std::string strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-
-        OT_ASSERT(nullptr != pDeque);
+        const NumRanges& theNumbers = it.second;
 
-        if (!(pDeque->empty()) && (strNotaryID.size() > 0)) {
-            NumList theList;
-
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
-                theList.Add(lTransactionNumber);
-            }
+        if (!(theNumbers.empty()) && (strNotaryID.size() > 0)) {
             String strTemp;
-            if ((theList.Count() > 0) && theList.Output(strTemp) &&
-                strTemp.Exists()) {
+            if (theNumbers.Output(strTemp) && strTemp.Exists()) {
                 const OTASCIIArmor ascTemp(strTemp);
 
                 if (ascTemp.Exists()) {
@@ -2707,22 +2510,14 @@ bool Nym::LoadNymFromString(
                                                  "field without value.\n";
                         return false;  // error condition
                     }
-                    NumList theNumList;
-
-                    if (strTemp.Exists()) theNumList.Add(strTemp);
-
-                    int64_t lTemp = 0;
-                    while (theNumList.Peek(lTemp)) {
-                        theNumList.Pop();
-
-                        otLog3 << "Transaction Number " << lTemp
+                    // Accepts both the range encoding and the older plain
+                    // comma-separated list. (Doesn't save to disk. Why save
+                    // to disk AS WE'RE LOADING?)
+                    if (strTemp.Exists() &&
+                        m_mapTransNum[tempNotaryID.Get()].Add(strTemp)) {
+                        otLog3 << "Transaction Numbers " << strTemp
                                << " ready-to-use for NotaryID: " << tempNotaryID
                                << "\n";
-                        AddTransactionNum(tempNotaryID, lTemp);  // This version
-                        // doesn't save to
-                        // disk. (Why save
-                        // to disk AS WE'RE
-                        // LOADING?)
                     }
                 } else if (strNodeName.Compare("issuedNums")) {
                     const String tempNotaryID =
@@ -2734,21 +2529,13 @@ bool Nym::LoadNymFromString(
                               << ": Error: issuedNums field without value.\n";
                         return false;  // error condition
                     }
-                    NumList theNumList;
-
-                    if (strTemp.Exists()) theNumList.Add(strTemp);
-
-                    int64_t lTemp = 0;
-                    while (theNumList.Peek(lTemp)) {
-                        theNumList.Pop();
-
-                        otLog3 << "Currently liable for issued trans# " << lTemp
-                               << " at NotaryID: " << tempNotaryID << "\n";
-                        AddIssuedNum(
-                            tempNotaryID, lTemp);  // This version doesn't
-                                                   // save to disk. (Why
-                                                   // save to disk AS WE'RE
-                                                   // LOADING?)
+                    // Accepts both the range encoding and the older plain
+                    // comma-separated list. (Doesn't save to disk.)
+                    if (strTemp.Exists() &&
+                        m_mapIssuedNum[tempNotaryID.Get()].Add(strTemp)) {
+                        otLog3 << "Currently liable for issued trans# "
+                               << strTemp << " at NotaryID: " << tempNotaryID
+                               << "\n";
                     }
                 } else if (strNodeName.Compare("tentativeNums")) {
                     const String tempNotaryID =
@@ -3165,12 +2952,11 @@ bool Nym::VerifyIssuedNumbersOnNym(Nym& THE_NYM)
     // numbers total he has...
     //
     for (auto& it : GetMapIssuedNum()) {
-        dequeOfTransNums* pDeque = (it.second);
-        OT_ASSERT(nullptr != pDeque);
+        const NumRanges& theNumbers = it.second;
 
-        if (!(pDeque->empty())) {
+        if (!(theNumbers.empty())) {
             nNumberOfTransactionNumbers1 +=
-                static_cast<int32_t>(pDeque->size());
+                static_cast<int32_t>(theNumbers.Count());
         }
     }  // for
 
@@ -3180,14 +2966,13 @@ bool Nym::VerifyIssuedNumbersOnNym(Nym& THE_NYM)
     //
     for (auto& it : THE_NYM.GetMapIssuedNum()) {
         strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
-        OT_ASSERT(nullptr != pDeque);
+        const NumRanges& theNumbers = it.second;
 
         String OTstrNotaryID = strNotaryID.c_str();
 
-        if (!(pDeque->empty())) {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+        if (!(theNumbers.empty())) {
+            for (const auto& lNumber : theNumbers) {
+                lTransactionNumber = lNumber;
 
                 //                if ()
                 {
@@ -3251,15 +3036,13 @@ bool Nym::VerifyTransactionStatementNumbersOnNym(Nym& THE_NYM)  // THE_NYM is
     //
     for (auto& it : GetMapIssuedNum()) {
         strNotaryID = it.first;
-        dequeOfTransNums* pDeque = it.second;
+        const NumRanges& theNumbers = it.second;
 
         String OTstrNotaryID = strNotaryID.c_str();
 
-        OT_ASSERT(nullptr != pDeque);
-
-        if (!(pDeque->empty())) {
-            for (uint32_t i = 0; i < pDeque->size(); i++) {
-                lTransactionNumber = pDeque->at(i);
+        if (!(theNumbers.empty())) {
+            for (const auto& lNumber : theNumbers) {
+                lTransactionNumber = lNumber;
 
                 if (false ==
                     THE_NYM.VerifyIssuedNum(
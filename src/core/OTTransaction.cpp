@@ -71,6 +71,7 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace opentxs
@@ -3170,9 +3171,11 @@ bool OTTransaction::VerifyItems(Nym& theNym)
     // items
     // and the transaction both have the same owner: Nym.
 
-    // if pointer not null, and it's a withdrawal, and it's an acknowledgement
-    // (not a rejection or error)
+    // The cheap checks run first, so the signatures are only checked once all
+    // the items are known to belong here.
     //
+    std::vector<const Contract*> items;
+
     for (auto& it : GetItemList()) {
         // loop through the ALL items that make up this transaction and check
         // to see if a response to deposit.
@@ -3183,16 +3186,14 @@ bool OTTransaction::VerifyItems(Nym& theNym)
 
         if (NYM_ID != pItem->GetNymID()) return false;
 
-        if (!pItem->VerifySignature(theNym)) // NO need to call
-                                             // VerifyAccount since
-                                             // VerifyContractID is
-                                             // ALREADY called and now
-                                             // here's
-                                             // VerifySignature().
-            return false;
+        items.push_back(pItem);
     }
 
-    return true;
+    // NO need to call VerifyAccount since VerifyContractID is ALREADY called
+    // and now here's VerifySignature(), for all the items at once.
+    std::vector<bool> verified;
+
+    return Contract::VerifySignatures(items, theNym, verified);
 }
 
 /*
@@ -3464,6 +3465,103 @@ void OTTransaction::Release()
     }
 
     OTTransactionType::Release();
+    ReleaseReferenceCache();
+}
+
+void OTTransaction::ReleaseReferenceCache()
+{
+    m_pReferenceItem.reset();
+    m_pReferenceCheque.reset();
+    m_pReferenceCronItem.reset();
+    m_bReferenceItemLoaded = false;
+    m_bReferenceChequeLoaded = false;
+    m_bReferenceCronItemLoaded = false;
+    m_lReferenceCacheRevision = m_lReferenceRevision;
+}
+
+void OTTransaction::ValidateReferenceCache(const Identifier& theNotaryID)
+{
+    if (m_lReferenceCacheRevision != m_lReferenceRevision) {
+        ReleaseReferenceCache();
+    }
+
+    // The item (and so the cheque attached to it) was verified against a
+    // particular notary. Asked about a different one, verify it again.
+    if (m_ReferenceCacheNotaryID != theNotaryID) {
+        m_pReferenceItem.reset();
+        m_pReferenceCheque.reset();
+        m_bReferenceItemLoaded = false;
+        m_bReferenceChequeLoaded = false;
+        m_ReferenceCacheNotaryID = theNotaryID;
+    }
+}
+
+const Item* OTTransaction::GetReferenceItem(const Identifier& theNotaryID)
+{
+    ValidateReferenceCache(theNotaryID);
+
+    if (!m_bReferenceItemLoaded) {
+        m_bReferenceItemLoaded = true;
+
+        String strReference;
+        GetReferenceString(strReference);
+
+        if (strReference.Exists()) {
+            m_pReferenceItem.reset(Item::CreateItemFromString(
+                strReference, theNotaryID, GetReferenceToNum()));
+
+            if (m_pReferenceItem) { m_pReferenceItem->GetNumberOfOrigin(); }
+        }
+    }
+
+    return m_pReferenceItem.get();
+}
+
+Cheque* OTTransaction::GetReferenceCheque(const Identifier& theNotaryID)
+{
+    const Item* pOriginalItem = GetReferenceItem(theNotaryID);
+
+    if (!m_bReferenceChequeLoaded) {
+        m_bReferenceChequeLoaded = true;
+
+        if ((nullptr != pOriginalItem) &&
+            (Item::depositCheque == pOriginalItem->GetType())) {
+            String strAttachment;
+            pOriginalItem->GetAttachment(strAttachment);
+
+            std::unique_ptr<Cheque> pCheque(new Cheque);
+
+            if (pCheque->LoadContractFromString(strAttachment)) {
+                m_pReferenceCheque = std::move(pCheque);
+            }
+            else {
+                otErr << "OTTransaction::" << __FUNCTION__
+                      << ": ERROR loading cheque or voucher from string.\n";
+            }
+        }
+    }
+
+    return m_pReferenceCheque.get();
+}
+
+OTCronItem* OTTransaction::GetReferenceCronItem()
+{
+    if (m_lReferenceCacheRevision != m_lReferenceRevision) {
+        ReleaseReferenceCache();
+    }
+
+    if (!m_bReferenceCronItemLoaded) {
+        m_bReferenceCronItemLoaded = true;
+
+        String strReference;
+        GetReferenceString(strReference);
+
+        if (strReference.Exists()) {
+            m_pReferenceCronItem.reset(OTCronItem::NewCronItem(strReference));
+        }
+    }
+
+    return m_pReferenceCronItem.get();
 }
 
 // You have to allocate the item on the heap and then pass it in as a reference.
@@ -4214,6 +4312,8 @@ int32_t OTTransaction::ProcessXMLNode(irr::io::IrrXMLReader*& xml)
         return 1;
     }
     else if (!strcmp("inReferenceTo", xml->getNodeName())) {
+        ++m_lReferenceRevision;
+
         if (false == Contract::LoadEncodedTextField(xml, m_ascInReferenceTo)) {
             otErr << "Error in OTTransaction::ProcessXMLNode: inReferenceTo "
                      "field without value.\n";
@@ -5477,8 +5577,7 @@ int64_t OTTransaction::GetReceiptAmount()
 
     int64_t lAdjustment = 0;
 
-    Item* pOriginalItem = nullptr;
-    std::unique_ptr<Item> theItemAngel;
+    const Item* pOriginalItem = nullptr;
 
     switch (GetType()) { // These are the types that have an amount (somehow)
     case OTTransaction::marketReceipt: // amount is stored on ** marketReceipt
@@ -5507,13 +5606,7 @@ int64_t OTTransaction::GetReceiptAmount()
     case OTTransaction::transferReceipt: // amount is stored on ** acceptPending
                                          // ITEM **, (here as reference string.)
         {
-            String strReference;
-            GetReferenceString(strReference);
-
-            pOriginalItem = Item::CreateItemFromString(
-                strReference, GetPurportedNotaryID(), GetReferenceToNum());
-
-            if (nullptr != pOriginalItem) theItemAngel.reset(pOriginalItem);
+            pOriginalItem = GetReferenceItem(GetPurportedNotaryID());
 
             break;
         }
@@ -5544,23 +5637,16 @@ int64_t OTTransaction::GetReceiptAmount()
                 return 0;
             }
 
-            String strAttachment;
-            Cheque theCheque;
-
             // Get the cheque from the Item and load it up into a Cheque object.
-            pOriginalItem->GetAttachment(strAttachment);
-            bool bLoadContractFromString =
-                theCheque.LoadContractFromString(strAttachment);
-
-            if (!bLoadContractFromString) {
-                String strCheque(theCheque);
+            const Cheque* pCheque = GetReferenceCheque(GetPurportedNotaryID());
 
+            if (nullptr == pCheque) {
                 otErr << "ERROR loading cheque from string in OTTransaction::"
-                      << __FUNCTION__ << ":\n" << strCheque << "\n";
+                      << __FUNCTION__ << "\n";
             }
             else {
                 lAdjustment =
-                    (theCheque.GetAmount() * (-1)); // a cheque reduces my
+                    (pCheque->GetAmount() * (-1)); // a cheque reduces my
                                                     // balance, unless
                                                     // it's negative.
             } // So if I wrote a 100 clam cheque, that  means -100 hit my
@@ -5754,9 +5840,6 @@ void OTTransaction::CalculateNumberOfOrigin()
     case voucherReceipt: // the server drops this into your inbox, when someone
                          // deposits your voucher.
         {
-            String strReference;
-            GetReferenceString(strReference);
-
             // "In reference to" is the depositor's trans#, which I use here to
             // load
             // the depositor's
@@ -5765,8 +5848,8 @@ void OTTransaction::CalculateNumberOfOrigin()
             // number of origin
             // as its transaction number.
             //
-            std::unique_ptr<Item> pOriginalItem(Item::CreateItemFromString(
-                strReference, GetPurportedNotaryID(), GetReferenceToNum()));
+            const Item* pOriginalItem =
+                GetReferenceItem(GetPurportedNotaryID());
             OT_ASSERT(nullptr != pOriginalItem);
 
             if (Item::depositCheque != pOriginalItem->GetType()) {
@@ -5779,7 +5862,7 @@ void OTTransaction::CalculateNumberOfOrigin()
                 return;
             }
 
-            SetNumberOfOrigin(pOriginalItem->GetNumberOfOrigin());
+            SetNumberOfOrigin(pOriginalItem->GetRawNumberOfOrigin());
         }
         break;
 
@@ -5894,31 +5977,26 @@ int64_t OTTransaction::GetReferenceNumForDisplay()
     case OTTransaction::finalReceipt: {
         lReferenceNum = GetReferenceToNum();
 
-        String strRef;
-        GetReferenceString(strRef);
-        if (strRef.Exists())
-        {
-            std::unique_ptr<OTCronItem> pCronItem(OTCronItem::NewCronItem(strRef));
+        OTCronItem* pCronItem = GetReferenceCronItem();
 
-            if (pCronItem)
-            {
-                lReferenceNum = pCronItem->GetTransactionNum();
-                // -------------------------------------------
-                OTPaymentPlan   * pPlan          = dynamic_cast<OTPaymentPlan  *>(pCronItem.get());
-                OTSmartContract * pSmartContract = dynamic_cast<OTSmartContract*>(pCronItem.get());
+        if (pCronItem)
+        {
+            lReferenceNum = pCronItem->GetTransactionNum();
+            // -------------------------------------------
+            OTPaymentPlan   * pPlan          = dynamic_cast<OTPaymentPlan  *>(pCronItem);
+            OTSmartContract * pSmartContract = dynamic_cast<OTSmartContract*>(pCronItem);
 
-                if (nullptr != pPlan) {
-                    lReferenceNum = pPlan->GetRecipientOpeningNum();
-                }
-                else if (nullptr != pSmartContract) {
-                    const std::vector<int64_t> & openingNumsInOrderOfSigning =
-                        pSmartContract->openingNumsInOrderOfSigning();
+            if (nullptr != pPlan) {
+                lReferenceNum = pPlan->GetRecipientOpeningNum();
+            }
+            else if (nullptr != pSmartContract) {
+                const std::vector<int64_t> & openingNumsInOrderOfSigning =
+                    pSmartContract->openingNumsInOrderOfSigning();
 
-                    if (openingNumsInOrderOfSigning.size() > 0)
-                    lReferenceNum = openingNumsInOrderOfSigning[0];
-                }
-                // -------------------------------------------
+                if (openingNumsInOrderOfSigning.size() > 0)
+                lReferenceNum = openingNumsInOrderOfSigning[0];
             }
+            // -------------------------------------------
         }
         } break;
 
@@ -5989,8 +6067,7 @@ bool OTTransaction::GetSenderNymIDForDisplay(Identifier& theReturnID)
 
     bool bSuccess = false;
 
-    Item* pOriginalItem = nullptr;
-    std::unique_ptr<Item> theItemAngel;
+    const Item* pOriginalItem = nullptr;
 
     String strReference;
     GetReferenceString(strReference);
@@ -6149,10 +6226,7 @@ bool OTTransaction::GetSenderNymIDForDisplay(Identifier& theReturnID)
     case OTTransaction::pending:
     case OTTransaction::chequeReceipt:
     case OTTransaction::voucherReceipt: {
-        pOriginalItem = Item::CreateItemFromString(
-            strReference, GetPurportedNotaryID(), GetReferenceToNum());
-
-        if (nullptr != pOriginalItem) theItemAngel.reset(pOriginalItem);
+        pOriginalItem = GetReferenceItem(GetPurportedNotaryID());
 
         break;
     }
@@ -6183,26 +6257,18 @@ bool OTTransaction::GetSenderNymIDForDisplay(Identifier& theReturnID)
                 return false;
             }
 
-            Cheque theCheque;
-            String strAttachment;
-
             // Get the cheque from the Item and load it up into a Cheque object.
-            pOriginalItem->GetAttachment(strAttachment);
-            bool bLoadContractFromString =
-                theCheque.LoadContractFromString(strAttachment);
-
-            if (!bLoadContractFromString) {
-                String strCheque(theCheque);
+            const Cheque* pCheque = GetReferenceCheque(GetPurportedNotaryID());
 
+            if (nullptr == pCheque) {
                 otErr << "ERROR loading cheque or voucher from string in "
-                         "OTTransaction::" << __FUNCTION__ << ":\n" << strCheque
-                      << "\n";
+                         "OTTransaction::" << __FUNCTION__ << "\n";
             }
             else {
                 if (OTTransaction::chequeReceipt == GetType())
-                    theReturnID = theCheque.GetSenderNymID();
+                    theReturnID = pCheque->GetSenderNymID();
                 else
-                    theReturnID = theCheque.GetRemitterNymID();
+                    theReturnID = pCheque->GetRemitterNymID();
 
                 bSuccess = true;
             }
@@ -6232,8 +6298,7 @@ bool OTTransaction::GetRecipientNymIDForDisplay(Identifier& theReturnID)
 
     bool bSuccess = false;
 
-    Item * pOriginalItem = nullptr;
-    std::unique_ptr<Item> theItemAngel;
+    const Item* pOriginalItem = nullptr;
 
     String strReference;
     GetReferenceString(strReference);
@@ -6387,10 +6452,7 @@ bool OTTransaction::GetRecipientNymIDForDisplay(Identifier& theReturnID)
     case OTTransaction::transferReceipt:
     case OTTransaction::chequeReceipt:
     case OTTransaction::voucherReceipt: {
-        pOriginalItem = Item::CreateItemFromString(
-            strReference, GetPurportedNotaryID(), GetReferenceToNum());
-
-        if (nullptr != pOriginalItem) theItemAngel.reset(pOriginalItem);
+        pOriginalItem = GetReferenceItem(GetPurportedNotaryID());
 
         break;
     }
@@ -6434,24 +6496,17 @@ bool OTTransaction::GetRecipientNymIDForDisplay(Identifier& theReturnID)
                 return false;
             }
 
-            Cheque theCheque;
-            String strAttachment;
-
             // Get the cheque from the Item and load it up into a Cheque object.
-            pOriginalItem->GetAttachment(strAttachment);
-            bool bLoadContractFromString = theCheque.LoadContractFromString(strAttachment);
+            const Cheque* pCheque = GetReferenceCheque(GetPurportedNotaryID());
 
-            if (!bLoadContractFromString)
+            if (nullptr == pCheque)
             {
-                String strCheque(theCheque);
-
                 otErr << "ERROR loading cheque or voucher from string in "
-                         "OTTransaction::" << __FUNCTION__ << ":\n" << strCheque
-                      << "\n";
+                         "OTTransaction::" << __FUNCTION__ << "\n";
             }
-            else if (theCheque.HasRecipient())
+            else if (pCheque->HasRecipient())
             {
-                theReturnID = theCheque.GetRecipientNymID();
+                theReturnID = pCheque->GetRecipientNymID();
                 bSuccess = true;
             }
             else
@@ -6476,8 +6531,7 @@ bool OTTransaction::GetSenderAcctIDForDisplay(Identifier& theReturnID)
 
     bool bSuccess = false;
 
-    Item* pOriginalItem = nullptr;
-    std::unique_ptr<Item> theItemAngel;
+    const Item* pOriginalItem = nullptr;
 
     String strReference;
     GetReferenceString(strReference);
@@ -6531,10 +6585,7 @@ bool OTTransaction::GetSenderAcctIDForDisplay(Identifier& theReturnID)
     case OTTransaction::voucherReceipt: // amount is stored on voucher (attached
                                         // to depositCheque item, attached.)
         {
-            pOriginalItem = Item::CreateItemFromString(
-                strReference, GetPurportedNotaryID(), GetReferenceToNum());
-
-            if (nullptr != pOriginalItem) theItemAngel.reset(pOriginalItem);
+            pOriginalItem = GetReferenceItem(GetPurportedNotaryID());
 
             break;
         }
@@ -6564,25 +6615,18 @@ bool OTTransaction::GetSenderAcctIDForDisplay(Identifier& theReturnID)
                 return false;
             }
 
-            Cheque theCheque;
-            String strAttachment;
-
             // Get the cheque from the Item and load it up into a Cheque object.
-            pOriginalItem->GetAttachment(strAttachment);
-            bool bLoadContractFromString =
-                theCheque.LoadContractFromString(strAttachment);
-
-            if (!bLoadContractFromString) {
-                String strCheque(theCheque);
+            const Cheque* pCheque = GetReferenceCheque(GetPurportedNotaryID());
 
+            if (nullptr == pCheque) {
                 otErr << "ERROR loading cheque from string in OTTransaction::"
-                      << __FUNCTION__ << ":\n" << strCheque << "\n";
+                      << __FUNCTION__ << "\n";
             }
             else {
                 if (OTTransaction::chequeReceipt == GetType())
-                    theReturnID = theCheque.GetSenderAcctID();
+                    theReturnID = pCheque->GetSenderAcctID();
                 else
-                    theReturnID = theCheque.GetRemitterAcctID();
+                    theReturnID = pCheque->GetRemitterAcctID();
 
                 bSuccess = true;
             }
@@ -6613,8 +6657,7 @@ bool OTTransaction::GetRecipientAcctIDForDisplay(Identifier& theReturnID)
 
     bool bSuccess = false;
 
-    Item* pOriginalItem = nullptr;
-    std::unique_ptr<Item> theItemAngel;
+    const Item* pOriginalItem = nullptr;
 
     String strReference;
     GetReferenceString(strReference);
@@ -6666,10 +6709,7 @@ bool OTTransaction::GetRecipientAcctIDForDisplay(Identifier& theReturnID)
     case OTTransaction::transferReceipt:
     case OTTransaction::chequeReceipt:
     case OTTransaction::voucherReceipt: {
-        pOriginalItem = Item::CreateItemFromString(
-            strReference, GetPurportedNotaryID(), GetReferenceToNum());
-
-        if (nullptr != pOriginalItem) theItemAngel.reset(pOriginalItem);
+        pOriginalItem = GetReferenceItem(GetPurportedNotaryID());
 
         break;
     }
@@ -6743,8 +6783,7 @@ bool OTTransaction::GetMemo(String& strMemo)
 
     bool bSuccess = false;
 
-    Item* pOriginalItem = nullptr;
-    std::unique_ptr<Item> theItemAngel;
+    const Item* pOriginalItem = nullptr;
 
     String strReference;
     GetReferenceString(strReference);
@@ -6797,10 +6836,7 @@ bool OTTransaction::GetMemo(String& strMemo)
     case OTTransaction::transferReceipt:
     case OTTransaction::chequeReceipt:
     case OTTransaction::voucherReceipt: {
-        pOriginalItem = Item::CreateItemFromString(
-            strReference, GetPurportedNotaryID(), GetReferenceToNum());
-
-        if (nullptr != pOriginalItem) theItemAngel.reset(pOriginalItem);
+        pOriginalItem = GetReferenceItem(GetPurportedNotaryID());
 
         break;
     }
@@ -6835,20 +6871,16 @@ bool OTTransaction::GetMemo(String& strMemo)
             return false;
         }
         else {
-            Cheque theCheque;
-            String strCheque;
-            pOriginalItem->GetAttachment(strCheque);
+            const Cheque* pCheque = GetReferenceCheque(GetPurportedNotaryID());
 
-            if (!((strCheque.GetLength() > 2) &&
-                  theCheque.LoadContractFromString(strCheque))) {
+            if (nullptr == pCheque) {
                 otErr << __FUNCTION__
-                      << ": Error loading cheque or voucher from string:\n"
-                      << strCheque << "\n";
+                      << ": Error loading cheque or voucher from string.\n";
                 return false;
             }
 
             // Success loading the cheque.
-            strMemo = theCheque.GetMemo();
+            strMemo = pCheque->GetMemo();
             bSuccess = strMemo.Exists();
         }
     } break;
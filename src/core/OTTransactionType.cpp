@@ -296,6 +296,7 @@ void OTTransactionType::Release_TransactionType()
 
     m_ascInReferenceTo.Release(); // This item may be in reference to a
                                   // different item
+    ++m_lReferenceRevision;
 
     // This was causing OTLedger to fail loading. Can't set this to true until the END
     // of loading. Todo: Starting reading the END TAGS during load. For example, the OTLedger
@@ -336,6 +337,7 @@ void OTTransactionType::GetReferenceString(String& theStr) const
 void OTTransactionType::SetReferenceString(const String& theStr)
 {
     m_ascInReferenceTo.SetString(theStr);
+    ++m_lReferenceRevision;
 }
 
 // Make sure this contract checks out. Very high level.
@@ -473,6 +475,7 @@ int64_t OTTransactionType::GetReferenceToNum() const
 void OTTransactionType::SetReferenceToNum(int64_t lTransactionNum)
 {
     m_lInReferenceToTransaction = lTransactionNum;
+    ++m_lReferenceRevision;
 }
 
 } // namespace opentxs
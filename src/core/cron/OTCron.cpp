@@ -63,6 +63,7 @@
 #include <ostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace opentxs
 {
@@ -610,12 +611,32 @@ void OTCron::ProcessCronItems()
         return;
     }
     bool bNeedToSave = false;
+    const time64_t tNow = OTTimeGetCurrentTime();
 
-    // loop through the cron items and tell each one to ProcessCron().
+    // Take every item which is due off the schedule. Items which stay on Cron
+    // are put back according to their next process date.
+    std::vector<int64_t> dueItems;
+
+    for (auto it = m_multimapSchedule.begin();
+         (it != m_multimapSchedule.end()) && (it->first <= tNow);) {
+        dueItems.push_back(it->second);
+        m_mapSchedule.erase(it->second);
+        it = m_multimapSchedule.erase(it);
+    }
+
+    // loop through the due cron items and tell each one to ProcessCron().
     // If the item returns true, that means leave it on the list. Otherwise,
     // if it returns false, that means "it's done: remove it."
-    for (auto it = m_multimapCronItems.begin();
-         it != m_multimapCronItems.end();) {
+    for (auto due = dueItems.begin(); due != dueItems.end(); ++due) {
+        auto it_map = FindItemOnMap(*due);
+
+        if (m_mapCronItems.end() == it_map) {
+            continue;
+        }
+
+        OTCronItem* pItem = it_map->second;
+        OT_ASSERT(nullptr != pItem);
+
         if (GetTransactionCount() <= nTwentyPercent) {
             otErr << "WARNING: Cron has fewer than 20 percent of its normal "
                      "transaction "
@@ -628,24 +649,33 @@ void OTCron::ProcessCronItems()
                   << " were used in the current round alone!!! \n"
                      "SKIPPING THE REMAINDER OF THE CRON ITEMS THAT WERE "
                      "SCHEDULED FOR THIS ROUND!!!\n\n";
+
+            // Leave the skipped items due, so they go first next round.
+            for (; due != dueItems.end(); ++due) {
+                auto it_skipped = FindItemOnMap(*due);
+
+                if (m_mapCronItems.end() != it_skipped) {
+                    ScheduleItem(*it_skipped->second, tNow);
+                }
+            }
+
             break;
         }
-        OTCronItem* pItem = it->second;
-        OT_ASSERT(nullptr != pItem);
+
         otInfo << "OTCron::" << __FUNCTION__
                << ": Processing item number: " << pItem->GetTransactionNum()
                << " \n";
 
         if (pItem->ProcessCron()) {
-            it++;
+            ScheduleItem(*pItem, tNow);
             continue;
         }
         pItem->HookRemovalFromCron(nullptr, GetNextTransactionNumber());
         otOut << "OTCron::" << __FUNCTION__
               << ": Removing cron item: " << pItem->GetTransactionNum() << "\n";
-        it = m_multimapCronItems.erase(it);
-        auto it_map = FindItemOnMap(pItem->GetTransactionNum());
-        OT_ASSERT(m_mapCronItems.end() != it_map);
+        auto it_multimap = FindItemOnMultimap(pItem->GetTransactionNum());
+        OT_ASSERT(m_multimapCronItems.end() != it_multimap);
+        m_multimapCronItems.erase(it_multimap);
         m_mapCronItems.erase(it_map);
 
         delete pItem;
@@ -656,6 +686,35 @@ void OTCron::ProcessCronItems()
     if (bNeedToSave) SaveCron();
 }
 
+// Puts the item on the schedule at its next process date, or at tNotBefore if
+// that is later. Items which have never been processed are due immediately.
+void OTCron::ScheduleItem(const OTCronItem& theItem, time64_t tNotBefore)
+{
+    const int64_t lTransactionNum = theItem.GetTransactionNum();
+    UnscheduleItem(lTransactionNum);
+
+    time64_t tDue = theItem.GetNextCronDue();
+
+    if (tDue < tNotBefore) {
+        tDue = tNotBefore;
+    }
+
+    m_mapSchedule[lTransactionNum] = m_multimapSchedule.insert(
+        std::pair<time64_t, int64_t>(tDue, lTransactionNum));
+}
+
+void OTCron::UnscheduleItem(int64_t lTransactionNum)
+{
+    auto it = m_mapSchedule.find(lTransactionNum);
+
+    if (m_mapSchedule.end() == it) {
+        return;
+    }
+
+    m_multimapSchedule.erase(it->second);
+    m_mapSchedule.erase(it);
+}
+
 // OTCron IS responsible for cleaning up theItem, and takes ownership.
 // So make SURE it is allocated on the HEAP before you pass it in here, and
 // also make sure to delete it again if this call fails!
@@ -706,6 +765,8 @@ bool OTCron::AddCronItem(OTCronItem& theItem, Nym* pActivator,
             m_multimapCronItems.upper_bound(tDateAdded),
             std::pair<time64_t, OTCronItem*>(tDateAdded, &theItem));
 
+        ScheduleItem(theItem, OT_TIME_ZERO);
+
         theItem.SetCronPointer(*this);
         theItem.setServerNym(m_pServerNym);
         theItem.setNotaryID(&m_NOTARY_ID);
@@ -795,6 +856,7 @@ bool OTCron::RemoveCronItem(int64_t lTransactionNum,
 
         m_mapCronItems.erase(it_map);           // Remove from MAP.
         m_multimapCronItems.erase(it_multimap); // Remove from MULTIMAP.
+        UnscheduleItem(lTransactionNum);        // Remove from schedule.
 
         delete pItem;
 
@@ -1127,6 +1189,9 @@ void OTCron::Release_Cron()
 {
     // If there were any dynamically allocated objects, clean them up here.
 
+    m_mapSchedule.clear();
+    m_multimapSchedule.clear();
+
     while (!m_multimapCronItems.empty()) {
         auto it = m_multimapCronItems.begin();
         m_multimapCronItems.erase(it);
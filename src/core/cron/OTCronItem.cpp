@@ -681,6 +681,18 @@ bool OTCronItem::CanRemoveItemFromCron(Nym& theNym)
     // dig deeper...
 }
 
+time64_t OTCronItem::GetNextCronDue() const
+{
+    if (GetLastProcessDate() <= OT_TIME_ZERO) {
+        return OT_TIME_ZERO;
+    }
+
+    // Subclasses skip processing while the time since the last process date
+    // is <= the process interval.
+    return OTTimeAddTimeInterval(
+        GetLastProcessDate(), GetProcessInterval() + 1);
+}
+
 // OTCron calls this regularly, which is my chance to expire, etc.
 // Child classes will override this, AND call it (to verify valid date range.)
 //
@@ -40,11 +40,128 @@
 
 #include "opentxs/core/OTData.hpp"
 #include "opentxs/core/String.hpp"
+#include "opentxs/core/crypto/OTAsymmetricKey.hpp"
+#include "opentxs/core/crypto/OTPasswordData.hpp"
 #include "opentxs/core/crypto/OTSignature.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+// Below this many checks per worker, handing work to another thread costs
+// more than it saves.
+const std::size_t OT_VERIFY_BATCH_PER_THREAD = 16;
+
+// Helper threads shared by every VerifyBatch call. Threads are started the
+// first time they are needed and kept until the process exits.
+class VerifyPool
+{
+private:
+    std::mutex run_lock_;
+    std::mutex lock_;
+    std::condition_variable work_;
+    std::condition_variable done_;
+    std::vector<std::thread> threads_;
+    const std::function<void()>* job_{nullptr};
+    std::size_t wanted_{0};
+    std::size_t active_{0};
+    bool shutdown_{false};
+
+    void worker()
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+
+        while (true) {
+            work_.wait(
+                lock, [&]() -> bool { return shutdown_ || (0 < wanted_); });
+
+            if (shutdown_) {
+
+                return;
+            }
+
+            --wanted_;
+            ++active_;
+            const auto* job = job_;
+            lock.unlock();
+            (*job)();
+            lock.lock();
+            --active_;
+
+            if (0 == active_) {
+                done_.notify_all();
+            }
+        }
+    }
+
+public:
+    // Runs job on the calling thread and on up to helpers pool threads, and
+    // returns once every copy has finished. If another batch is already
+    // using the pool, job runs on the calling thread only.
+    void Run(const std::function<void()>& job, const std::size_t helpers)
+    {
+        std::unique_lock<std::mutex> runLock(run_lock_, std::try_to_lock);
+
+        if (!runLock.owns_lock()) {
+            job();
+
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(lock_);
+
+        while (threads_.size() < helpers) {
+            threads_.emplace_back(&VerifyPool::worker, this);
+        }
+
+        job_ = &job;
+        wanted_ = helpers;
+        lock.unlock();
+        work_.notify_all();
+        job();
+        lock.lock();
+        // The work is exhausted, so helpers which have not started yet are
+        // no longer needed.
+        wanted_ = 0;
+        done_.wait(lock, [&]() -> bool { return 0 == active_; });
+        job_ = nullptr;
+    }
+
+    ~VerifyPool()
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        shutdown_ = true;
+        lock.unlock();
+        work_.notify_all();
+
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+};
+}
+
 namespace opentxs
 {
 
+CryptoAsymmetric::Verification::Verification(
+    const OTData& plaintext,
+    const OTAsymmetricKey& key,
+    const OTData& signature,
+    const proto::HashType hashType)
+    : plaintext_(&plaintext)
+    , key_(&key)
+    , signature_(&signature)
+    , hash_type_(hashType)
+{
+}
+
 proto::AsymmetricKeyType CryptoAsymmetric::CurveToKeyType(
     const EcdsaCurve& curve)
 {
@@ -89,6 +206,81 @@ EcdsaCurve CryptoAsymmetric::KeyTypeToCurve(
    return output;
 }
 
+bool CryptoAsymmetric::VerifyBatch(
+    const std::vector<Verification>& batch,
+    std::vector<bool>& output,
+    const std::size_t threads,
+    const OTPasswordData* pPWData)
+{
+    const std::size_t count = batch.size();
+    // std::vector<bool> is bit-packed, so the workers write to bytes instead.
+    std::vector<std::uint8_t> verified(count, 0);
+    std::vector<std::size_t> parallel;
+    parallel.reserve(count);
+    OTPasswordData thePWData("CryptoAsymmetric::VerifyBatch");
+    const OTPasswordData* password =
+        (nullptr != pPWData) ? pPWData : &thePWData;
+
+    auto verify = [&](const std::size_t index) -> void {
+        const Verification& task = batch[index];
+
+        if ((nullptr == task.plaintext_) || (nullptr == task.key_) ||
+            (nullptr == task.signature_)) {
+
+            return;
+        }
+
+        verified[index] = task.key_->engine().Verify(
+            *task.plaintext_,
+            *task.key_,
+            *task.signature_,
+            task.hash_type_,
+            password);
+    };
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const OTAsymmetricKey* key = batch[i].key_;
+
+        // Legacy OpenSSL keys instantiate their EVP_PKEY lazily on first use,
+        // so they can not be shared between workers.
+        if ((nullptr != key) && (proto::AKEYTYPE_LEGACY == key->keyType())) {
+            verify(i);
+        } else {
+            parallel.push_back(i);
+        }
+    }
+
+    std::size_t workers =
+        (0 == threads) ? std::thread::hardware_concurrency() : threads;
+    workers = std::min(workers, parallel.size() / OT_VERIFY_BATCH_PER_THREAD);
+    std::atomic<std::size_t> next(0);
+
+    const std::function<void()> worker = [&]() -> void {
+        for (std::size_t i = next++; i < parallel.size(); i = next++) {
+            verify(parallel[i]);
+        }
+    };
+
+    if (2 > workers) {
+        worker();
+    } else {
+        static VerifyPool pool;
+
+        pool.Run(worker, workers - 1);
+    }
+
+    bool allVerified = true;
+    output.assign(count, false);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        output[i] = (0 != verified[i]);
+
+        if (!output[i]) { allVerified = false; }
+    }
+
+    return allVerified;
+}
+
 bool CryptoAsymmetric::SignContract(
     const String& strContractUnsigned,
     const OTAsymmetricKey& theKey,
@@ -46,74 +46,141 @@
 #endif
 #include "opentxs/core/OTData.hpp"
 
-#include "base64/base64.h"
-
 #include <iostream>
 #include <regex>
 
 namespace opentxs
 {
+namespace
+{
+const char Base64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Maps an input character to its 6 bit value. 64 marks padding, which ends
+// the encoded data, and 65 marks characters which are skipped.
+const std::uint8_t Base64Skip{65};
+const std::uint8_t Base64Pad{64};
+
+struct Base64Table {
+    std::uint8_t value_[256];
+
+    Base64Table()
+    {
+        for (auto& value : value_) {
+            value = Base64Skip;
+        }
+
+        for (std::uint8_t i = 0; i < 64; ++i) {
+            value_[static_cast<std::uint8_t>(Base64Alphabet[i])] = i;
+        }
+
+        value_[static_cast<std::uint8_t>('=')] = Base64Pad;
+    }
+};
+
+const Base64Table Base64Decoding{};
+}  // namespace
 
 CryptoEncodingEngine::CryptoEncodingEngine(CryptoEngine& parent)
     : base58_(*static_cast<CryptoEncoding*>(parent.bitcoincrypto_.get()))
 {
 }
 
+// Encodes in a single pass into a buffer sized for the encoded characters
+// plus a line break after every LineWidth characters.
 std::string CryptoEncodingEngine::Base64Encode(
     const std::uint8_t* inputStart,
     const std::size_t& size) const
 {
     std::string output;
-    output.resize(::Base64encode_len(size));
-    ::Base64encode(
-        const_cast<char*>(output.data()),
-        reinterpret_cast<const char*>(inputStart),
-        size);
 
-    return BreakLines(output);
-}
+    if (0 == size) { return output; }
 
-bool CryptoEncodingEngine::Base64Decode(
-    const std::string&& input,
-    RawData& output) const
-{
-    output.resize(::Base64decode_len(input.data()), 0x0);
+    const std::size_t characters = ((size + 2) / 3) * 4;
+    output.resize(characters + (characters / LineWidth));
+    char* out = &output[0];
+    std::size_t width = 0;
 
-    const size_t decoded = ::Base64decode(
-        reinterpret_cast<char*>(output.data()),
-        input.data());
+    auto write = [&](const char character) -> void {
+        *out++ = character;
 
-    if (0 == decoded) { return false; }
+        if (++width == LineWidth) {
+            *out++ = '\n';
+            width = 0;
+        }
+    };
+
+    std::size_t i = 0;
+
+    for (; (i + 2) < size; i += 3) {
+        const std::uint32_t block = (inputStart[i] << 16) |
+                                    (inputStart[i + 1] << 8) |
+                                    inputStart[i + 2];
+        write(Base64Alphabet[(block >> 18) & 0x3F]);
+        write(Base64Alphabet[(block >> 12) & 0x3F]);
+        write(Base64Alphabet[(block >> 6) & 0x3F]);
+        write(Base64Alphabet[block & 0x3F]);
+    }
+
+    const std::size_t remaining = size - i;
 
-    OT_ASSERT(decoded <= output.size());
+    if (0 < remaining) {
+        std::uint32_t block = inputStart[i] << 16;
 
-    output.resize(decoded);
+        if (2 == remaining) {
+            block |= inputStart[i + 1] << 8;
+        }
+
+        write(Base64Alphabet[(block >> 18) & 0x3F]);
+        write(Base64Alphabet[(block >> 12) & 0x3F]);
+        write((2 == remaining) ? Base64Alphabet[(block >> 6) & 0x3F] : '=');
+        write('=');
+    }
 
-    return true;
+    OT_ASSERT(out == (output.data() + output.size()));
+
+    return output;
 }
 
-std::string CryptoEncodingEngine::BreakLines(const std::string& input) const
+// Decodes in a single pass, skipping line breaks and any other characters
+// outside the base64 alphabet. Decoding stops at the first padding character.
+bool CryptoEncodingEngine::Base64Decode(
+    const std::string& input,
+    RawData& output) const
 {
-    std::string output;
+    output.clear();
+    output.reserve(((input.size() + 3) / 4) * 3);
+    std::uint32_t block = 0;
+    std::size_t count = 0;
 
-    if (0 == input.size()) { return output; }
+    for (const auto& character : input) {
+        const auto value =
+            Base64Decoding.value_[static_cast<std::uint8_t>(character)];
 
-    std::size_t width = 0;
+        if (Base64Skip == value) { continue; }
 
-    for (auto& character : input) {
-        output.push_back(character);
+        if (Base64Pad == value) { break; }
 
-        if (++width >= LineWidth) {
-            output.push_back('\n');
-            width = 0;
+        block = (block << 6) | value;
+
+        if (4 == ++count) {
+            output.push_back(static_cast<std::uint8_t>(block >> 16));
+            output.push_back(static_cast<std::uint8_t>(block >> 8));
+            output.push_back(static_cast<std::uint8_t>(block));
+            block = 0;
+            count = 0;
         }
     }
 
-    if ('\n' != output.back()) {
-        output.push_back('\n');
+    // A single leftover character does not complete a byte and is ignored
+    if (2 == count) {
+        output.push_back(static_cast<std::uint8_t>(block >> 4));
+    } else if (3 == count) {
+        output.push_back(static_cast<std::uint8_t>(block >> 10));
+        output.push_back(static_cast<std::uint8_t>(block >> 2));
     }
 
-    return output;
+    return (0 < output.size());
 }
 
 std::string CryptoEncodingEngine::DataEncode(const std::string& input) const
@@ -134,7 +201,7 @@ std::string CryptoEncodingEngine::DataDecode(const std::string& input) const
 {
     RawData decoded;
 
-    if (Base64Decode(SanatizeBase64(input), decoded)) {
+    if (Base64Decode(input, decoded)) {
 
         return std::string(
             reinterpret_cast<const char*>(decoded.data()), decoded.size());
@@ -213,9 +280,4 @@ std::string CryptoEncodingEngine::SanatizeBase58(const std::string& input)
 {
     return std::regex_replace(input, std::regex("[^1-9A-HJ-NP-Za-km-z]"), "");
 }
-
-std::string CryptoEncodingEngine::SanatizeBase64(const std::string& input)
-{
-    return std::regex_replace(input, std::regex("[^0-9A-Za-z+/=]"), "");
-}
 }  // namespace opentxs
@@ -70,6 +70,28 @@ const char* OT_END_ARMORED_escaped = "- -----END OT ARMORED";
 const char* OT_BEGIN_SIGNED = "-----BEGIN SIGNED";
 const char* OT_BEGIN_SIGNED_escaped = "- -----BEGIN SIGNED";
 
+std::atomic<ArmorCompression> OTASCIIArmor::s_compression{
+    ArmorCompression::BEST};
+
+// static
+void OTASCIIArmor::SetCompression(const ArmorCompression level)
+{
+    s_compression.store(level);
+}
+
+// static
+ArmorCompression OTASCIIArmor::Compression() { return s_compression.load(); }
+
+// static
+ArmorCompression OTASCIIArmor::ParseCompression(const std::string& level)
+{
+    if ("none" == level) { return ArmorCompression::NONE; }
+
+    if ("fast" == level) { return ArmorCompression::FAST; }
+
+    return ArmorCompression::BEST;
+}
+
 // Let's say you don't know if the input string is raw base64, or if it has
 // bookends
 // on it like -----BEGIN BLAH BLAH ...
@@ -195,7 +217,7 @@ OTASCIIArmor& OTASCIIArmor::operator=(const OTASCIIArmor& strValue)
  * the binary data. */
 std::string OTASCIIArmor::compress_string(
     const std::string& str,
-    int32_t compressionlevel = Z_BEST_COMPRESSION) const
+    int32_t compressionlevel) const
 {
     z_stream zs;  // z_stream is zlib's control structure
     memset(&zs, 0, sizeof(zs));
@@ -206,22 +228,14 @@ std::string OTASCIIArmor::compress_string(
     zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(str.data()));
     zs.avail_in = static_cast<uInt>(str.size());  // set the z_stream's input
 
-    int32_t ret;
-    char outbuffer[32768];
+    // deflateBound guarantees a single Z_FINISH call can complete, so the
+    // output is written directly into the string with no intermediate copy
     std::string outstring;
+    outstring.resize(deflateBound(&zs, zs.avail_in));
+    zs.next_out = reinterpret_cast<Bytef*>(&outstring[0]);
+    zs.avail_out = static_cast<uInt>(outstring.size());
 
-    // retrieve the compressed bytes blockwise
-    do {
-        zs.next_out = reinterpret_cast<Bytef*>(outbuffer);
-        zs.avail_out = sizeof(outbuffer);
-
-        ret = deflate(&zs, Z_FINISH);
-
-        if (outstring.size() < zs.total_out) {
-            // append the block to the output string
-            outstring.append(outbuffer, zs.total_out - outstring.size());
-        }
-    } while (ret == Z_OK);
+    int32_t ret = deflate(&zs, Z_FINISH);
 
     deflateEnd(&zs);
 
@@ -231,6 +245,8 @@ std::string OTASCIIArmor::compress_string(
         throw(std::runtime_error(oss.str()));
     }
 
+    outstring.resize(zs.total_out);
+
     return outstring;
 }
 
@@ -247,23 +263,23 @@ std::string OTASCIIArmor::decompress_string(const std::string& str) const
     zs.avail_in = static_cast<uInt>(str.size());
 
     int32_t ret;
-    char outbuffer[32768];
     std::string outstring;
+    outstring.resize(str.size() * 4 + 1024);
 
-    // get the decompressed bytes blockwise using repeated calls to inflate
+    // inflate directly into the string, growing it whenever it fills up
     do {
-        zs.next_out = reinterpret_cast<Bytef*>(outbuffer);
-        zs.avail_out = sizeof(outbuffer);
-
-        ret = inflate(&zs, 0);
-
-        if (outstring.size() < zs.total_out) {
-            outstring.append(outbuffer, zs.total_out - outstring.size());
+        if (zs.total_out == outstring.size()) {
+            outstring.resize(outstring.size() * 2);
         }
 
+        zs.next_out = reinterpret_cast<Bytef*>(&outstring[zs.total_out]);
+        zs.avail_out = static_cast<uInt>(outstring.size() - zs.total_out);
+
+        ret = inflate(&zs, 0);
     } while (ret == Z_OK);
 
     inflateEnd(&zs);
+    outstring.resize(zs.total_out);
 
     if (ret != Z_STREAM_END) {  // an error occurred that was not EOF
         std::ostringstream oss;
@@ -353,7 +369,9 @@ bool OTASCIIArmor::SetString(const String& strData, bool bLineBreaks)  //=true
 
     if (strData.GetLength() < 1) return true;
 
-    std::string str_compressed = compress_string(strData.Get());
+    std::string str_compressed = compress_string(
+        std::string(strData.Get(), strData.GetLength()),
+        static_cast<int32_t>(s_compression.load()));
 
     // "Success"
     if (str_compressed.size() == 0) {
@@ -42,42 +42,17 @@
 #include "opentxs/core/crypto/CryptoEngine.hpp"
 #include "opentxs/core/crypto/CryptoUtil.hpp"
 #include "opentxs/core/crypto/OTPasswordData.hpp"
+#include "opentxs/core/crypto/SecureArena.hpp"
 #include "opentxs/core/util/Assert.hpp"
 #include "opentxs/core/Log.hpp"
 #include "opentxs/core/OTData.hpp"
 #include "opentxs/core/String.hpp"
 
-// For SecureZeroMemory
-#ifdef _WIN32
-#else // not _WIN32
-
-#include <sys/mman.h>
-
-#ifndef PAGESIZE
-#include <unistd.h>
-
 #include <stdint.h>
 #include <cstring>
 #include <ostream>
 #include <string>
 
-#define PAGESIZE sysconf(_SC_PAGESIZE)
-#endif
-
-// FT: Credit to the Bitcoin team for the mlock / munlock defines.
-
-#define mlock(a, b)                                                            \
-    mlock((reinterpret_cast<void*>((reinterpret_cast<size_t>(a)) &             \
-                                   (~((PAGESIZE)-1)))),                        \
-          ((((reinterpret_cast<size_t>(a)) + (b)-1) | ((PAGESIZE)-1)) + 1) -   \
-              ((reinterpret_cast<size_t>(a)) & (~((PAGESIZE)-1))))
-#define munlock(a, b)                                                          \
-    munlock((reinterpret_cast<void*>((reinterpret_cast<size_t>(a)) &           \
-                                     (~((PAGESIZE)-1)))),                      \
-            ((((reinterpret_cast<size_t>(a)) + (b)-1) | ((PAGESIZE)-1)) + 1) - \
-                ((reinterpret_cast<size_t>(a)) & (~((PAGESIZE)-1))))
-#endif
-
 namespace opentxs
 {
 
@@ -141,52 +116,6 @@ void* ot_secure_memset(void* v, uint8_t c, uint32_t n)
 #endif
  */
 
-// THE PURPOSE OF LOCKING A PAGE:
-//
-// "So that it won't get swapped to disk, where the secret
-// could be recovered maliciously from the swap file."
-//
-bool OTPassword::ot_lockPage(void* addr, size_t len)
-{
-#ifdef _WIN32
-// return VirtualLock(addr, len);
-#elif defined(PREDEF_PLATFORM_UNIX)
-    static bool bWarned = false;
-    if (mlock(addr, len) && !bWarned) {
-        bWarned = true;
-        otErr << "ot_lockPage: WARNING: unable to lock memory. \n"
-                 "   (Passwords / secret keys may be swapped to disk!)\n";
-    }
-    return true;
-#else
-    OT_FAIL_MSG("ASSERT: ot_lockPage unable to lock memory.");
-#endif
-    return false;
-}
-
-// TODO:  Note: may need to add directives here so that mlock and munlock are
-// not
-// used except where the user is running as a privileged process. (Because that
-// may be the only way we CAN use those functions...)
-
-bool OTPassword::ot_unlockPage(void* addr, size_t len)
-{
-#ifdef _WIN32
-//    return VirtualUnlock(addr, len);
-#elif defined(PREDEF_PLATFORM_UNIX)
-    static bool bWarned = false;
-    if (munlock(addr, len) && !bWarned) {
-        bWarned = true;
-        otErr << "ot_unlockPage: WARNING: unable to unlock memory used for "
-                 "storing secrets.\n";
-    }
-    return true;
-#else
-    OT_FAIL_MSG("ASSERT: ot_unlockPage unable to unlock secret memory.");
-#endif
-    return false;
-}
-
 // PURPOSE OF ZERO'ING MEMORY:
 //
 // So the secret is not stored in memory any longer than absolutely necessary.
@@ -197,22 +126,9 @@ void OTPassword::zeroMemory()
 {
     size_ = 0;
 
-    OTPassword::zeroMemory(static_cast<void*>(&(data_[0])), getBlockSize());
-
-//
-#ifndef _WIN32
-    // UNLOCK the page, now that we're AFTER the point where
-    // the memory was safely ZERO'd out.
-    //
-    if (isPageLocked_) {
-        if (ot_unlockPage(static_cast<void*>(&(data_[0])), getBlockSize())) {
-            isPageLocked_ = false;
-        }
-        else
-            otErr << "OTPassword::zeroMemory: Error: Memory page was locked, "
-                     "but then failed to unlock it.\n";
-    }
-#endif
+    // The buffer lives in the page-locked SecureArena, so there is nothing
+    // to unlock here.
+    OTPassword::zeroMemory(static_cast<void*>(data_), getBlockSize() + 1);
 }
 
 // static
@@ -369,10 +285,9 @@ OTPassword::OTPassword(OTPassword::BlockSize theBlockSize)
     : size_(0)
     , isText_(true)
     , isBinary_(false)
-    , isPageLocked_(false)
     , blockSize_(theBlockSize)
 {
-    data_[0] = '\0';
+    allocate();
     setPassword_uint8(reinterpret_cast<const uint8_t*>(""), 0);
 }
 
@@ -392,12 +307,11 @@ OTPassword::OTPassword(const OTPassword& rhs)
     : size_(0)
     , isText_(rhs.isPassword())
     , isBinary_(rhs.isMemory())
-    , isPageLocked_(false)
-    , blockSize_(
-          rhs.blockSize_) // The buffer has this size+1 as its static size.
+    , blockSize_(rhs.blockSize_)
 {
+    allocate();
+
     if (isText_) {
-        data_[0] = '\0';
         setPassword_uint8(rhs.getPassword_uint8(), rhs.getPasswordSize());
     }
     else if (isBinary_) {
@@ -410,10 +324,9 @@ OTPassword::OTPassword(const char* szInput, uint32_t nInputSize,
     : size_(0)
     , isText_(true)
     , isBinary_(false)
-    , isPageLocked_(false)
-    , blockSize_(theBlockSize) // The buffer has this size+1 as its static size.
+    , blockSize_(theBlockSize)
 {
-    data_[0] = '\0';
+    allocate();
 
     setPassword_uint8(reinterpret_cast<const uint8_t*>(szInput), nInputSize);
 }
@@ -423,10 +336,9 @@ OTPassword::OTPassword(const uint8_t* szInput, uint32_t nInputSize,
     : size_(0)
     , isText_(true)
     , isBinary_(false)
-    , isPageLocked_(false)
-    , blockSize_(theBlockSize) // The buffer has this size+1 as its static size.
+    , blockSize_(theBlockSize)
 {
-    data_[0] = '\0';
+    allocate();
 
     setPassword_uint8(szInput, nInputSize);
 }
@@ -436,15 +348,28 @@ OTPassword::OTPassword(const void* vInput, uint32_t nInputSize,
     : size_(0)
     , isText_(false)
     , isBinary_(true)
-    , isPageLocked_(false)
-    , blockSize_(theBlockSize) // The buffer has this size+1 as its static size.
+    , blockSize_(theBlockSize)
 {
+    allocate();
     setMemory(vInput, nInputSize);
 }
 
 OTPassword::~OTPassword()
 {
-    if (size_ > 0) zeroMemory();
+    // SecureArena zeroes the whole chunk when it is released.
+    SecureArena::It().Free(data_, getBlockSize() + 1);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// The buffer has getBlockSize()+1 bytes, to leave room for a null terminator.
+// It is zeroed on allocation.
+void OTPassword::allocate()
+{
+    data_ = static_cast<uint8_t*>(
+        SecureArena::It().Allocate(getBlockSize() + 1));
+
+    OT_ASSERT(nullptr != data_);
 }
 
 bool OTPassword::isPassword() const
@@ -623,25 +548,6 @@ int32_t OTPassword::setPassword_uint8(const uint8_t* szInput,
         return (-1);
     }
 
-#ifndef _WIN32
-
-    //
-    // Lock the memory page, before we copy the data over.
-    // (If it's not already locked, which I doubt it will be.)
-    //
-    // it won't be locked already, since we just zero'd it
-    // (above.) But I check this anyway...
-    if (!isPageLocked_) {
-        if (ot_lockPage(static_cast<void*>(&(data_[0])), getBlockSize())) {
-            isPageLocked_ = true;
-        }
-        else {
-            otErr << szFunc
-                  << ": Error: Failed attempting to lock memory page.\n";
-        }
-    }
-#endif
-
 #ifdef _WIN32
     strncpy_s(reinterpret_cast<char*>(data_), (1 + nInputSize),
               reinterpret_cast<const char*>(szInput), nInputSize);
@@ -754,24 +660,6 @@ int32_t OTPassword::randomizePassword(uint32_t nNewSize)
     //
     if (nSize > getBlockSize())
         nSize = getBlockSize(); // Truncated password beyond max size.
-#ifndef _WIN32
-    //
-    // Lock the memory page, before we randomize 'size bytes' of the data.
-    // (If it's not already locked, which I doubt it will be.)
-    //
-    if (!isPageLocked_) // it won't be locked already, since we just zero'd it
-                        // (above.) But I check this anyway...
-    {
-        if (ot_lockPage(static_cast<void*>(&(data_[0])), getBlockSize())) {
-            isPageLocked_ = true;
-        }
-        else {
-            otErr << __FUNCTION__
-                  << ": Error: Failed attempting to lock memory page.\n";
-        }
-    }
-#endif
-
     //
     if (!OTPassword::randomizePassword_uint8(&(data_[0]),
                                              static_cast<int32_t>(nSize + 1))) {
@@ -822,24 +710,6 @@ int32_t OTPassword::randomizeMemory(uint32_t nNewSize)
     if (nSize > getBlockSize())
         nSize = getBlockSize(); // Truncated password beyond max size.
 
-#ifndef _WIN32
-    //
-    // Lock the memory page, before we randomize 'size bytes' of the data.
-    // (If it's not already locked, which I doubt it will be.)
-    //
-    if (!isPageLocked_) // it won't be locked already, since we just zero'd it
-                        // (above.) But I check this anyway...
-    {
-        if (ot_lockPage(static_cast<void*>(&(data_[0])), getBlockSize())) {
-            isPageLocked_ = true;
-        }
-        else {
-            otErr << __FUNCTION__
-                  << ": Error: Failed attempting to lock memory page.\n";
-        }
-    }
-#endif
-
     //
     if (!OTPassword::randomizeMemory_uint8(&(data_[0]), nSize)) {
         // randomizeMemory (above) already logs, so I'm not logging again twice
@@ -947,24 +817,6 @@ int32_t OTPassword::setMemory(const void* vInput, uint32_t nInputSize)
     if (nInputSize > getBlockSize())
         nInputSize = getBlockSize(); // Truncated password beyond max size.
 
-#ifndef _WIN32
-    //
-    // Lock the memory page, before we copy the data over.
-    // (If it's not already locked, which I doubt it will be.)
-    //
-    if (!isPageLocked_) // it won't be locked already, since we just zero'd it
-                        // (above.) But I check this anyway...
-    {
-        if (ot_lockPage(static_cast<void*>(&(data_[0])), getBlockSize())) {
-            isPageLocked_ = true;
-        }
-        else {
-            otErr << __FUNCTION__
-                  << ": Error: Failed attempting to lock memory page.\n";
-        }
-    }
-#endif
-
     OTPassword::safe_memcpy(static_cast<void*>(&(data_[0])),
                             // dest size is based on the source
                             // size, but guaranteed to be >0 and
@@ -0,0 +1,216 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include "opentxs/core/crypto/SecureArena.hpp"
+
+#include "opentxs/core/crypto/OTPassword.hpp"
+#include "opentxs/core/util/Assert.hpp"
+#include "opentxs/core/Log.hpp"
+
+#ifndef _WIN32
+extern "C" {
+#include <sys/mman.h>
+#include <unistd.h>
+}
+#endif
+
+#include <new>
+
+namespace opentxs
+{
+
+SecureArena& SecureArena::It()
+{
+    // Deliberately never destroyed: OTPassword instances with static storage
+    // duration may still release their buffers during exit.
+    static SecureArena* instance = new SecureArena;
+
+    return *instance;
+}
+
+std::size_t SecureArena::size_class(const std::size_t size)
+{
+    std::size_t output = 0;
+
+    while ((std::size_t(1) << (MIN_CLASS_SHIFT + output)) < size) {
+        ++output;
+    }
+
+    return output;
+}
+
+void* SecureArena::Allocate(const std::size_t size)
+{
+    OT_ASSERT(0 < size);
+
+    Lock lock(lock_);
+    ++stats_.allocations_;
+
+    if (size <= (std::size_t(1) << MAX_CLASS_SHIFT)) {
+        const auto sizeClass = size_class(size);
+        auto& list = free_[sizeClass];
+
+        if (list.empty()) { new_slab(sizeClass); }
+
+        if (false == list.empty()) {
+            auto* output = list.back();
+            list.pop_back();
+            ++stats_.chunks_in_use_;
+            stats_.bytes_in_use_ +=
+                std::size_t(1) << (MIN_CLASS_SHIFT + sizeClass);
+
+            return output;
+        }
+    }
+
+    ++stats_.fallback_;
+
+    return new std::uint8_t[size]{};
+}
+
+void SecureArena::Free(void* chunk, const std::size_t size)
+{
+    if (nullptr == chunk) { return; }
+
+    OT_ASSERT(0 < size);
+
+    Lock lock(lock_);
+    ++stats_.frees_;
+
+    if (in_slab(chunk)) {
+        const auto sizeClass = size_class(size);
+        const std::size_t classSize = std::size_t(1)
+                                      << (MIN_CLASS_SHIFT + sizeClass);
+        OTPassword::zeroMemory(chunk, classSize);
+        free_[sizeClass].push_back(static_cast<std::uint8_t*>(chunk));
+        --stats_.chunks_in_use_;
+        stats_.bytes_in_use_ -= classSize;
+    } else {
+        OTPassword::zeroMemory(chunk, size);
+        delete[] static_cast<std::uint8_t*>(chunk);
+        --stats_.fallback_;
+    }
+}
+
+SecureArena::Stats SecureArena::GetStats() const
+{
+    Lock lock(lock_);
+
+    return stats_;
+}
+
+bool SecureArena::in_slab(const void* chunk) const
+{
+    const auto address = reinterpret_cast<std::uintptr_t>(chunk);
+    auto it = slabs_.upper_bound(address);
+
+    if (slabs_.begin() == it) { return false; }
+
+    --it;
+
+    return address < it->second;
+}
+
+bool SecureArena::new_slab(const std::size_t sizeClass)
+{
+#ifdef _WIN32
+    return false;
+#else
+    const std::size_t page = sysconf(_SC_PAGESIZE);
+    const std::size_t body = ((SLAB_SIZE + page - 1) / page) * page;
+    const std::size_t total = body + (2 * page);
+    void* mapped = mmap(
+        nullptr,
+        total,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+
+    if (MAP_FAILED == mapped) {
+        if (false == warned_) {
+            warned_ = true;
+            otErr << __FUNCTION__ << ": Unable to map secure memory. Secrets "
+                  << "will be stored on the ordinary heap." << std::endl;
+        }
+
+        return false;
+    }
+
+    auto* start = static_cast<std::uint8_t*>(mapped);
+    auto* usable = start + page;
+
+    if ((0 != mprotect(start, page, PROT_NONE)) ||
+        (0 != mprotect(usable + body, page, PROT_NONE))) {
+        otErr << __FUNCTION__ << ": Unable to protect guard pages."
+              << std::endl;
+    }
+
+    if (0 == mlock(usable, body)) {
+        stats_.locked_bytes_ += body;
+    } else if (false == warned_) {
+        warned_ = true;
+        otErr << __FUNCTION__ << ": WARNING: unable to lock memory. "
+              << "(Passwords / secret keys may be swapped to disk!)"
+              << std::endl;
+    }
+
+#ifdef MADV_DONTDUMP
+    madvise(usable, body, MADV_DONTDUMP);
+#endif
+
+    slabs_[reinterpret_cast<std::uintptr_t>(usable)] =
+        reinterpret_cast<std::uintptr_t>(usable + body);
+    ++stats_.slabs_;
+    stats_.slab_bytes_ += body;
+
+    const std::size_t classSize = std::size_t(1)
+                                  << (MIN_CLASS_SHIFT + sizeClass);
+    auto& list = free_[sizeClass];
+
+    // Hand out the lowest addresses first
+    for (std::size_t offset = body; offset >= classSize;) {
+        offset -= classSize;
+        list.push_back(usable + offset);
+    }
+
+    return true;
+#endif
+}
+
+}  // namespace opentxs
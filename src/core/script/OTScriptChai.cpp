@@ -55,11 +55,98 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace opentxs
 {
 
+namespace
+{
+
+// The largest number of idle interpreters kept for reuse.
+const std::size_t pool_size_{16};
+
+struct PooledInterpreter {
+    std::unique_ptr<chaiscript::ChaiScript> chai_;
+    chaiscript::ChaiScript::State state_;
+    std::map<std::string, chaiscript::Boxed_Value> locals_;
+};
+
+std::mutex interpreter_lock_;
+std::vector<std::unique_ptr<PooledInterpreter>> idle_interpreters_;
+std::map<chaiscript::ChaiScript*, std::unique_ptr<PooledInterpreter>>
+    active_interpreters_;
+
+chaiscript::ChaiScript* new_interpreter()
+{
+#if !defined(OT_USE_CHAI_STDLIB)
+    return new chaiscript::ChaiScript();
+#else
+    return new chaiscript::ChaiScript(chaiscript::Std_Lib::library());
+#endif
+}
+
+} // namespace
+
+chaiscript::ChaiScript* OTScriptChai::acquire_interpreter()
+{
+    std::unique_lock<std::mutex> lock(interpreter_lock_);
+    std::unique_ptr<PooledInterpreter> interpreter;
+
+    if (idle_interpreters_.empty()) {
+        lock.unlock();
+        interpreter.reset(new PooledInterpreter);
+        interpreter->chai_.reset(new_interpreter());
+        interpreter->state_ = interpreter->chai_->get_state();
+        interpreter->locals_ = interpreter->chai_->get_locals();
+        lock.lock();
+    } else {
+        interpreter = std::move(idle_interpreters_.back());
+        idle_interpreters_.pop_back();
+    }
+
+    chaiscript::ChaiScript* output = interpreter->chai_.get();
+    active_interpreters_[output] = std::move(interpreter);
+
+    return output;
+}
+
+void OTScriptChai::release_interpreter(chaiscript::ChaiScript* chai)
+{
+    std::unique_lock<std::mutex> lock(interpreter_lock_);
+    auto it = active_interpreters_.find(chai);
+
+    OT_ASSERT(active_interpreters_.end() != it);
+
+    std::unique_ptr<PooledInterpreter> interpreter = std::move(it->second);
+    active_interpreters_.erase(it);
+
+    if (pool_size_ <= idle_interpreters_.size()) {
+
+        return;
+    }
+
+    lock.unlock();
+
+    // Forget every party, account, variable and callback which was bound for
+    // the script which just ran.
+    try {
+        interpreter->chai_->set_state(interpreter->state_);
+        interpreter->chai_->set_locals(interpreter->locals_);
+    } catch (...) {
+        otErr << __FUNCTION__ << ": Failed to reset interpreter.\n";
+
+        return;
+    }
+
+    lock.lock();
+    idle_interpreters_.push_back(std::move(interpreter));
+}
+
 bool OTScriptChai::ExecuteScript(OTVariable* pReturnVar)
 {
     using namespace chaiscript;
@@ -353,75 +440,39 @@ bool OTScriptChai::ExecuteScript(OTVariable* pReturnVar)
     return true;
 }
 
-#if !defined(OT_USE_CHAI_STDLIB)
-
-OTScriptChai::OTScriptChai()
-    : OTScript()
-    , chai(new chaiscript::ChaiScript())
-{
-}
-
-OTScriptChai::OTScriptChai(const OTString& strValue)
-    : OTScript(strValue)
-    , chai(new chaiscript::ChaiScript())
-{
-}
-
-OTScriptChai::OTScriptChai(const char* new_string)
-    : OTScript(new_string)
-    , chai(new chaiscript::ChaiScript())
-{
-}
-
-OTScriptChai::OTScriptChai(const char* new_string, size_t sizeLength)
-    : OTScript(new_string, sizeLength)
-    , chai(new chaiscript::ChaiScript())
-{
-}
-
-OTScriptChai::OTScriptChai(const std::string& new_string)
-    : OTScript(new_string)
-    , chai(new chaiscript::ChaiScript())
-{
-}
-
-#else
-
 OTScriptChai::OTScriptChai()
     : OTScript()
-    , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , chai(acquire_interpreter())
 {
 }
 
 OTScriptChai::OTScriptChai(const String& strValue)
     : OTScript(strValue)
-    , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , chai(acquire_interpreter())
 {
 }
 
 OTScriptChai::OTScriptChai(const char* new_string)
     : OTScript(new_string)
-    , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , chai(acquire_interpreter())
 {
 }
 
 OTScriptChai::OTScriptChai(const char* new_string, size_t sizeLength)
     : OTScript(new_string, sizeLength)
-    , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , chai(acquire_interpreter())
 {
 }
 
 OTScriptChai::OTScriptChai(const std::string& new_string)
     : OTScript(new_string)
-    , chai(new chaiscript::ChaiScript(chaiscript::Std_Lib::library()))
+    , chai(acquire_interpreter())
 {
 }
 
-#endif // OT_USE_CHAI_STDLIB
-
 OTScriptChai::~OTScriptChai()
 {
-    if (nullptr != chai) delete chai;
+    if (nullptr != chai) release_interpreter(chai);
 }
 
 } // namespace opentxs
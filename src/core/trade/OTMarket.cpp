@@ -64,11 +64,14 @@
 #include <inttypes.h>
 #include <irrxml/irrXML.hpp>
 #include <string.h>
+#include <algorithm>
 #include <cstdint>
+#include <cstdio>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <utility>
 
@@ -184,11 +187,7 @@ void OTMarket::UpdateContents()
         OTOffer* pOffer = it.second;
         OT_ASSERT(nullptr != pOffer);
 
-        String strOffer(
-            *pOffer); // Extract the offer contract into string form.
-        OTASCIIArmor ascOffer(strOffer); // Base64-encode that for storage.
-
-        TagPtr tagOffer(new Tag("offer", ascOffer.Get()));
+        TagPtr tagOffer(new Tag("offer", GetArmoredOffer(*pOffer)));
         tagOffer->add_attribute(
             "dateAdded", formatTimestamp(pOffer->GetDateAddedToMarket()));
         tag.add_tag(tagOffer);
@@ -199,11 +198,7 @@ void OTMarket::UpdateContents()
         OTOffer* pOffer = it.second;
         OT_ASSERT(nullptr != pOffer);
 
-        String strOffer(
-            *pOffer); // Extract the offer contract into string form.
-        OTASCIIArmor ascOffer(strOffer); // Base64-encode that for storage.
-
-        TagPtr tagOffer(new Tag("offer", ascOffer.Get()));
+        TagPtr tagOffer(new Tag("offer", GetArmoredOffer(*pOffer)));
         tagOffer->add_attribute(
             "dateAdded", formatTimestamp(pOffer->GetDateAddedToMarket()));
         tag.add_tag(tagOffer);
@@ -215,6 +210,23 @@ void OTMarket::UpdateContents()
     m_xmlUnsigned.Concatenate("%s", str_result.c_str());
 }
 
+const std::string& OTMarket::GetArmoredOffer(OTOffer& theOffer)
+{
+    auto it = m_mapArmoredOffers.find(theOffer.GetTransactionNum());
+
+    if (m_mapArmoredOffers.end() != it) {
+        return it->second;
+    }
+
+    String strOffer(theOffer); // Extract the offer contract into string form.
+    OTASCIIArmor ascOffer(strOffer); // Base64-encode that for storage.
+
+    auto& output = m_mapArmoredOffers[theOffer.GetTransactionNum()];
+    output.assign(ascOffer.Get(), ascOffer.GetLength());
+
+    return output;
+}
+
 int64_t OTMarket::GetTotalAvailableAssets()
 {
     int64_t lTotal = 0;
@@ -595,6 +607,9 @@ bool OTMarket::RemoveOffer(const int64_t& lTransactionNum) // if false, offer
         // number.)
         // But it's still on one of the other lists...
         m_mapOffers.erase(it);
+        m_mapArmoredOffers.erase(lTransactionNum);
+        m_mapJournal.erase(lTransactionNum);
+        ++m_lBookRevision;
 
         // The code operates the same whether ask or bid. Just use a pointer.
         mapOfOffers* pMap = (pOffer->IsBid() ? &m_mapBids : &m_mapAsks);
@@ -724,6 +739,9 @@ bool OTMarket::AddOffer(OTTrade* pTrade, OTOffer& theOffer, bool bSaveFile,
             otLog4 << "Offer added as an ask to the market.\n";
         }
 
+        m_mapArmoredOffers.erase(theOffer.GetTransactionNum());
+        ++m_lBookRevision;
+
         if (bSaveFile) {
             // Set this to the current date/time, since the offer is
             // being added for the first time.
@@ -763,6 +781,8 @@ bool OTMarket::LoadMarket()
 
     if (bSuccess) bSuccess = VerifySignature(*(GetCron()->GetServerNym()));
 
+    if (bSuccess) bSuccess = ReplayJournal();
+
     // Load the list of recent market trades (informational only.)
     //
     if (bSuccess) {
@@ -809,27 +829,197 @@ bool OTMarket::SaveMarket()
         return false;
     }
 
-    // Save a copy of recent trades.
+    SaveRecentTrades();
 
-    if (nullptr != m_pTradeList) {
+    // The market file now holds every journaled fill.
+    m_mapJournal.clear();
+    m_nJournaledFills = 0;
 
-        String str_TRADES_FILE;
-        str_TRADES_FILE.Format("%s.bin", str_MARKET_ID.Get());
+    String strJournal;
+    strJournal.Format("%s.journal", szFilename);
 
-        const char* szSubFolder = "recent"; // todo stop hardcoding.
+    // If it can't be erased, an empty journal is harmless to replay.
+    if (OTDB::Exists(szFoldername, strJournal.Get()) &&
+        !OTDB::EraseValueByKey(szFoldername, strJournal.Get()) &&
+        !SaveJournal()) {
+        otErr << "Error erasing journal for Market:\n" << szFoldername
+              << Log::PathSeparator() << strJournal << "\n";
+    }
+
+    return true;
+}
+
+void OTMarket::SaveRecentTrades()
+{
+    if (nullptr == m_pTradeList) { return; }
+
+    Identifier MARKET_ID(*this);
+    String str_MARKET_ID(MARKET_ID);
+
+    const char* szFoldername = OTFolders::Market().Get();
+    const char* szFilename = str_MARKET_ID.Get();
+
+    String str_TRADES_FILE;
+    str_TRADES_FILE.Format("%s.bin", str_MARKET_ID.Get());
+
+    const char* szSubFolder = "recent"; // todo stop hardcoding.
+
+    // If this fails, oh well. It's informational, anyway.
+    if (!OTDB::StoreObject(*m_pTradeList, szFoldername, // markets
+                           szSubFolder,                 // markets/recent
+                           str_TRADES_FILE.Get()))      // markets/recent/<Market_ID>.bin
+        otErr << "Error saving recent trades for Market:\n" << szFoldername
+              << Log::PathSeparator() << szSubFolder << Log::PathSeparator()
+              << szFilename << "\n";
+}
+
+// Called after two offers have been filled against each other, once both of
+// them have been signed again. Only the two offers are written, instead of
+// signing and writing the whole market.
+bool OTMarket::JournalFill(OTOffer& theOffer, OTOffer& theOtherOffer)
+{
+    for (OTOffer* pOffer : {&theOffer, &theOtherOffer}) {
+        std::string strOffer = GetArmoredOffer(*pOffer);
+        strOffer.erase(
+            std::remove(strOffer.begin(), strOffer.end(), '\n'),
+            strOffer.end());
+        m_mapJournal[pOffer->GetTransactionNum()] = strOffer;
+    }
+
+    if ((++m_nJournaledFills < OT_MARKET_JOURNAL_LIMIT) && SaveJournal()) {
+        SaveRecentTrades();
+
+        return true;
+    }
+
+    return SaveMarket();
+}
+
+bool OTMarket::SaveJournal()
+{
+    Identifier MARKET_ID(*this);
+    const String str_MARKET_ID(MARKET_ID);
+
+    const char* szFoldername = OTFolders::Market().Get();
+
+    String strJournal, strTemp;
+    strJournal.Format("%s.journal", str_MARKET_ID.Get());
+    strTemp.Format("%s.journal.tmp", str_MARKET_ID.Get());
+
+    std::ostringstream journal;
+    journal << "lastSalePrice=" << m_lLastSalePrice << "\n"
+            << "lastSaleDate=" << m_strLastSaleDate << "\n";
 
-        // If this fails, oh well. It's informational, anyway.
-        if (!OTDB::StoreObject(*m_pTradeList, szFoldername, // markets
-                               szSubFolder,                 // markets/recent
-                               str_TRADES_FILE.Get()))      // markets/recent/<Market_ID>.bin
-            otErr << "Error saving recent trades for Market:\n" << szFoldername
-                  << Log::PathSeparator() << szSubFolder << Log::PathSeparator()
-                  << szFilename << "\n";
+    for (const auto& it : m_mapJournal) {
+        journal << "offer=" << it.second << "\n";
+    }
+
+    journal << "end\n";
+
+    // Written aside and renamed into place, so a crash leaves either the
+    // previous journal or this one.
+    if (!OTDB::StorePlainString(journal.str(), szFoldername, strTemp.Get())) {
+        otErr << "Error saving journal for Market:\n" << szFoldername
+              << Log::PathSeparator() << strTemp << "\n";
+        return false;
+    }
+
+    std::string tempPath, path;
+
+    if ((0 > OTDB::FormPathString(tempPath, szFoldername, strTemp.Get())) ||
+        (0 > OTDB::FormPathString(path, szFoldername, strJournal.Get())) ||
+        (0 != std::rename(tempPath.c_str(), path.c_str()))) {
+        otErr << "Error replacing journal for Market:\n" << szFoldername
+              << Log::PathSeparator() << strJournal << "\n";
+        return false;
     }
 
     return true;
 }
 
+// Applies the fills journaled since the market file was last written, then
+// writes the market file again so the journal can be discarded.
+bool OTMarket::ReplayJournal()
+{
+    Identifier MARKET_ID(*this);
+    const String str_MARKET_ID(MARKET_ID);
+
+    const char* szFoldername = OTFolders::Market().Get();
+
+    String strJournal;
+    strJournal.Format("%s.journal", str_MARKET_ID.Get());
+
+    if (!OTDB::Exists(szFoldername, strJournal.Get())) { return true; }
+
+    std::istringstream journal(
+        OTDB::QueryPlainString(szFoldername, strJournal.Get()));
+    std::string line, strLastSaleDate;
+    int64_t lLastSalePrice = m_lLastSalePrice;
+    std::map<int64_t, std::string> mapOffers;
+    bool bComplete = false;
+
+    while (std::getline(journal, line)) {
+        if ("end" == line) {
+            bComplete = true;
+            break;
+        }
+
+        const std::size_t equals = line.find('=');
+
+        if (std::string::npos == equals) { continue; }
+
+        const std::string key = line.substr(0, equals);
+        const std::string value = line.substr(equals + 1);
+
+        if ("lastSalePrice" == key) {
+            lLastSalePrice = String::StringToLong(value);
+        }
+        else if ("lastSaleDate" == key) {
+            strLastSaleDate = value;
+        }
+        else if ("offer" == key) {
+            String strOffer;
+            const OTASCIIArmor ascOffer(value.c_str());
+            OTOffer theOffer(
+                m_NOTARY_ID, m_INSTRUMENT_DEFINITION_ID, m_CURRENCY_TYPE_ID,
+                m_lScale);
+
+            // The journal is not signed, but every offer in it is.
+            if (!ascOffer.GetString(strOffer) ||
+                !theOffer.LoadContractFromString(strOffer) ||
+                !theOffer.VerifySignature(*(GetCron()->GetServerNym()))) {
+                otErr << "Bad offer in journal for Market:\n" << szFoldername
+                      << Log::PathSeparator() << strJournal << "\n";
+                return false;
+            }
+
+            OTOffer* pOffer = GetOffer(theOffer.GetTransactionNum());
+
+            // Offers which have since been removed are already gone from the
+            // market file.
+            if (nullptr == pOffer) { continue; }
+
+            pOffer->SetFinishedSoFar(theOffer.GetFinishedSoFar());
+            mapOffers[theOffer.GetTransactionNum()] = value;
+        }
+    }
+
+    if (!bComplete) {
+        otErr << "Incomplete journal for Market:\n" << szFoldername
+              << Log::PathSeparator() << strJournal << "\n";
+        return false;
+    }
+
+    for (const auto& it : mapOffers) {
+        m_mapArmoredOffers[it.first] = it.second;
+    }
+
+    m_lLastSalePrice = lLastSalePrice;
+    m_strLastSaleDate = strLastSaleDate;
+
+    return SaveMarket();
+}
+
 // A Market's ID is based on the instrument definition, the currency type, and
 // the scale.
 //
@@ -870,26 +1060,18 @@ int64_t OTMarket::GetLowestAskPrice()
 {
     int64_t lPrice = 0;
 
-    auto it = m_mapAsks.begin();
+    // Market orders have a 0 price, so we need to skip any if they are
+    // here.
+    //
+    // Note that we don't have to do this with the highest bid price (above
+    // function) but in the case of asks, a "0 price" will undercut the
+    // other
+    // actual prices, so we need to skip any that have a 0 price.
+    //
+    auto it = m_mapAsks.upper_bound(0);
 
     if (it != m_mapAsks.end()) {
         lPrice = it->first;
-
-        // Market orders have a 0 price, so we need to skip any if they are
-        // here.
-        //
-        // Note that we don't have to do this with the highest bid price (above
-        // function) but in the case of asks, a "0 price" will undercut the
-        // other
-        // actual prices, so we need to skip any that have a 0 price.
-        //
-        while (0 == lPrice) {
-            ++it;
-
-            if (it == m_mapAsks.end()) break;
-
-            lPrice = it->first;
-        }
     }
 
     return lPrice;
@@ -1807,6 +1989,9 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
                 theOtherOffer.SignContract(*pServerNym);
                 theOtherOffer.SaveContract();
 
+                m_mapArmoredOffers.erase(theOffer.GetTransactionNum());
+                m_mapArmoredOffers.erase(theOtherOffer.GetTransactionNum());
+
                 m_lLastSalePrice =
                     theOtherOffer.GetPriceLimit(); // Priced per scale.
 
@@ -1855,9 +2040,10 @@ void OTMarket::ProcessTrade(OTTrade& theTrade, OTOffer& theOffer,
 
                 // Account balances have changed based on these trades that we
                 // just processed.
-                // Make sure to save the Market since it contains those offers
-                // that have just updated.
-                SaveMarket();
+                // Make sure to journal the offers that have just updated. The
+                // Market is saved in full every OT_MARKET_JOURNAL_LIMIT fills.
+                ++m_lBookRevision;
+                JournalFill(theOffer, theOtherOffer);
 
                 // The Trade has changed, and it is stored as a CronItem. So I
                 // save Cron as well, for
@@ -2755,6 +2941,10 @@ void OTMarket::Release_Market()
 
     m_NOTARY_ID.Release();
 
+    m_mapArmoredOffers.clear();
+    m_mapJournal.clear();
+    m_nJournaledFills = 0;
+
     // Elements of this list are cleaned up automatically.
     if (nullptr != m_pTradeList) {
         delete m_pTradeList;
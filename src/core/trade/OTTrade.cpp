@@ -1144,11 +1144,18 @@ bool OTTrade::ProcessCron()
             bStayOnMarket = false; // I'm leaving the check here in case the
                                    // flag was set since then.
 
+        // Nothing has been added to, removed from, or traded on the market
+        // since this offer was last matched against it, so there is nothing
+        // new for it to match.
+        else if (market->GetBookRevision() == bookRevision_)
+            bStayOnMarket = true;
+
         else // Process it!  <===================
         {
             otInfo << "Processing trade: " << GetTransactionNum() << ".\n";
 
             bStayOnMarket = market->ProcessTrade(*this, *offer);
+            bookRevision_ = market->GetBookRevision();
             // No need to save the Trade or Offer, since they will
             // be saved inside this call if they are changed.
         }
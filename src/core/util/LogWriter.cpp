@@ -0,0 +1,263 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include "opentxs/core/util/LogWriter.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+#define OT_LOG_WRITER_IDLE_MILLISECONDS 50
+#define OT_LOG_WRITER_FLUSH_MILLISECONDS 10
+
+namespace opentxs
+{
+
+const std::uint64_t LogWriter::capacity_;
+const std::uint64_t LogWriter::mask_;
+
+LogWriter::LogWriter(
+    const std::string& path,
+    const std::uint64_t maxSize,
+    const std::uint32_t maxFiles)
+    : path_(path)
+    , max_size_(maxSize)
+    , max_files_(maxFiles)
+    , slots_(new Slot[capacity_])
+{
+    static_assert(0 == (capacity_ & mask_), "capacity must be a power of 2");
+
+    for (std::uint64_t i = 0; i < capacity_; ++i) {
+        slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+
+    open();
+    thread_ = std::thread(&LogWriter::run, this);
+}
+
+bool LogWriter::drain()
+{
+    std::uint64_t count{0};
+
+    while (!empty()) {
+        auto& slot = slots_[tail_ & mask_];
+        const std::string line(std::move(slot.line_));
+        slot.line_.clear();
+        slot.sequence_.store(tail_ + capacity_, std::memory_order_release);
+        ++tail_;
+        ++count;
+
+        std::cerr << line;
+
+        if (file_.is_open()) {
+            file_ << line;
+            size_ += line.size();
+
+            if ((0 < max_size_) && (size_ >= max_size_)) {
+                rotate();
+            }
+        }
+    }
+
+    if (0 == count) {
+
+        return false;
+    }
+
+    std::cerr.flush();
+
+    if (file_.is_open()) {
+        file_.flush();
+    }
+
+    written_.store(tail_);
+
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+    }
+
+    flushed_.notify_all();
+
+    return true;
+}
+
+bool LogWriter::empty() const
+{
+    const auto& slot = slots_[tail_ & mask_];
+
+    return (tail_ + 1) != slot.sequence_.load(std::memory_order_acquire);
+}
+
+void LogWriter::Flush()
+{
+    const auto target = head_.load();
+    std::unique_lock<std::mutex> lock(lock_);
+
+    while (written_.load() < target) {
+        wake_.notify_one();
+        flushed_.wait_for(
+            lock,
+            std::chrono::milliseconds(OT_LOG_WRITER_FLUSH_MILLISECONDS));
+    }
+}
+
+void LogWriter::open()
+{
+    if (path_.empty()) {
+
+        return;
+    }
+
+    {
+        std::ifstream existing(
+            path_, std::ios::in | std::ios::binary | std::ios::ate);
+        size_ = existing.good() ? static_cast<std::uint64_t>(existing.tellg())
+                                : 0;
+    }
+
+    file_.open(path_, std::ios::out | std::ios::app | std::ios::binary);
+
+    if (!file_.is_open()) {
+        std::cerr << __FUNCTION__ << ": Failed to open log file " << path_
+                  << std::endl;
+    }
+}
+
+void LogWriter::Push(std::string&& line)
+{
+    auto position = head_.load(std::memory_order_relaxed);
+    Slot* slot{nullptr};
+
+    while (true) {
+        slot = &slots_[position & mask_];
+        const auto sequence = slot->sequence_.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::int64_t>(sequence - position);
+
+        if (0 == difference) {
+            if (head_.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (0 > difference) {
+            // Full. Make sure the writer is awake, then try again.
+            wake();
+            std::this_thread::yield();
+            position = head_.load(std::memory_order_relaxed);
+        } else {
+            position = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->line_ = std::move(line);
+    slot->sequence_.store(position + 1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wake();
+}
+
+void LogWriter::rotate()
+{
+    file_.close();
+
+    for (std::uint32_t i = max_files_; i > 1; --i) {
+        const auto from = path_ + "." + std::to_string(i - 1);
+        const auto to = path_ + "." + std::to_string(i);
+        std::remove(to.c_str());
+        std::rename(from.c_str(), to.c_str());
+    }
+
+    if (0 < max_files_) {
+        const auto to = path_ + ".1";
+        std::remove(to.c_str());
+        std::rename(path_.c_str(), to.c_str());
+    } else {
+        std::remove(path_.c_str());
+    }
+
+    open();
+}
+
+void LogWriter::run()
+{
+    while (true) {
+        const bool running = running_.load();
+
+        if (drain()) {
+            continue;
+        }
+
+        if (!running) {
+            break;
+        }
+
+        sleeping_.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::unique_lock<std::mutex> lock(lock_);
+
+        if (empty() && running_.load()) {
+            wake_.wait_for(
+                lock,
+                std::chrono::milliseconds(OT_LOG_WRITER_IDLE_MILLISECONDS));
+        }
+
+        sleeping_.store(false);
+    }
+}
+
+void LogWriter::wake()
+{
+    // Producers only pay for the mutex when the writer is idle.
+    if (sleeping_.load()) {
+        std::lock_guard<std::mutex> lock(lock_);
+        wake_.notify_one();
+    }
+}
+
+LogWriter::~LogWriter()
+{
+    running_.store(false);
+
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        wake_.notify_one();
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+}  // namespace opentxs
@@ -55,18 +55,29 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#define OT_SERVER_CONNECTION_POLL_MILLISECONDS 100
 
 namespace opentxs
 {
 ServerConnection::ServerConnection(
     const std::string& server,
     std::atomic<bool>& shutdown,
-    std::atomic<std::chrono::seconds>& keepAlive)
+    std::atomic<std::chrono::seconds>& keepAlive,
+    const bool binary)
         : remote_endpoint_(GetRemoteEndpoint(server, remote_contract_))
-        , request_socket_(zsock_new_req(nullptr))
+        , queue_endpoint_(GetQueueEndpoint())
+        , request_socket_(zsock_new_dealer(nullptr))
+        , pull_socket_(zsock_new_pull(("@" + queue_endpoint_).c_str()))
+        , push_socket_(zsock_new_push((">" + queue_endpoint_).c_str()))
         , lock_(new std::mutex)
         , shutdown_(shutdown)
         , keep_alive_(keepAlive)
+        , binary_allowed_(binary)
+        , binary_(false)
 {
     if (!zsys_has_curve()) {
         otErr << __FUNCTION__ << ": libzmq has no libsodium support."
@@ -76,9 +87,13 @@ ServerConnection::ServerConnection(
     }
 
     OT_ASSERT(lock_);
+    OT_ASSERT(nullptr != request_socket_);
+    OT_ASSERT(nullptr != pull_socket_);
+    OT_ASSERT(nullptr != push_socket_);
 
     ResetTimer();
     Init();
+    io_thread_.reset(new std::thread(&ServerConnection::IOThread, this));
     thread_.reset(new std::thread(&ServerConnection::Thread, this));
 }
 
@@ -88,9 +103,111 @@ ServerConnection::~ServerConnection()
         thread_->join();
     }
 
+    if (io_thread_) {
+        io_thread_->join();
+    }
+
+    Expire(true);
+    zsock_destroy(&push_socket_);
+    zsock_destroy(&pull_socket_);
     zsock_destroy(&request_socket_);
 }
 
+// Fails requests which have waited longer than the receive timeout, or every
+// outstanding request if all is true.
+void ServerConnection::Expire(const bool all)
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::uint64_t> expired;
+
+    {
+        std::lock_guard<std::mutex> lock(pending_lock_);
+
+        for (const auto& it : pending_) {
+            if (all || (it.second.deadline_ < now)) {
+                expired.push_back(it.first);
+            }
+        }
+    }
+
+    for (const auto& tag : expired) {
+        Finish(tag, SendResult::TIMEOUT_RECEIVING);
+    }
+
+    if (!expired.empty()) {
+        status_.store(false);
+    }
+}
+
+void ServerConnection::Finish(
+    const std::uint64_t tag,
+    const SendResult result,
+    const std::string& reply)
+{
+    Pending pending;
+
+    {
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        auto it = pending_.find(tag);
+
+        // A reply which arrives after its request timed out is discarded.
+        if (pending_.end() == it) {
+
+            return;
+        }
+
+        pending = std::move(it->second);
+        pending_.erase(it);
+    }
+
+    NetworkReplyRaw output{result, nullptr};
+    output.second.reset(new std::string(reply));
+
+    OT_ASSERT(output.second);
+
+    if (pending.message_) {
+        pending.message_promise_.set_value(ReplyMessage(std::move(output)));
+    } else {
+        pending.promise_.set_value(std::move(output));
+    }
+}
+
+// Moves one request from the caller queue onto the DEALER socket. Returns
+// false if the DEALER socket had to be replaced.
+bool ServerConnection::Forward()
+{
+    zmsg_t* message = zmsg_recv(pull_socket_);
+
+    if (nullptr == message) {
+
+        return true;
+    }
+
+    std::uint64_t tag{0};
+    zframe_t* tagFrame = zmsg_first(message);
+
+    if ((nullptr == tagFrame) || (sizeof(tag) != zframe_size(tagFrame))) {
+        otErr << __FUNCTION__ << ": Invalid request." << std::endl;
+        zmsg_destroy(&message);
+
+        return true;
+    }
+
+    std::memcpy(&tag, zframe_data(tagFrame), sizeof(tag));
+
+    if (0 != zmsg_send(&message, request_socket_)) {
+        zmsg_destroy(&message);
+        Finish(tag, SendResult::ERROR_SENDING);
+        ResetSocket();
+
+        return false;
+    }
+
+    ResetTimer();
+
+    return true;
+}
+
 void ServerConnection::Init()
 {
     shutdown_.store(false);
@@ -105,19 +222,50 @@ void ServerConnection::Init()
     }
 }
 
-void ServerConnection::ResetSocket()
+void ServerConnection::IOThread()
 {
-    zsock_destroy(&request_socket_);
-    request_socket_ = zsock_new_req(nullptr);
+    zpoller_t* poller{nullptr};
+    auto checked = std::chrono::steady_clock::now();
 
-    if (nullptr == request_socket_) {
-        otErr << __FUNCTION__ << ": Failed trying to reset socket."
-              << std::endl;
+    while (!shutdown_.load()) {
+        if (nullptr == poller) {
+            poller = zpoller_new(pull_socket_, request_socket_, nullptr);
 
-        OT_FAIL;
+            OT_ASSERT(nullptr != poller);
+        }
+
+        auto socket = static_cast<zsock_t*>(
+            zpoller_wait(poller, OT_SERVER_CONNECTION_POLL_MILLISECONDS));
+
+        if (pull_socket_ == socket) {
+            if (!Forward()) {
+                // The DEALER socket was replaced.
+                zpoller_destroy(&poller);
+            }
+        } else if (request_socket_ == socket) {
+            Receive();
+        } else if (zpoller_terminated(poller)) {
+            break;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+
+        if ((now - checked) > std::chrono::milliseconds(
+                                  OT_SERVER_CONNECTION_POLL_MILLISECONDS)) {
+            checked = now;
+            Expire(false);
+        }
     }
 
-    Init();
+    zpoller_destroy(&poller);
+}
+
+std::string ServerConnection::GetQueueEndpoint()
+{
+    static std::atomic<std::uint64_t> counter{0};
+
+    return "inproc://opentxs/serverconnection/" +
+           std::to_string(++counter);
 }
 
 std::string ServerConnection::GetRemoteEndpoint(
@@ -159,54 +307,104 @@ std::string ServerConnection::GetRemoteEndpoint(
     return endpoint;
 }
 
-bool ServerConnection::Receive(std::string& reply)
+// Matches one reply from the DEALER socket to its request.
+void ServerConnection::Receive()
 {
-    char* message = zstr_recv(request_socket_);
+    zmsg_t* message = zmsg_recv(request_socket_);
 
-    if (nullptr == message) { return false; }
+    if (nullptr == message) {
 
-    reply.assign(message);
-    zstr_free(&message);
+        return;
+    }
 
-    return true;
+    std::uint64_t tag{0};
+    zframe_t* tagFrame = zmsg_pop(message);
+    zframe_t* delimiter = zmsg_pop(message);
+    const bool valid = (nullptr != tagFrame) &&
+                       (sizeof(tag) == zframe_size(tagFrame)) &&
+                       (nullptr != delimiter) && (0 == zframe_size(delimiter));
+
+    if (valid) {
+        std::memcpy(&tag, zframe_data(tagFrame), sizeof(tag));
+        zframe_t* reply = zmsg_pop(message);
+
+        if (nullptr != reply) {
+            status_.store(true);
+            Finish(
+                tag,
+                SendResult::HAVE_REPLY,
+                std::string(
+                    reinterpret_cast<const char*>(zframe_data(reply)),
+                    zframe_size(reply)));
+            zframe_destroy(&reply);
+        }
+    } else {
+        otErr << __FUNCTION__ << ": Received a reply with an invalid envelope."
+              << std::endl;
+    }
+
+    zframe_destroy(&tagFrame);
+    zframe_destroy(&delimiter);
+    zmsg_destroy(&message);
 }
 
-void ServerConnection::ResetTimer()
+ServerConnection::Pending& ServerConnection::Queue(const std::uint64_t tag)
 {
-    last_activity_.store(std::time(nullptr));
+    // Caller must be holding pending_lock_
+    auto& pending = pending_[tag];
+    pending.deadline_ =
+        std::chrono::steady_clock::now() + OT::App().ZMQ().ReceiveTimeout();
+
+    return pending;
 }
 
-NetworkReplyRaw ServerConnection::Send(const std::string& message)
+NetworkReplyMessage ServerConnection::ReplyMessage(NetworkReplyRaw&& rawOutput)
 {
-    OT_ASSERT(lock_);
+    NetworkReplyMessage output{SendResult::ERROR_SENDING, nullptr};
+    output.second.reset(new Message);
 
-    std::lock_guard<std::mutex> lock(*lock_);
+    OT_ASSERT(output.second);
 
-    NetworkReplyRaw output{SendResult::ERROR_SENDING, nullptr};
-    output.second.reset(new std::string);
+    output.first = rawOutput.first;
 
-    OT_ASSERT(output.second);
+    if (SendResult::HAVE_REPLY == output.first) {
+        if (Message::IsBinary(*rawOutput.second)) {
+            output.second->LoadBinary(*rawOutput.second);
+        } else {
+            OTASCIIArmor reply;
+            reply.Set(rawOutput.second->c_str());
+            String strReply;
+            reply.GetString(strReply);
+            output.second->LoadContractFromString(strReply);
+        }
+    }
 
-    const bool sent = (0 == zstr_send(request_socket_, message.c_str()));
+    return output;
+}
 
-    if (!sent) {
-        ResetSocket();
+void ServerConnection::ResetSocket()
+{
+    zsock_destroy(&request_socket_);
+    request_socket_ = zsock_new_dealer(nullptr);
 
-        return output;
+    if (nullptr == request_socket_) {
+        otErr << __FUNCTION__ << ": Failed trying to reset socket."
+              << std::endl;
+
+        OT_FAIL;
     }
 
-    ResetTimer();
-    const bool received = Receive(*output.second);
+    Init();
+}
 
-    if (received) {
-        status_.store(true);
-        output.first = SendResult::HAVE_REPLY;
-    } else {
-        status_.store(false);
-        output.first = SendResult::TIMEOUT_RECEIVING;
-    }
+void ServerConnection::ResetTimer()
+{
+    last_activity_.store(std::time(nullptr));
+}
 
-    return output;
+NetworkReplyRaw ServerConnection::Send(const std::string& message)
+{
+    return SendAsync(message).get();
 }
 
 NetworkReplyString ServerConnection::Send(const String& message)
@@ -233,23 +431,104 @@ NetworkReplyString ServerConnection::Send(const String& message)
 
 NetworkReplyMessage ServerConnection::Send(const Message& message)
 {
-    NetworkReplyMessage output{SendResult::ERROR_SENDING, nullptr};
-    output.second.reset(new Message);
+    return SendAsync(message).get();
+}
 
-    OT_ASSERT(output.second);
+std::future<NetworkReplyRaw> ServerConnection::SendAsync(
+    const std::string& message)
+{
+    const std::uint64_t tag = ++next_tag_;
+    std::future<NetworkReplyRaw> output;
 
-    String input;
-    message.SaveContractRaw(input);
-    auto rawOutput = Send(input);
-    output.first = rawOutput.first;
+    {
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        output = Queue(tag).promise_.get_future();
+    }
 
-    if (SendResult::HAVE_REPLY == output.first) {
-        output.second->LoadContractFromString(*rawOutput.second);
+    Submit(tag, message);
+
+    return output;
+}
+
+// Hands a request whose Pending entry already exists to the I/O thread
+void ServerConnection::Submit(
+    const std::uint64_t tag,
+    const std::string& message)
+{
+    zmsg_t* request = zmsg_new();
+
+    OT_ASSERT(nullptr != request);
+
+    zmsg_addmem(request, &tag, sizeof(tag));
+    zmsg_addmem(request, nullptr, 0);
+    zmsg_addmem(request, message.data(), message.size());
+
+    OT_ASSERT(lock_);
+
+    bool queued = false;
+
+    {
+        std::lock_guard<std::mutex> lock(*lock_);
+        queued = (0 == zmsg_send(&request, push_socket_));
+    }
+
+    if (!queued) {
+        zmsg_destroy(&request);
+        Finish(tag, SendResult::ERROR_SENDING);
+    }
+}
+
+std::future<NetworkReplyMessage> ServerConnection::SendAsync(
+    const Message& message)
+{
+    std::string wire;
+
+    if (message.Binary()) {
+        message.SerializeBinary(wire);
+    } else {
+        String input;
+        message.SaveContractRaw(input);
+        OTASCIIArmor envelope(input);
+
+        if (envelope.Exists()) { wire.assign(envelope.Get()); }
+    }
+
+    if (wire.empty()) {
+        std::promise<NetworkReplyMessage> promise;
+        NetworkReplyMessage output{SendResult::ERROR_SENDING, nullptr};
+        output.second.reset(new Message);
+        promise.set_value(std::move(output));
+
+        return promise.get_future();
     }
 
+    // The reply is decoded by the I/O thread when it arrives
+    const std::uint64_t tag = ++next_tag_;
+    std::future<NetworkReplyMessage> output;
+
+    {
+        std::lock_guard<std::mutex> lock(pending_lock_);
+        auto& pending = Queue(tag);
+        pending.message_ = true;
+        output = pending.message_promise_.get_future();
+    }
+
+    Submit(tag, wire);
+
     return output;
 }
 
+void ServerConnection::EnableBinary()
+{
+    if (!binary_allowed_) { return; }
+
+    if (!binary_.exchange(true)) {
+        otInfo << __FUNCTION__ << ": " << remote_endpoint_
+               << " accepts binary messages. Switching to binary requests."
+               << std::endl;
+    }
+}
+
 void ServerConnection::SetRemoteKey()
 {
     zsock_set_curve_serverkey_bin(
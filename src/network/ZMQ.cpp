@@ -118,11 +118,25 @@ void ZMQ::Init()
         notUsed);
     keep_alive_.store(std::chrono::seconds(keepAlive));
 
+    config_.CheckSet_bool(
+        "Connection",
+        "binary_messages",
+        false,
+        binary_messages_,
+        notUsed,
+        "Send requests in the binary encoding to servers which advertise "
+        "support for it. Other servers are sent armored requests.");
+
     if (configChecked && haveSocksConfig && socks.Exists()) {
         socks_proxy_ = socks.Get();
     }
 }
 
+bool ZMQ::BinaryMessages() const
+{
+    return binary_messages_;
+}
+
 std::chrono::seconds ZMQ::KeepAlive() const
 {
     return keep_alive_.load();
@@ -159,7 +173,8 @@ ServerConnection& ZMQ::Server(const std::string& id)
     auto& connection = server_connections_[id];
 
     if (!connection) {
-        connection.reset(new ServerConnection(id, shutdown_, keep_alive_));
+        connection.reset(new ServerConnection(
+            id, shutdown_, keep_alive_, binary_messages_));
     }
 
     OT_ASSERT(connection);
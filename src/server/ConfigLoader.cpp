@@ -41,6 +41,7 @@
 #include "opentxs/api/OT.hpp"
 #include "opentxs/api/Settings.hpp"
 #include "opentxs/core/cron/OTCron.hpp"
+#include "opentxs/core/crypto/OTASCIIArmor.hpp"
 #include "opentxs/core/crypto/OTCachedKey.hpp"
 #include "opentxs/core/crypto/OTKeyring.hpp"
 #include "opentxs/core/util/Assert.hpp"
@@ -79,6 +80,16 @@ bool ConfigLoader::load(String& walletFilename)
         Log::SetLogLevel(static_cast<int32_t>(lValue));
     }
 
+    // ARMOR COMPRESSION (none, fast, best)
+    {
+        bool bIsNewKey = false;
+        String strValue;
+        OT::App().Config().CheckSet_str("armor", "compression", "best",
+                               strValue, bIsNewKey);
+        OTASCIIArmor::SetCompression(
+            OTASCIIArmor::ParseCompression(strValue.Get()));
+    }
+
     // WALLET
 
     // WALLET FILENAME
@@ -177,6 +188,32 @@ bool ConfigLoader::load(String& walletFilename)
             static_cast<int32_t>(lValue));
     }
 
+    // WORKERS
+
+    {
+        const char* szComment = ";; WORKERS\n";
+
+        bool bSectionExist = false;
+        OT::App().Config().CheckSetSection("workers", szComment, bSectionExist);
+    }
+
+    {
+        const char* szComment = "; threads is the number of threads which "
+                                "process client requests in parallel.\n";
+
+        bool bIsNewKey = false;
+        std::int64_t lValue = 0;
+        OT::App().Config().CheckSet_long("workers", "threads",
+                                ServerSettings::GetWorkerThreads(), lValue,
+                                bIsNewKey, szComment);
+
+        if (1 > lValue) {
+            lValue = 1;
+        }
+
+        ServerSettings::SetWorkerThreads(static_cast<int32_t>(lValue));
+    }
+
     // PERMISSIONS
 
     {
@@ -0,0 +1,189 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+
+#include "opentxs/server/DividendCheckpoint.hpp"
+
+#include "opentxs/core/Log.hpp"
+#include "opentxs/core/OTStorage.hpp"
+#include "opentxs/core/String.hpp"
+#include "opentxs/core/crypto/OTASCIIArmor.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#define OT_DIVIDEND_CHECKPOINT_END "end"
+
+namespace opentxs
+{
+
+bool DividendCheckpoint::Parse(const std::string& record)
+{
+    std::istringstream input(record);
+    std::string line;
+
+    payouts_.clear();
+
+    while (std::getline(input, line)) {
+        if (OT_DIVIDEND_CHECKPOINT_END == line) { return true; }
+
+        const std::size_t equals = line.find('=');
+
+        if (std::string::npos == equals) { continue; }
+
+        const std::string key = line.substr(0, equals);
+        const std::string value = line.substr(equals + 1);
+
+        if ("notaryID" == key) {
+            notary_id_ = value;
+        } else if ("nymID" == key) {
+            nym_id_ = value;
+        } else if ("payoutInstrumentDefinitionID" == key) {
+            payout_instrument_definition_id_ = value;
+        } else if ("voucherAcctID" == key) {
+            voucher_acct_id_ = value;
+        } else if ("payoutPerShare" == key) {
+            payout_per_share_ = String::StringToLong(value);
+        } else if ("totalCost" == key) {
+            total_cost_ = String::StringToLong(value);
+        } else if ("leftoverNumber" == key) {
+            leftover_number_ = String::StringToLong(value);
+        } else if ("stage" == key) {
+            stage_ = static_cast<int32_t>(String::StringToLong(value));
+        } else if ("payerAcctID" == key) {
+            payer_acct_id_ = value;
+        } else if ("payerBalance" == key) {
+            payer_balance_ = String::StringToLong(value);
+        } else if ("reserveBalance" == key) {
+            reserve_balance_ = String::StringToLong(value);
+        } else if ("memo" == key) {
+            String strMemo;
+            const OTASCIIArmor ascMemo(value.c_str());
+
+            if (!value.empty() && !ascMemo.GetString(strMemo)) { return false; }
+
+            memo_ = strMemo.Get();
+        } else if ("payout" == key) {
+            Payout thePayout;
+            std::istringstream fields(value);
+
+            fields >> thePayout.recipient_ >> thePayout.amount_ >>
+                thePayout.voucher_number_ >> thePayout.receipt_number_ >>
+                thePayout.state_;
+
+            if (fields.fail()) { return false; }
+
+            payouts_.push_back(thePayout);
+        }
+    }
+
+    return false;
+}
+
+std::string DividendCheckpoint::Serialize() const
+{
+    // The memo is kept armored, on one line.
+    std::string memo;
+
+    if (!memo_.empty()) {
+        OTASCIIArmor ascMemo;
+        ascMemo.SetString(String(memo_));
+        memo = ascMemo.Get();
+        memo.erase(std::remove(memo.begin(), memo.end(), '\n'), memo.end());
+    }
+
+    std::ostringstream record;
+    record << "notaryID=" << notary_id_ << "\n"
+           << "nymID=" << nym_id_ << "\n"
+           << "payoutInstrumentDefinitionID="
+           << payout_instrument_definition_id_ << "\n"
+           << "voucherAcctID=" << voucher_acct_id_ << "\n"
+           << "payoutPerShare=" << payout_per_share_ << "\n"
+           << "totalCost=" << total_cost_ << "\n"
+           << "leftoverNumber=" << leftover_number_ << "\n"
+           << "stage=" << stage_ << "\n"
+           << "payerAcctID=" << payer_acct_id_ << "\n"
+           << "payerBalance=" << payer_balance_ << "\n"
+           << "reserveBalance=" << reserve_balance_ << "\n"
+           << "memo=" << memo << "\n";
+
+    for (const auto& it : payouts_) {
+        record << "payout=" << it.recipient_ << " " << it.amount_ << " "
+               << it.voucher_number_ << " " << it.receipt_number_ << " "
+               << it.state_ << "\n";
+    }
+
+    record << OT_DIVIDEND_CHECKPOINT_END << "\n";
+
+    return record.str();
+}
+
+bool DividendCheckpoint::Load(const std::string& filename)
+{
+    if (!OTDB::Exists(".", filename)) { return false; }
+
+    return Parse(OTDB::QueryPlainString(".", filename));
+}
+
+bool DividendCheckpoint::Save(const std::string& filename) const
+{
+    const std::string temp = filename + ".tmp";
+
+    if (!OTDB::StorePlainString(Serialize(), ".", temp)) {
+        otErr << __FUNCTION__ << ": Failed to write " << temp << "\n";
+        return false;
+    }
+
+    std::string tempPath, path;
+
+    if ((0 > OTDB::FormPathString(tempPath, ".", temp)) ||
+        (0 > OTDB::FormPathString(path, ".", filename))) {
+        otErr << __FUNCTION__ << ": Failed to locate " << filename << "\n";
+        return false;
+    }
+
+    if (0 != std::rename(tempPath.c_str(), path.c_str())) {
+        otErr << __FUNCTION__ << ": Failed to replace " << path << "\n";
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace opentxs
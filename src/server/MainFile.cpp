@@ -70,6 +70,7 @@ namespace opentxs
 
 MainFile::MainFile(OTServer* server)
     : version_()
+    , transaction_number_slot_(0)
     , server_(server)
 {
 }
@@ -84,7 +85,7 @@ bool MainFile::SaveMainFileToString(String& strMainFile)
     tag.add_attribute("notaryID", server_->m_strNotaryID.Get());
     tag.add_attribute("serverNymID", server_->m_strServerNymID.Get());
     tag.add_attribute("transactionNum",
-                      formatLong(server_->transactor_.transactionNumber()));
+                      formatLong(server_->transactor_.reservedNumber()));
 
     if (OTCachedKey::It()->IsGenerated()) // If it exists, then serialize it.
     {
@@ -181,6 +182,83 @@ bool MainFile::SaveMainFile()
     return bSaved;
 }
 
+std::string MainFile::transaction_number_filename(const int slot) const
+{
+    String filename;
+    filename.Format(
+        "%s.transactionNum.%d", server_->m_strWalletFilename.Get(), slot);
+
+    return filename.Get();
+}
+
+bool MainFile::LoadTransactionNumber(int64_t& number)
+{
+    bool found = false;
+    number = 0;
+
+    for (int slot = 0; slot < TRANSACTION_NUMBER_SLOTS; ++slot) {
+        const std::string filename = transaction_number_filename(slot);
+
+        if (!OTDB::Exists(".", filename)) {
+            continue;
+        }
+
+        const std::string record = OTDB::QueryPlainString(".", filename);
+
+        // A complete record is "transactionNum=<number>\n". Anything else
+        // is the remains of an interrupted write.
+        const std::string prefix = "transactionNum=";
+
+        if ((record.size() <= prefix.size() + 1) ||
+            (0 != record.compare(0, prefix.size(), prefix)) ||
+            ('\n' != record.back())) {
+            Log::vError(
+                "%s: Ignoring incomplete record %s.\n",
+                __FUNCTION__,
+                filename.c_str());
+
+            continue;
+        }
+
+        const String value(
+            record.substr(prefix.size(), record.size() - prefix.size() - 1));
+        const int64_t slotNumber = value.ToLong();
+
+        if (slotNumber > number) {
+            number = slotNumber;
+            // Never overwrite the slot holding the newest value first.
+            transaction_number_slot_ = (slot + 1) % TRANSACTION_NUMBER_SLOTS;
+        }
+
+        found = true;
+    }
+
+    return found;
+}
+
+bool MainFile::SaveTransactionNumber(const int64_t number)
+{
+    const int slot = transaction_number_slot_;
+    String record;
+    record.Format("transactionNum=%" PRId64 "\n", number);
+
+    const bool bSaved = OTDB::StorePlainString(
+        record.Get(), ".", transaction_number_filename(slot));
+
+    if (!bSaved) {
+        Log::vError(
+            "%s: Error saving transaction number record: %s\n",
+            __FUNCTION__,
+            transaction_number_filename(slot).c_str());
+
+        return false;
+    }
+
+    transaction_number_slot_ = (slot + 1) % TRANSACTION_NUMBER_SLOTS;
+
+    return true;
+}
+
 bool MainFile::CreateMainFile(const std::string& strContract,
                               const std::string& strNotaryID,
                               const std::string& strCert,
@@ -456,6 +534,21 @@ bool MainFile::LoadMainFile(bool bReadOnly)
             }
         }
     }
+    // The main file only holds the transaction number as of its last save.
+    // Numbers reserved since then are recorded separately.
+    int64_t lReservedNumber = 0;
+
+    if (LoadTransactionNumber(lReservedNumber) &&
+        (lReservedNumber > server_->transactor_.transactionNumber())) {
+        server_->transactor_.transactionNumber(lReservedNumber);
+
+        Log::vOutput(
+            0,
+            "%s: Skipping to reserved transaction number: %" PRId64 "\n",
+            __FUNCTION__,
+            lReservedNumber);
+    }
+
     if (!bReadOnly) {
         {
             if (bNeedToSaveAgain)
@@ -48,30 +48,94 @@
 #include "opentxs/server/ClientConnection.hpp"
 #include "opentxs/server/OTServer.hpp"
 #include "opentxs/server/ServerLoader.hpp"
+#include "opentxs/server/ServerSettings.hpp"
 #include "opentxs/server/UserCommandProcessor.hpp"
 
 #include <stddef.h>
 #include <sys/types.h>
+#include <algorithm>
+#include <chrono>
 #include <ostream>
 #include <string>
+#include <utility>
+
+#define OT_WORKER_ENDPOINT "inproc://opentxs/server/workers"
+#define OT_WORKER_POLL_MILLISECONDS 1000
+#define OT_CRON_SLEEP_MILLISECONDS 100
+// Requests a single connection may have queued behind the one it has with a
+// worker. Any more are dropped.
+#define OT_CONNECTION_QUEUE_LIMIT 256
 
 namespace opentxs
 {
 
+namespace
+{
+// Commands which get their own timing entries
+const char* timed_commands_[] = {"pingNotary",
+                                 "registerNym",
+                                 "getRequestNumber",
+                                 "getTransactionNumbers",
+                                 "checkNym",
+                                 "sendNymMessage",
+                                 "sendNymInstrument",
+                                 "unregisterNym",
+                                 "unregisterAccount",
+                                 "registerAccount",
+                                 "registerInstrumentDefinition",
+                                 "issueBasket",
+                                 "notarizeTransaction",
+                                 "getNymbox",
+                                 "getBoxReceipt",
+                                 "getAccountData",
+                                 "processNymbox",
+                                 "processInbox",
+                                 "queryInstrumentDefinitions",
+                                 "getInstrumentDefinition",
+                                 "getMint",
+                                 "getMarketList",
+                                 "getMarketOffers",
+                                 "getMarketRecentTrades",
+                                 "getNymMarketOffers",
+                                 "triggerClause",
+                                 "usageCredits",
+                                 "registerContract",
+                                 "requestAdmin",
+                                 "addClaim"};
+const std::size_t timed_command_count_ =
+    sizeof(timed_commands_) / sizeof(timed_commands_[0]);
+} // namespace
+
 MessageProcessor::MessageProcessor(ServerLoader& loader)
     : server_(loader.getServer())
-    , zmqSocket_(zsock_new_rep(NULL))
+    , zmqSocket_(zsock_new_router(NULL))
+    , zmqBackend_(zsock_new_dealer("@" OT_WORKER_ENDPOINT))
     , zmqAuth_(zactor_new(zauth, NULL))
-    , zmqPoller_(zpoller_new(zmqSocket_, NULL))
+    , zmqPoller_(zpoller_new(zmqSocket_, zmqBackend_, NULL))
+    , shutdown_(false)
+    , cron_()
+    , workers_()
+    , connection_queue_()
+    , nym_map_lock_()
+    , nym_lock_()
+    , notary_lock_()
+    , notary_signal_()
+    , shared_count_(0)
+    , exclusive_waiting_(0)
+    , exclusive_(false)
+    , timing_(2 * (timed_command_count_ + 1))
 {
     init(loader.getPort(), loader.getTransportKey());
 }
 
 MessageProcessor::~MessageProcessor()
 {
+    stopThreads();
+    zpoller_remove(zmqPoller_, zmqBackend_);
     zpoller_remove(zmqPoller_, zmqSocket_);
     zpoller_destroy(&zmqPoller_);
     zactor_destroy(&zmqAuth_);
+    zsock_destroy(&zmqBackend_);
     zsock_destroy(&zmqSocket_);
 }
 
@@ -93,22 +157,184 @@ void MessageProcessor::init(int port, zcert_t* transportKey)
     zsock_bind(zmqSocket_, "tcp://*:%d", port);
 }
 
-void MessageProcessor::run()
+std::size_t MessageProcessor::commandIndex(const String& command)
 {
-    for (;;) {
-        // timeout is the time left until the next cron should execute.
-        int64_t timeout = server_->computeTimeout();
-        if (timeout <= 0) {
-            server_->ProcessCron();
-            continue;
+    for (std::size_t i = 0; i < timed_command_count_; ++i) {
+        if (command.Compare(timed_commands_[i])) { return i; }
+    }
+
+    return timed_command_count_;
+}
+
+// Commands which do not modify any state belonging to another nym, and
+// which cron does not touch. These only need to be serialized against other
+// requests from the same nym.
+bool MessageProcessor::isSharedCommand(const String& command)
+{
+    return command.Compare("pingNotary") ||
+           command.Compare("getRequestNumber") ||
+           command.Compare("checkNym") ||
+           command.Compare("getNymbox") ||
+           command.Compare("getBoxReceipt") ||
+           command.Compare("getAccountData") ||
+           command.Compare("queryInstrumentDefinitions") ||
+           command.Compare("getInstrumentDefinition") ||
+           command.Compare("getMint") ||
+           command.Compare("getMarketList") ||
+           command.Compare("getMarketOffers") ||
+           command.Compare("getMarketRecentTrades") ||
+           command.Compare("getNymMarketOffers");
+}
+
+void MessageProcessor::lockExclusive()
+{
+    Lock lock(notary_lock_);
+    ++exclusive_waiting_;
+    notary_signal_.wait(
+        lock, [&] { return (false == exclusive_) && (0 == shared_count_); });
+    --exclusive_waiting_;
+    exclusive_ = true;
+}
+
+void MessageProcessor::lockShared()
+{
+    Lock lock(notary_lock_);
+    // Pending exclusive requests go first so that a steady stream of queries
+    // can not starve cron or transactions.
+    notary_signal_.wait(
+        lock, [&] { return (false == exclusive_) && (0 == exclusive_waiting_); });
+    ++shared_count_;
+}
+
+void MessageProcessor::unlockExclusive()
+{
+    Lock lock(notary_lock_);
+    exclusive_ = false;
+    lock.unlock();
+    notary_signal_.notify_all();
+}
+
+void MessageProcessor::unlockShared()
+{
+    Lock lock(notary_lock_);
+    --shared_count_;
+    lock.unlock();
+    notary_signal_.notify_all();
+}
+
+MessageProcessor::NymGuard::NymGuard(
+    MessageProcessor& parent,
+    const std::string& nymID)
+    : parent_(parent)
+    , nym_id_(nymID)
+{
+    Lock map_lock(parent_.nym_map_lock_);
+    lock_ = &parent_.nym_lock_[nym_id_];
+    ++lock_->users_;
+    map_lock.unlock();
+
+    lock_->mutex_.lock();
+}
+
+MessageProcessor::NymGuard::~NymGuard()
+{
+    lock_->mutex_.unlock();
+
+    Lock map_lock(parent_.nym_map_lock_);
+
+    if (0 == --lock_->users_) {
+        parent_.nym_lock_.erase(nym_id_);
+    }
+}
+
+MessageProcessor::NotaryGuard::NotaryGuard(
+    MessageProcessor& parent,
+    const bool exclusive)
+    : parent_(parent)
+    , exclusive_(exclusive)
+{
+    if (exclusive_) {
+        parent_.lockExclusive();
+    } else {
+        parent_.lockShared();
+    }
+}
+
+MessageProcessor::NotaryGuard::~NotaryGuard()
+{
+    if (exclusive_) {
+        parent_.unlockExclusive();
+    } else {
+        parent_.unlockShared();
+    }
+}
+
+void MessageProcessor::startThreads()
+{
+    if (cron_) {
+        return;
+    }
+
+    cron_.reset(new std::thread(&MessageProcessor::runCron, this));
+
+    const auto count = std::max(1, ServerSettings::GetWorkerThreads());
+
+    for (int32_t i = 0; i < count; ++i) {
+        workers_.emplace_back(
+            new std::thread(&MessageProcessor::runWorker, this));
+    }
+
+    Log::vOutput(0, "MessageProcessor: started %d worker threads.\n", count);
+}
+
+void MessageProcessor::stopThreads()
+{
+    shutdown_.store(true);
+
+    for (auto& worker : workers_) {
+        if (worker && worker->joinable()) {
+            worker->join();
         }
+    }
+
+    workers_.clear();
+
+    if (cron_ && cron_->joinable()) {
+        cron_->join();
+    }
+
+    cron_.reset();
+}
+
+void MessageProcessor::run()
+{
+    startThreads();
+
+    // Shuttle requests from clients to the workers, and replies from the
+    // workers back to the clients. The envelope added by the ROUTER socket
+    // routes each reply to the client which sent the request. Pipelining
+    // (DEALER) clients put a request tag in front of the envelope delimiter,
+    // which the REP workers echo back along with the rest of the envelope.
+    while (!shutdown_.load()) {
+        auto socket = static_cast<zsock_t*>(
+            zpoller_wait(zmqPoller_, OT_WORKER_POLL_MILLISECONDS));
+
+        if (nullptr != socket) {
+            zmsg_t* message = zmsg_recv(socket);
+
+            if (nullptr == message) {
+                continue;
+            }
+
+            if (zmqSocket_ == socket) {
+                queueRequest(message);
+            } else {
+                forwardReply(message);
+            }
 
-        // wait for incoming message or up to timeout,
-        // i.e. stop polling in time for the next cron execution.
-        if (zpoller_wait(zmqPoller_, timeout)) {
-            processSocket();
             continue;
         }
+
         if (zpoller_terminated(zmqPoller_)) {
             otErr << __FUNCTION__
                   << ": zpoller_terminated - process interrupted or"
@@ -119,20 +345,167 @@ void MessageProcessor::run()
         if (!zpoller_expired(zmqPoller_)) {
             otErr << __FUNCTION__ << ": zpoller_wait error\n";
         }
+    }
+
+    for (auto& it : connection_queue_) {
+        for (auto& message : it.second) {
+            zmsg_destroy(&message);
+        }
+    }
+
+    connection_queue_.clear();
+    stopThreads();
+}
+
+// The ROUTER socket puts the identity of the sending connection in the first
+// frame of every request, and the workers echo it back in their replies.
+std::string MessageProcessor::connectionID(zmsg_t* message)
+{
+    zframe_t* identity = zmsg_first(message);
+
+    if (nullptr == identity) {
+
+        return "";
+    }
+
+    return std::string(
+        reinterpret_cast<const char*>(zframe_data(identity)),
+        zframe_size(identity));
+}
+
+void MessageProcessor::forwardReply(zmsg_t* message)
+{
+    const auto connection = connectionID(message);
+
+    if (0 != zmsg_send(&message, zmqSocket_)) {
+        otErr << __FUNCTION__ << ": failed to forward reply\n";
+        zmsg_destroy(&message);
+    }
+
+    forwardQueued(connection);
+}
+
+// Hands the next queued request from this connection to a worker, or
+// forgets the connection if it has nothing else queued.
+void MessageProcessor::forwardQueued(const std::string& connection)
+{
+    auto it = connection_queue_.find(connection);
+
+    while (connection_queue_.end() != it) {
+        if (it->second.empty()) {
+            connection_queue_.erase(it);
+
+            return;
+        }
+
+        zmsg_t* next = it->second.front();
+        it->second.pop_front();
+
+        if (0 == zmsg_send(&next, zmqBackend_)) {
+
+            return;
+        }
+
+        otErr << __FUNCTION__ << ": failed to forward request\n";
+        zmsg_destroy(&next);
+    }
+}
+
+void MessageProcessor::queueRequest(zmsg_t* message)
+{
+    const auto connection = connectionID(message);
+    auto it = connection_queue_.find(connection);
+
+    // A request is already with a worker, so this one waits its turn here
+    // instead of occupying a second worker.
+    if (connection_queue_.end() != it) {
+        if (OT_CONNECTION_QUEUE_LIMIT <= it->second.size()) {
+            otErr << __FUNCTION__ << ": too many queued requests from one "
+                  << "connection. Dropping request.\n";
+            zmsg_destroy(&message);
+
+            return;
+        }
+
+        it->second.push_back(message);
+
+        return;
+    }
+
+    if (0 != zmsg_send(&message, zmqBackend_)) {
+        otErr << __FUNCTION__ << ": failed to forward request\n";
+        zmsg_destroy(&message);
+
+        return;
+    }
+
+    connection_queue_[connection];
+}
+
+void MessageProcessor::runCron()
+{
+    while (!shutdown_.load()) {
+        // timeout is the time left until the next cron should execute.
+        int64_t timeout{0};
+
+        {
+            NotaryGuard notary(*this, false);
+            timeout = server_->computeTimeout();
+        }
+
+        if (timeout <= 0) {
+            NotaryGuard notary(*this, true);
+            server_->ProcessCron();
+
+            continue;
+        }
 
-        Log::Sleep(std::chrono::milliseconds(100));
+        Log::Sleep(std::chrono::milliseconds(
+            std::min<int64_t>(timeout, OT_CRON_SLEEP_MILLISECONDS)));
     }
 }
 
-void MessageProcessor::processSocket()
+void MessageProcessor::runWorker()
 {
-    char* msg = zstr_recv(zmqSocket_);
-    if (msg == nullptr) {
+    zsock_t* socket = zsock_new_rep(">" OT_WORKER_ENDPOINT);
+
+    if (nullptr == socket) {
+        otErr << __FUNCTION__ << ": failed to connect worker socket\n";
+
+        return;
+    }
+
+    zpoller_t* poller = zpoller_new(socket, NULL);
+
+    while (!shutdown_.load()) {
+        if (nullptr != zpoller_wait(poller, OT_WORKER_POLL_MILLISECONDS)) {
+            processSocket(socket);
+
+            continue;
+        }
+
+        if (zpoller_terminated(poller)) {
+            break;
+        }
+    }
+
+    zpoller_remove(poller, socket);
+    zpoller_destroy(&poller);
+    zsock_destroy(&socket);
+}
+
+void MessageProcessor::processSocket(zsock_t* socket)
+{
+    // Binary requests may contain zero bytes, so the frame is read as-is
+    // rather than as a C string.
+    zframe_t* frame = zframe_recv(socket);
+    if (frame == nullptr) {
         Log::Error("zeromq recv() failed\n");
         return;
     }
-    std::string requestString(msg);
-    zstr_free(&msg);
+    std::string requestString(
+        reinterpret_cast<const char*>(zframe_data(frame)), zframe_size(frame));
+    zframe_destroy(&frame);
 
     std::string responseString;
 
@@ -142,7 +515,9 @@ void MessageProcessor::processSocket()
         responseString = "";
     }
 
-    int rc = zstr_send(zmqSocket_, responseString.c_str());
+    zframe_t* reply =
+        zframe_new(responseString.data(), responseString.size());
+    int rc = zframe_send(&reply, socket, 0);
 
     if (rc != 0) {
         Log::vError("MessageProcessor: failed to send response\n"
@@ -152,30 +527,70 @@ void MessageProcessor::processSocket()
     }
 }
 
+void MessageProcessor::recordTiming(
+    const String& command,
+    const bool binary,
+    const std::chrono::microseconds parse,
+    const std::chrono::microseconds serialize)
+{
+    const auto index = commandIndex(command);
+    auto& timing = timing_[2 * index + (binary ? 1 : 0)];
+    const auto count = timing.count_.fetch_add(1) + 1;
+    const auto totalParse = timing.parse_.fetch_add(parse.count()) +
+                            parse.count();
+    const auto totalSerialize =
+        timing.serialize_.fetch_add(serialize.count()) + serialize.count();
+
+    otInfo << "MessageProcessor: "
+           << ((timed_command_count_ == index) ? "(unknown command)"
+                                               : timed_commands_[index])
+           << " (" << (binary ? "binary" : "armored") << "): parse "
+           << parse.count() << "us, serialize " << serialize.count()
+           << "us. Average over " << count << ": parse "
+           << (totalParse / count) << "us, serialize "
+           << (totalSerialize / count) << "us." << std::endl;
+}
+
 bool MessageProcessor::processMessage(const std::string& messageString,
                                       std::string& reply)
 {
     if (messageString.size() < 1) return false;
 
-    // First we grab the client's message
-    OTASCIIArmor ascMessage;
-    ascMessage.MemSet(messageString.data(), messageString.size());
-
-    String messageContents;
-    ascMessage.GetString(messageContents);
-    // All decrypted--now let's load the results into an OTMessage.
-    // No need to call message.ParseRawFile() after, since
-    // LoadContractFromString handles it.
+    // Replies go out in the same encoding as the request.
+    const bool binary = Message::IsBinary(messageString);
+    const auto parseStart = std::chrono::steady_clock::now();
     Message message;
-    if (!messageContents.Exists() ||
-        !message.LoadContractFromString(messageContents)) {
-        Log::vError("Error loading message from message "
-                    "contents:\n\n%s\n\n",
-                    messageContents.Get());
-        return true;
+
+    if (binary) {
+        if (!message.LoadBinary(messageString)) {
+            Log::vError("Error loading binary message (%zu bytes).\n",
+                        messageString.size());
+            return true;
+        }
+    } else {
+        // First we grab the client's message
+        OTASCIIArmor ascMessage;
+        ascMessage.MemSet(messageString.data(), messageString.size());
+
+        String messageContents;
+        ascMessage.GetString(messageContents);
+        // All decrypted--now let's load the results into an OTMessage.
+        // No need to call message.ParseRawFile() after, since
+        // LoadContractFromString handles it.
+        if (!messageContents.Exists() ||
+            !message.LoadContractFromString(messageContents)) {
+            Log::vError("Error loading message from message "
+                        "contents:\n\n%s\n\n",
+                        messageContents.Get());
+            return true;
+        }
     }
 
+    const auto parse = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - parseStart);
+
     Message replyMessage;
+    replyMessage.SetBinary(binary);
     replyMessage.m_strCommand.Format("%sResponse", message.m_strCommand.Get());
     // NymID
     replyMessage.m_strNymID = message.m_strNymID;
@@ -183,76 +598,112 @@ bool MessageProcessor::processMessage(const std::string& messageString,
     replyMessage.m_strNotaryID = message.m_strNotaryID;
     // The default reply. In fact this is probably superfluous
     replyMessage.m_bSuccess = false;
+    // Lets clients know that they may send binary requests from now on
+    replyMessage.m_bBinaryMessages = true;
 
     ClientConnection client;
 
-    bool processedUserCmd = server_->userCommandProcessor_.ProcessUserCommand(
-        message, replyMessage, &client);
-
-    // By optionally passing in &client, the client Nym's public
-    // key will be set on it whenever verification is complete. (So
-    // for the reply, I'll  have the key and thus I'll be able to
-    // encrypt reply to the recipient.)
-    if (!processedUserCmd) {
-        String s1(message);
-
-        Log::vOutput(0, "Unable to process user command: %s\n ********** "
-                        "REQUEST:\n\n%s\n\n",
-                     message.m_strCommand.Get(), s1.Get());
-
-        // NOTE: normally you would even HAVE a true or false if
-        // we're in this block. ProcessUserCommand()
-        // is what tries to process a command and then sets false
-        // if/when it fails. Until that point, you
-        // wouldn't get any server reply.  I'm now changing this
-        // slightly, so you still get a reply (defaulted
-        // to success==false.) That way if a client needs to re-sync
-        // his request number, he will get the false
-        // and therefore know to resync the # as his next move, vs
-        // being stuck with no server reply (and thus
-        // stuck with a bad socket.)
-        // We sign the reply here, but not in the else block, since
-        // it's already signed in cases where
-        // ProcessUserCommand() is a success, by the time that call
-        // returns.
-
-        // Since the process call definitely failed, I'm
-        replyMessage.m_bSuccess = false;
-        // making sure this here is definitely set to
-        // false (even though it probably was already.)
-        replyMessage.SignContract(server_->GetServerNym());
-        replyMessage.SaveContract();
-
-        String s2(replyMessage);
-
-        Log::vOutput(0, " ********** RESPONSE:\n\n%s\n\n", s2.Get());
-    }
-    else {
-        // At this point the reply is ready to go, and client
-        // has the public key of the recipient...
-        Log::vOutput(1, "Successfully processed user command: %s.\n",
-                     message.m_strCommand.Get());
-    }
+    {
+        // Requests from the same nym must be processed one at a time, so
+        // each nym only gets one worker at a time.
+        NymGuard nym(*this, message.m_strNymID.Get());
+        const bool shared = isSharedCommand(message.m_strCommand);
+        NotaryGuard notary(*this, !shared);
+
+        // Exclusive commands have the server to themselves, and the dividend
+        // workers they may start take the server nym lock on their own.
+        bool processedUserCmd = server_->userCommandProcessor_.ProcessUserCommand(
+            message,
+            replyMessage,
+            &client,
+            shared ? &server_->server_nym_lock_ : nullptr);
+
+        // By optionally passing in &client, the client Nym's public
+        // key will be set on it whenever verification is complete. (So
+        // for the reply, I'll  have the key and thus I'll be able to
+        // encrypt reply to the recipient.)
+        if (!processedUserCmd) {
+            String s1(message);
+
+            Log::vOutput(0, "Unable to process user command: %s\n ********** "
+                            "REQUEST:\n\n%s\n\n",
+                         message.m_strCommand.Get(), s1.Get());
+
+            // NOTE: normally you would even HAVE a true or false if
+            // we're in this block. ProcessUserCommand()
+            // is what tries to process a command and then sets false
+            // if/when it fails. Until that point, you
+            // wouldn't get any server reply.  I'm now changing this
+            // slightly, so you still get a reply (defaulted
+            // to success==false.) That way if a client needs to re-sync
+            // his request number, he will get the false
+            // and therefore know to resync the # as his next move, vs
+            // being stuck with no server reply (and thus
+            // stuck with a bad socket.)
+            // We sign the reply here, but not in the else block, since
+            // it's already signed in cases where
+            // ProcessUserCommand() is a success, by the time that call
+            // returns.
+
+            // Since the process call definitely failed, I'm
+            replyMessage.m_bSuccess = false;
+            // making sure this here is definitely set to
+            // false (even though it probably was already.)
+            {
+                std::lock_guard<std::mutex> lock(server_->server_nym_lock_);
+                replyMessage.SignContract(server_->GetServerNym());
+            }
+
+            replyMessage.SaveContract();
+
+            String s2(replyMessage);
+
+            Log::vOutput(0, " ********** RESPONSE:\n\n%s\n\n", s2.Get());
+        }
+        else {
+            // At this point the reply is ready to go, and client
+            // has the public key of the recipient...
+            Log::vOutput(1, "Successfully processed user command: %s.\n",
+                         message.m_strCommand.Get());
+        }
+    }  // Release the notary and nym locks before encoding the reply.
 
-    String replyString(replyMessage);
+    const auto serializeStart = std::chrono::steady_clock::now();
 
-    if (!replyString.Exists()) {
-        Log::vOutput(0, "Failed trying to grab the reply "
-                        "in OTString form. "
-                        "(No reply message will be sent.)\n");
-        return true;
-    }
+    if (binary) {
+        if (!replyMessage.SerializeBinary(reply)) {
+            Log::vOutput(0, "Unable to serialize binary reply. (No reply "
+                            "message will be sent.)\n");
+            return true;
+        }
+    } else {
+        String replyString(replyMessage);
+
+        if (!replyString.Exists()) {
+            Log::vOutput(0, "Failed trying to grab the reply "
+                            "in OTString form. "
+                            "(No reply message will be sent.)\n");
+            return true;
+        }
 
-    OTASCIIArmor ascReply(replyString);
+        OTASCIIArmor ascReply(replyString);
+
+        if (!ascReply.Exists()) {
+            Log::vOutput(0, "Unable to WriteArmoredString from "
+                            "OTASCIIArmor object into OTString object. (No "
+                            "reply message will be sent.)\n");
+            return true;
+        }
 
-    if (!ascReply.Exists()) {
-        Log::vOutput(0, "Unable to WriteArmoredString from "
-                        "OTASCIIArmor object into OTString object. (No reply "
-                        "message will be sent.)\n");
-        return true;
+        reply.assign(ascReply.Get(), ascReply.GetLength());
     }
 
-    reply.assign(ascReply.Get(), ascReply.GetLength());
+    recordTiming(
+        message.m_strCommand,
+        binary,
+        parse,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - serializeStart));
 
     return false;
 }
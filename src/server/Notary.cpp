@@ -40,6 +40,7 @@
 
 #include "opentxs/cash/Mint.hpp"
 #include "opentxs/cash/Purse.hpp"
+#include "opentxs/cash/SpentTokens.hpp"
 #include "opentxs/cash/Token.hpp"
 #include "opentxs/api/OT.hpp"
 #include "opentxs/api/Wallet.hpp"
@@ -78,10 +79,12 @@
 #include <cstdint>
 #include <deque>
 #include <list>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace opentxs
 {
@@ -1124,6 +1127,7 @@ void Notary::NotarizeWithdrawal(
             Purse theOutputPurse(NOTARY_ID, INSTRUMENT_DEFINITION_ID);
             Token* pToken = nullptr;
             dequeOfTokenPtrs theDeque;
+            std::map<Mint*, std::vector<Token*>> tokensByMint;
 
             bool bSuccess = false;
             bool bLoadContractFromString =
@@ -1203,8 +1207,6 @@ void Notary::NotarizeWithdrawal(
                         bSuccess = false;
                         break;  // Once there's a failure, we ditch the loop.
                     } else {
-                        String theStringReturnVal;
-
                         if (pToken->GetInstrumentDefinitionID() !=
                             INSTRUMENT_DEFINITION_ID) {
                             const String str1(
@@ -1221,111 +1223,112 @@ void Notary::NotarizeWithdrawal(
                                 str1.Get());
                             break;
                         }
-                        // TokenIndex is for cash systems that send multiple
-                        // proto-tokens, so the Mint
-                        // knows which proto-token has been chosen for signing.
-                        // But Lucre only uses a single proto-token, so the
-                        // token index is always 0.
-                        //
-                        else if (
-                            !(pMint->SignToken(
-                                server_->m_nymServer,
-                                *pToken,
-                                theStringReturnVal,
-                                0)))  // nTokenIndex = 0 //
-                        // ******************************************
-                        {
-                            bSuccess = false;
+                        else {
+                            // The prototoken is blind-signed further down,
+                            // together with the rest of the withdrawal, and
+                            // only then is the account debited for it.
+                            tokensByMint[pMint].push_back(pToken);
+                            bSuccess = true;
+                        }
+                    }
+                }  // While success popping token out of the purse...
+
+                // Blind-sign all the prototokens in one batch per mint,
+                // instead of one at a time inside the loop above.
+                if (bSuccess) {
+                    for (auto& it : tokensByMint) {
+                        if (!it.first->SignTokens(
+                                server_->m_nymServer, it.second)) {
                             Log::vError(
-                                "%s: Failure in call: "
-                                "pMint->SignToken(server_->m_nymServer, "
-                                "*pToken, theStringReturnVal, 0). "
-                                "(Returning.)\n",
+                                "%s: Failed to sign the prototokens in "
+                                "the withdrawal purse.\n",
                                 __FUNCTION__);
+                            bSuccess = false;
                             break;
-                        } else {
-                            OTASCIIArmor theArmorReturnVal(theStringReturnVal);
-
-                            pToken->ReleaseSignatures();  // this releases the
-                                                          // normal signatures,
-                            // not the Lucre signed
-                            // token from the Mint,
-                            // above.
-
-                            pToken->SetSignature(
-                                theArmorReturnVal,
-                                0);  // nTokenIndex = 0
-
-                            // Sign and Save the token
-                            pToken->SignContract(server_->m_nymServer);
-                            pToken->SaveContract();
-
-                            // Now the token is in signedToken mode, and the
-                            // other prototokens have been released.
-
-                            // Deduct the amount from the account...
-                            if (theAccount.Debit(
-                                    pToken->GetDenomination())) {  // todo need
-                                                                   // to be able
-                                                                   // to "roll
-                                                                   // back" if
-                                                                   // anything
-                                // inside this
-                                // block
-                                // fails.
-                                bSuccess = true;
+                        }
+                    }
+                }
 
-                                // Credit the server's cash account for this
-                                // instrument definition in the same
-                                // amount that was debited. When the token is
-                                // deposited again, Debit that same
-                                // server cash account and deposit in the
-                                // depositor's acct.
-                                // Why, you might ask? Because if the token
-                                // expires, the money will stay in
-                                // the bank's cash account instead of being lost
-                                // (and screwing up the overall
-                                // issuer balance, with the issued money
-                                // disappearing forever.) The bank knows
-                                // that once the series expires, whatever funds
-                                // are left in that cash account are
-                                // for the bank to keep. They can be transferred
-                                // to another account and kept, instead
-                                // of being lost.
-                                if (!pMintCashReserveAcct->Credit(
-                                        pToken->GetDenomination())) {
-                                    Log::Error(
-                                        "Error crediting mint cash "
-                                        "reserve account...\n");
+                if (bSuccess) {
+                    // Now the tokens are in signedToken mode, and the other
+                    // prototokens have been released. Sign and Save them.
+                    for (auto& pSignedToken : theDeque) {
+                        pSignedToken->SignContract(server_->m_nymServer);
+                        pSignedToken->SaveContract();
+                    }
+                }
 
-                                    // Reverse the account debit (even though
-                                    // we're not going to save it anyway.)
-                                    if (false ==
-                                        theAccount.Credit(
-                                            pToken->GetDenomination()))
-                                        Log::vError(
-                                            "%s: Failed crediting "
-                                            "user account back.\n",
-                                            __FUNCTION__);
+                // Only once every token is signed, deduct the amount from the
+                // account and credit the server's cash account for this
+                // instrument definition in the same amount. When the token is
+                // deposited again, Debit that same server cash account and
+                // deposit in the depositor's acct. Why, you might ask?
+                // Because if the token expires, the money will stay in the
+                // bank's cash account instead of being lost (and screwing up
+                // the overall issuer balance, with the issued money
+                // disappearing forever.)
+                //
+                // The reserve accounts are cached by their mints, so any
+                // credit which is not going to be saved is reversed.
+                std::map<Account*, int64_t> reserveCredits;
 
-                                    bSuccess = false;
-                                    break;
-                                }
-                            } else {
-                                bSuccess = false;
-                                Log::vOutput(
-                                    0,
-                                    "%s: Unable to debit account "
-                                    "%s in the amount of: %" PRId64 "\n",
-                                    __FUNCTION__,
-                                    strAccountID.Get(),
-                                    pToken->GetDenomination());
-                                break;  // Once there's a failure, we ditch the
-                                        // loop.
+                if (bSuccess) {
+                    for (auto& it : tokensByMint) {
+                        Account* pReserve = it.first->GetCashReserveAccount();
+                        int64_t lAmount = 0;
+
+                        for (auto& pSignedToken : it.second) {
+                            lAmount += pSignedToken->GetDenomination();
+                        }
+
+                        if (!theAccount.Debit(lAmount)) {
+                            Log::vOutput(
+                                0,
+                                "%s: Unable to debit account "
+                                "%s in the amount of: %" PRId64 "\n",
+                                __FUNCTION__,
+                                strAccountID.Get(),
+                                lAmount);
+                            bSuccess = false;
+                            break;
+                        }
+
+                        if (!pReserve->Credit(lAmount)) {
+                            Log::Error(
+                                "Error crediting mint cash "
+                                "reserve account...\n");
+
+                            if (false == theAccount.Credit(lAmount))
+                                Log::vError(
+                                    "%s: Failed crediting "
+                                    "user account back.\n",
+                                    __FUNCTION__);
+
+                            bSuccess = false;
+                            break;
+                        }
+
+                        reserveCredits[pReserve] += lAmount;
+                    }
+
+                    if (!bSuccess) {
+                        for (auto& it : reserveCredits) {
+                            if (!it.first->Debit(it.second)) {
+                                Log::vError(
+                                    "%s: Failed reversing the credit to a "
+                                    "mint cash reserve account.\n",
+                                    __FUNCTION__);
+                            }
+
+                            if (!theAccount.Credit(it.second)) {
+                                Log::vError(
+                                    "%s: Failed crediting "
+                                    "user account back.\n",
+                                    __FUNCTION__);
                             }
                         }
                     }
-                }  // While success popping token out of the purse...
+                }
 
                 if (bSuccess) {
                     while (!theDeque.empty()) {
@@ -1375,10 +1378,12 @@ void Notary::NotarizeWithdrawal(
                     // cash expires, then after the expiry period, if it remains
                     // in the account,
                     // it is now the property of the transaction server.)
-                    pMintCashReserveAcct->ReleaseSignatures();
-                    pMintCashReserveAcct->SignContract(server_->m_nymServer);
-                    pMintCashReserveAcct->SaveContract();
-                    pMintCashReserveAcct->SaveAccount();
+                    for (auto& it : reserveCredits) {
+                        it.first->ReleaseSignatures();
+                        it.first->SignContract(server_->m_nymServer);
+                        it.first->SaveContract();
+                        it.first->SaveAccount();
+                    }
 
                     // Notice if there is any failure in the above loop, then we
                     // will never enter this block.
@@ -1963,48 +1968,6 @@ void Notary::NotarizePayDividend(
                                 // accounts for that share type,
                                 // and send a voucher to the owner of each one,
                                 // to payout his dividend.
-
-                                // todo: determine whether I need to attach
-                                // anything here at all...
-                                pResponseItem->SetStatus(Item::acknowledgement);
-
-                                bOutSuccess = true;  // The paying of the
-                                // dividends was successful.
-                                //
-                                //
-                                // SAVE THE ACCOUNTS WITH THE NEW BALANCES
-                                // (FUNDS ARE MOVED)
-                                //
-                                // At this point, we save the accounts, so that
-                                // the funds transfer is solid before
-                                // we start mailing vouchers out to people.
-
-                                // Release any signatures that were there before
-                                // (They won't
-                                // verify anymore anyway, since the content has
-                                // changed.)
-                                theSourceAccount.ReleaseSignatures();
-                                theSourceAccount.SignContract(
-                                    server_->m_nymServer);        // Sign
-                                theSourceAccount.SaveContract();  // Save
-                                theSourceAccount.SaveAccount();  // Save to file
-
-                                // We also need to save the Voucher cash reserve
-                                // account.
-                                // (Any issued voucher cheque is automatically
-                                // backed by this reserve account.
-                                // If a cheque is deposited, the funds come back
-                                // out of this account. If the
-                                // cheque expires, then after the expiry period,
-                                // if it remains in the account,
-                                // it is now the property of the transaction
-                                // server.)
-                                pVoucherReserveAcct->ReleaseSignatures();
-                                pVoucherReserveAcct->SignContract(
-                                    server_->m_nymServer);
-                                pVoucherReserveAcct->SaveContract();
-                                pVoucherReserveAcct->SaveAccount();
-
                                 //
                                 // PAY THE SHAREHOLDERS
                                 //
@@ -2041,273 +2004,146 @@ void Notary::NotarizePayDividend(
                                     lAmountPerShare,
                                     &theAccounts);
 
-                                // Loops through all the accounts for a given
-                                // instrument definition
-                                // (PAYOUT_INSTRUMENT_DEFINITION_ID),
-                                // and triggers
-                                // actionPayDividend for each one. This sends
-                                // the owner nym for each, a voucher drawn on
-                                // VOUCHER_ACCOUNT_ID. (In the amount of
-                                // lAmountPerShare * number of shares in
-                                // account.)
-                                //
-                                const bool bForEachAcct =
-                                    pSharesContract->VisitAccountRecords(
-                                        actionPayDividend);  // <================
-                                                             // pay all the
-                                                             // dividends here.
-
-                                // TODO: Since the above line of code loops
-                                // through all the accounts and loads them
-                                // up, transforms them, and saves them again, we
-                                // cannot use our own loaded accounts below
-                                // this point. (They could overwrite
-                                // themselves.) theSourceAccount especially, was
-                                // passed in
-                                // from above -- so how can we possible warn the
-                                // caller than he cannot save this account
-                                // without
-                                // overwriting work we have done in this
-                                // function?
-                                //
-                                // Aside from any more elegant solution, the
-                                // only way to make it work in this case would
-                                // be to
-                                // make a map or list of all the accounts that
-                                // are already loaded in memory (such as
-                                // theSourceAccount)
-                                // and PASS THEM IN to the above
-                                // VisitAccountRecords call. This way it would
-                                // have the option to use
-                                // the "already loaded" versions, where
-                                // appropriate, instead of loading them twice.
-                                // (As it is,
-                                // theSourceAccount is not used below this
-                                // point, though we couldn't preven the caller
-                                // from using it.)
-                                //
-                                // Therefore we need to have some central system
-                                // where accounts can be loaded, locked, saved,
-                                // etc.
-                                // So we cannot ever overwrite ourselves BY
-                                // DESIGN. (And the same for other data types as
-                                // well, like Nyms.)
-                                // Todo.
-                                //
-                                if (!bForEachAcct)  // todo failsafe. Handle
-                                                    // this
-                                                    // better.
-                                {
+                                // The payout is checkpointed before either
+                                // account is saved, so that if the server
+                                // stops before the payouts are checkpointed,
+                                // the payer is refunded when it restarts.
+                                if (!actionPayDividend.Fund(
+                                        lTotalCostOfDividend,
+                                        theSourceAccount,
+                                        theVoucherReserveAcct)) {
                                     Log::vError(
-                                        "%s: ERROR: After moving funds for "
-                                        "dividend payment, there was some "
-                                        "error when sending out the vouchers "
-                                        "to the payout recipients.\n",
+                                        "%s: Unable to checkpoint the "
+                                        "dividend payout. Returning the "
+                                        "funds to the payer's account.\n",
                                         szFunc);
-                                }
-                                //
-                                // REFUND ANY LEFTOVERS
-                                //
-                                const int64_t lLeftovers =
-                                    lTotalCostOfDividend -
-                                    (actionPayDividend.GetAmountPaidOut() +
-                                     actionPayDividend.GetAmountReturned());
-                                if (lLeftovers > 0) {
-                                    // Of the total amount removed from the
-                                    // sender's account, and after paying all
-                                    // dividends,
-                                    // there was a leftover amount that wasn't
-                                    // paid to anybody. Therefore, we should pay
-                                    // it back
-                                    // to the sender himself, now.
-                                    //
-                                    Log::vOutput(
-                                        0,
-                                        "%s: After dividend payout, with "
-                                        "%" PRId64 " units removed initially, "
-                                        "there were %" PRId64
-                                        " units remaining. "
-                                        "(Returning them to sender...)\n",
-                                        szFunc,
-                                        lTotalCostOfDividend,
-                                        lLeftovers);
-                                    Cheque theVoucher(
-                                        NOTARY_ID,
-                                        PAYOUT_INSTRUMENT_DEFINITION_ID);
-
-                                    // 10 minutes ==    600 Seconds
-                                    // 1 hour    ==     3600 Seconds
-                                    // 1 day    ==    86400 Seconds
-                                    // 30 days    ==  2592000 Seconds
-                                    // 3 months ==  7776000 Seconds
-                                    // 6 months == 15552000 Seconds
-
-                                    const time64_t VALID_FROM =
-                                        OTTimeGetCurrentTime();  // This time is
-                                                                 // set to TODAY
-                                                                 // NOW
-                                    const time64_t VALID_TO =
-                                        OTTimeAddTimeInterval(
-                                            VALID_FROM,
-                                            OTTimeGetSecondsFromTime(
-                                                OT_TIME_SIX_MONTHS_IN_SECONDS));  // This time occurs in 180 days (6 months).  Todo hardcoding.
 
-                                    int64_t lNewTransactionNumber = 0;
-                                    const bool bGotNextTransNum =
-                                        server_->transactor_
-                                            .issueNextTransactionNumberToNym(
-                                                server_->m_nymServer,
-                                                lNewTransactionNumber);
-                                    // We save the
-                                    // transaction
-                                    // number on the server Nym (normally we'd
-                                    // discard it) because
-                                    // when the cheque is deposited, the server
-                                    // nym, as the owner of
-                                    // the voucher account, needs to verify the
-                                    // transaction # on the
-                                    // cheque (to prevent double-spending of
-                                    // cheques.)
-                                    if (bGotNextTransNum) {
-                                        const Identifier NOTARY_NYM_ID(
-                                            server_->m_nymServer);
-                                        const bool bIssueVoucher =
-                                            theVoucher.IssueCheque(
-                                                lLeftovers,  // The amount of
-                                                             // the
-                                                             // cheque.
-                                                lNewTransactionNumber,  // Requiring
-                                                                        // a
-                                                // transaction
-                                                // number
-                                                // prevents
-                                                // double-spending
-                                                // of
-                                                // cheques.
-                                                VALID_FROM,  // The expiration
-                                                             // date
-                                                // (valid from/to dates)
-                                                // of the cheque
-                                                VALID_TO,  // Vouchers are
-                                                // automatically starting
-                                                // today and lasting 6
-                                                // months.
-                                                VOUCHER_ACCOUNT_ID,  // The
-                                                                     // asset
-                                                // account the
-                                                // cheque is
-                                                // drawn on.
-                                                NOTARY_NYM_ID,  // Nym ID of the
-                                                // sender (in this
-                                                // case the server
-                                                // nym.)
-                                                strInReferenceTo,  // Optional
-                                                                   // memo
-                                                // field. Includes
-                                                // item note and
-                                                // request memo.
-                                                &NYM_ID);
-
-                                        // All account crediting / debiting
-                                        // happens in the caller, in OTServer.
-                                        //    (AND it happens only ONCE, to
-                                        // cover ALL vouchers.)
-                                        // Then in here, the voucher either gets
-                                        // send to the recipient, or if error,
-                                        // sent back home to
-                                        // the issuer Nym. (ALL the funds are
-                                        // removed, then the vouchers are sent
-                                        // one way or the other.)
-                                        // Any returned vouchers, obviously
-                                        // serve to notify the dividend payer of
-                                        // where the errors were
-                                        // (as well as give him the opportunity
-                                        // to get his money back.)
-                                        //
-                                        bool bSent = false;
-                                        if (bIssueVoucher) {
-                                            theVoucher.SetAsVoucher(
-                                                NOTARY_NYM_ID,
-                                                VOUCHER_ACCOUNT_ID);  // All
-                                                                      // this
-                                                                      // does is
-                                                                      // set the
-                                            // voucher's
-                                            // internal
-                                            // contract
-                                            // string
-                                            theVoucher.SignContract(
-                                                server_->m_nymServer);  // to
-                                            // "VOUCHER"
-                                            // instead of
-                                            // "CHEQUE".
-                                            theVoucher.SaveContract();
-
-                                            // Send the voucher to the payments
-                                            // inbox of the recipient.
-                                            //
-                                            const String strVoucher(theVoucher);
-                                            OTPayment thePayment(strVoucher);
-
-                                            // calls DropMessageToNymbox
-                                            bSent =
-                                                server_->SendInstrumentToNym(
-                                                    NOTARY_ID,
-                                                    NOTARY_NYM_ID,  // sender
-                                                                    // nym
-                                                    NYM_ID,  // recipient nym
-                                                             // (returning to
-                                                    // original sender.)
-                                                    nullptr,
-                                                    &thePayment,
-                                                    "payDividend");  // todo:
-                                            // hardcoding.
-                                        }
-                                        // If we didn't send it, then we need to
-                                        // return the funds to where they came
-                                        // from.
-                                        //
-                                        if (!bSent) {
-                                            const String
-                                                strPayoutInstrumentDefinitionID(
-                                                    PAYOUT_INSTRUMENT_DEFINITION_ID),
-                                                strSenderNymID(NYM_ID);
-                                            Log::vError(
-                                                "%s: ERROR failed issuing "
-                                                "voucher (to return leftovers "
-                                                "back to "
-                                                "the dividend payout "
-                                                "initiator.) WAS TRYING TO PAY "
-                                                "%" PRId64 " of instrument "
-                                                "definition %s to "
-                                                "Nym "
-                                                "%s.\n",
-                                                szFunc,
-                                                lLeftovers,
-                                                strPayoutInstrumentDefinitionID
-                                                    .Get(),
-                                                strSenderNymID.Get());
-                                        }   // if !bSent
-                                    } else  // !bGotNextTransNum
+                                    if (false ==
+                                        pVoucherReserveAcct->Debit(
+                                            lTotalCostOfDividend))
+                                        Log::vError(
+                                            "%s: Failed debiting back the "
+                                            "voucher reserve account.\n",
+                                            szFunc);
+
+                                    if (false ==
+                                        theSourceAccount.Credit(
+                                            lTotalCostOfDividend))
+                                        Log::vError(
+                                            "%s: Failed crediting back the "
+                                            "user account.\n",
+                                            szFunc);
+                                } else {
+                                    pResponseItem->SetStatus(
+                                        Item::acknowledgement);
+
+                                    bOutSuccess = true;  // The paying of the
+                                    // dividends was successful.
+                                    //
+                                    //
+                                    // SAVE THE ACCOUNTS WITH THE NEW BALANCES
+                                    // (FUNDS ARE MOVED)
+                                    //
+                                    // At this point, we save the accounts, so
+                                    // that the funds transfer is solid before
+                                    // we start mailing vouchers out to people.
+
+                                    // Release any signatures that were there
+                                    // before (They won't verify anymore anyway,
+                                    // since the content has changed.)
+                                    theSourceAccount.ReleaseSignatures();
+                                    theSourceAccount.SignContract(
+                                        server_->m_nymServer);        // Sign
+                                    theSourceAccount.SaveContract();  // Save
+                                    theSourceAccount.SaveAccount();  // Save to
+                                                                     // file
+
+                                    // We also need to save the Voucher cash
+                                    // reserve account. (Any issued voucher
+                                    // cheque is automatically backed by this
+                                    // reserve account. If a cheque is
+                                    // deposited, the funds come back out of
+                                    // this account. If the cheque expires, then
+                                    // after the expiry period, if it remains in
+                                    // the account, it is now the property of
+                                    // the transaction server.)
+                                    pVoucherReserveAcct->ReleaseSignatures();
+                                    pVoucherReserveAcct->SignContract(
+                                        server_->m_nymServer);
+                                    pVoucherReserveAcct->SaveContract();
+                                    pVoucherReserveAcct->SaveAccount();
+
+                                    // Loops through all the accounts for a
+                                    // given instrument definition
+                                    // (PAYOUT_INSTRUMENT_DEFINITION_ID), and
+                                    // triggers actionPayDividend for each one.
+                                    // This records, for the owner nym of each,
+                                    // a voucher drawn on VOUCHER_ACCOUNT_ID.
+                                    // (In the amount of lAmountPerShare *
+                                    // number of shares in account.) They are
+                                    // sent by Pay(), below.
+                                    //
+                                    const bool bForEachAcct =
+                                        pSharesContract->VisitAccountRecords(
+                                            actionPayDividend);
+
+                                    // TODO: Since the above line of code loops
+                                    // through all the accounts and loads them
+                                    // up, transforms them, and saves them
+                                    // again, we cannot use our own loaded
+                                    // accounts below this point. (They could
+                                    // overwrite themselves.) theSourceAccount
+                                    // especially, was passed in from above --
+                                    // so how can we possible warn the caller
+                                    // than he cannot save this account without
+                                    // overwriting work we have done in this
+                                    // function?
+                                    //
+                                    // Aside from any more elegant solution, the
+                                    // only way to make it work in this case
+                                    // would be to make a map or list of all the
+                                    // accounts that are already loaded in
+                                    // memory (such as theSourceAccount) and
+                                    // PASS THEM IN to the above
+                                    // VisitAccountRecords call. This way it
+                                    // would have the option to use the "already
+                                    // loaded" versions, where appropriate,
+                                    // instead of loading them twice. (As it is,
+                                    // theSourceAccount is not used below this
+                                    // point, though we couldn't preven the
+                                    // caller from using it.)
+                                    //
+                                    // Therefore we need to have some central
+                                    // system where accounts can be loaded,
+                                    // locked, saved, etc. So we cannot ever
+                                    // overwrite ourselves BY DESIGN. (And the
+                                    // same for other data types as well, like
+                                    // Nyms.) Todo.
+                                    //
+                                    if (!bForEachAcct)  // todo failsafe. Handle
+                                                        // this
+                                                        // better.
                                     {
-                                        const String
-                                            strPayoutInstrumentDefinitionID(
-                                                PAYOUT_INSTRUMENT_DEFINITION_ID),
-                                            strRecipientNymID(NYM_ID);
                                         Log::vError(
-                                            "%s: ERROR!! Failed issuing next "
-                                            "transaction "
-                                            "number while trying to send a "
-                                            "voucher (while returning leftover "
-                                            "funds, after paying dividends.) "
-                                            "WAS TRYING TO PAY %" PRId64
-                                            " of asset "
-                                            "type %s to Nym %s.\n",
-                                            szFunc,
-                                            lLeftovers,
-                                            strPayoutInstrumentDefinitionID
-                                                .Get(),
-                                            strRecipientNymID.Get());
+                                            "%s: ERROR: After moving funds for "
+                                            "dividend payment, there was some "
+                                            "error when sending out the "
+                                            "vouchers to the payout "
+                                            "recipients.\n",
+                                            szFunc);
+                                    }
+                                    //
+                                    // SEND THE VOUCHERS, AND REFUND ANY
+                                    // LEFTOVERS
+                                    //
+                                    if (!actionPayDividend.Pay()) {
+                                        Log::vError(
+                                            "%s: ERROR: there was some error "
+                                            "while sending out the vouchers, "
+                                            "or while returning the leftovers "
+                                            "to the dividend payout "
+                                            "initiator.\n",
+                                            szFunc);
                                     }
                                 }
                             }  // else
@@ -4020,6 +3856,8 @@ void Notary::NotarizeDeposit(
                                              // successful.
 
                 bool bSuccess = false;
+                SpentTokens::Batch spentTokens;
+                std::map<Account*, int64_t> reserveDebits;
 
                 // Pull the token(s) out of the purse that was received from the
                 // client.
@@ -4081,6 +3919,24 @@ void Notary::NotarizeDeposit(
                                 "server ID. \n");
                             break;
                         }
+                        // Once a series has passed its valid-to date its spent
+                        // token database may be dropped, so the dates on the
+                        // token must be enforced here: they have to match the
+                        // mint of that series, and include the current time.
+                        else if (
+                            (pToken->GetValidFrom() !=
+                             pMint->GetValidFrom()) ||
+                            (pToken->GetValidTo() != pMint->GetValidTo()) ||
+                            !pToken->VerifyCurrentDate()) {
+                            bSuccess = false;
+                            Log::vOutput(
+                                0,
+                                "Notary::NotarizeDeposit: "
+                                "ERROR verifying token: Token "
+                                "is expired or its dates do not "
+                                "match the mint. \n");
+                            break;
+                        }
                         // This call to VerifyToken verifies the token's Series
                         // and From/To dates against the
                         // mint's, and also verifies that the CURRENT date is
@@ -4174,16 +4030,18 @@ void Notary::NotarizeDeposit(
                                 bSuccess = false;
                                 break;
                             }
-                            // Spent token database. This is where the call is
-                            // made to add
-                            // the token to the spent token database.
-                            else if (
-                                false ==
-                                pToken->RecordTokenAsSpent(strSpendableToken)) {
-                                Log::Error(
+                            // Spent token database. The hash is only queued
+                            // here: every token in the purse is recorded in
+                            // one batch once the whole purse has verified.
+                            else if (!spentTokens[pToken->GetSeries()]
+                                          .insert(SpentTokens::Hash(
+                                              strSpendableToken))
+                                          .second) {
+                                Log::vOutput(
+                                    0,
                                     "Notary::NotarizeDeposit: "
-                                    "Failed recording token as "
-                                    "spent...\n");
+                                    "ERROR verifying token: Token "
+                                    "appears twice in the purse. \n");
 
                                 if (false ==
                                     pMintCashReserveAcct->Credit(
@@ -4211,6 +4069,8 @@ void Notary::NotarizeDeposit(
                                     "Notary::NotarizeDeposit: "
                                     "SUCCESS crediting account "
                                     "with cash token...\n");
+                                reserveDebits[pMintCashReserveAcct] +=
+                                    pToken->GetDenomination();
                                 bSuccess = true;
 
                                 // No break here -- we allow the loop to carry
@@ -4226,6 +4086,36 @@ void Notary::NotarizeDeposit(
                     }
                 }  // while success popping token from purse
 
+                // Spent token database. This is where all the tokens from the
+                // purse are added to the spent token database, atomically.
+                // (The accounts are only saved below if this succeeds.)
+                if (bSuccess &&
+                    !SpentTokens::It().Insert(
+                        String(INSTRUMENT_DEFINITION_ID), spentTokens)) {
+                    Log::Error(
+                        "Notary::NotarizeDeposit: "
+                        "Failed recording tokens as "
+                        "spent...\n");
+
+                    for (auto& it : reserveDebits) {
+                        if (false == it.first->Credit(it.second))
+                            Log::Error(
+                                "Notary::NotarizeDeposit: "
+                                "Failure crediting-back "
+                                "mint's cash reserve account "
+                                "while depositing cash.\n");
+
+                        if (false == theAccount.Debit(it.second))
+                            Log::Error(
+                                "Notary::NotarizeDeposit: "
+                                "Failure debiting-back user's "
+                                "asset account while "
+                                "depositing cash.\n");
+                    }
+
+                    bSuccess = false;
+                }
+
                 if (bSuccess) {
                     // Release any signatures that were there before (They won't
                     // verify anymore anyway, since the content has changed.)
@@ -8979,14 +8869,8 @@ void Notary::NotarizeProcessInbox(
                         // my original transfer (or contains a cheque with my
                         // original number.) (THAT's the # I need.)
                         //
-                        String strOriginalItem;
-                        pServerTransaction->GetReferenceString(strOriginalItem);
-
-                        std::unique_ptr<Item> pOriginalItem(
-                            Item::CreateItemFromString(
-                                strOriginalItem,
-                                NOTARY_ID,
-                                pServerTransaction->GetReferenceToNum()));
+                        const Item* pOriginalItem =
+                            pServerTransaction->GetReferenceItem(NOTARY_ID);
 
                         if (nullptr != pOriginalItem) {
                             // If pOriginalItem is acceptPending, that means the
@@ -9035,19 +8919,15 @@ void Notary::NotarizeProcessInbox(
                                 // Get the cheque from the Item and load it up
                                 // into
                                 // a Cheque object.
-                                String strCheque;
-                                pOriginalItem->GetAttachment(strCheque);
-
-                                Cheque theCheque;  // allocated on the stack :-)
+                                const Cheque* pCheque =
+                                    pServerTransaction->GetReferenceCheque(
+                                        NOTARY_ID);
 
-                                if (false == ((strCheque.GetLength() > 2) &&
-                                              theCheque.LoadContractFromString(
-                                                  strCheque))) {
+                                if (nullptr == pCheque) {
                                     Log::vError(
                                         "%s: ERROR loading cheque from "
-                                        "string:\n%s\n",
-                                        __FUNCTION__,
-                                        strCheque.Get());
+                                        "string.\n",
+                                        __FUNCTION__);
                                     bSuccessFindingAllTransactions = false;
                                 } else  // Since the client wrote the cheque,
                                         // and he
@@ -9063,10 +8943,10 @@ void Notary::NotarizeProcessInbox(
                                     //
                                     if (theNym.VerifyIssuedNum(
                                             server_->m_strNotaryID,
-                                            theCheque.GetTransactionNum()))
+                                            pCheque->GetTransactionNum()))
                                         theTempNym.AddIssuedNum(
                                             server_->m_strNotaryID,
-                                            theCheque.GetTransactionNum());
+                                            pCheque->GetTransactionNum());
                                     else {
                                         bSuccessFindingAllTransactions = false;
 
@@ -9080,7 +8960,7 @@ void Notary::NotarizeProcessInbox(
                                             "in the inbox, "
                                             "then?)\n",
                                             __FUNCTION__,
-                                            theCheque.GetTransactionNum());
+                                            pCheque->GetTransactionNum());
                                     }
                                 }
                             }
@@ -9105,10 +8985,10 @@ void Notary::NotarizeProcessInbox(
                                 //
                                 if (theNym.VerifyIssuedNum(
                                         server_->m_strNotaryID,
-                                        pOriginalItem->GetNumberOfOrigin()))
+                                        pOriginalItem->GetRawNumberOfOrigin()))
                                     theTempNym.AddIssuedNum(
                                         server_->m_strNotaryID,
-                                        pOriginalItem->GetNumberOfOrigin());
+                                        pOriginalItem->GetRawNumberOfOrigin());
                                 else {
                                     bSuccessFindingAllTransactions = false;
 
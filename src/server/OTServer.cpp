@@ -64,13 +64,16 @@
 #include "opentxs/core/String.hpp"
 #include "opentxs/ext/OTPayment.hpp"
 #include "opentxs/server/ConfigLoader.hpp"
+#include "opentxs/server/PayDividendVisitor.hpp"
 #include "opentxs/server/Transactor.hpp"
 
 #include <inttypes.h>
 #include <stdint.h>
 #include <sys/types.h>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #define SERVER_PID_FILENAME "ot.pid"
 
@@ -567,6 +570,9 @@ void OTServer::Init(std::map<std::string, std::string>& args, bool readOnly)
         }
     }
 
+    // Finish any dividend payout which was interrupted by a crash.
+    if (mainFileExists && !readOnly) { PayDividendVisitor::Resume(*this); }
+
     auto password = OT::App().Crypto().Encode().Nonce(16);
     String notUsed;
     bool ignored;
@@ -919,6 +925,152 @@ bool OTServer::DropMessageToNymbox(
     return false;
 }
 
+bool OTServer::DropInstrumentsToNymbox(
+    const Identifier& NOTARY_ID,
+    const Identifier& SENDER_NYM_ID,
+    const Identifier& RECIPIENT_NYM_ID,
+    const std::vector<String>& instruments,
+    const std::vector<int64_t>& receiptNumbers,
+    const char* szCommand)
+{
+    const char* szFunc = "OTServer::DropInstrumentsToNymbox";
+
+    OT_ASSERT(instruments.size() == receiptNumbers.size());
+
+    if (instruments.empty()) { return true; }
+
+    // Load up the recipient's public key once for the whole batch.
+    Nym nymRecipient(RECIPIENT_NYM_ID);
+
+    if (!nymRecipient.LoadPublicKey()) {
+        Log::vError(
+            "%s: Failed trying to load public key for recipient.\n", szFunc);
+        return false;
+    } else if (!nymRecipient.VerifyPseudonym()) {
+        Log::vError("%s: Failed trying to verify Nym for recipient.\n", szFunc);
+        return false;
+    }
+
+    const OTAsymmetricKey& thePubkey = nymRecipient.GetPublicEncrKey();
+    Ledger theLedger(RECIPIENT_NYM_ID, RECIPIENT_NYM_ID, NOTARY_ID);
+    bool bVerified = false;
+
+    if (theLedger.LoadNymbox() && theLedger.VerifyContractID()) {
+        std::lock_guard<std::mutex> lock(server_nym_lock_);
+        bVerified = theLedger.VerifySignature(m_nymServer);
+    }
+
+    if (!bVerified) {
+        const String strRecipientNymID(RECIPIENT_NYM_ID);
+        Log::vError(
+            "%s: Failed while trying to load or verify Nymbox: %s\n",
+            szFunc,
+            strRecipientNymID.Get());
+        return false;
+    }
+
+    std::vector<OTTransaction*> added;
+
+    for (std::size_t i = 0; i < instruments.size(); ++i) {
+        const int64_t lTransNum = receiptNumbers[i];
+
+        // A resumed payout may resend a batch which was already delivered
+        // before the crash. Its receipt is in the nymbox, so leave it alone.
+        if (nullptr != theLedger.GetTransaction(lTransNum)) {
+            Log::vOutput(
+                0,
+                "%s: Receipt %" PRId64 " is already in the Nymbox.\n",
+                szFunc,
+                lTransNum);
+            continue;
+        }
+
+        // Same message as DropMessageToNymbox creates "from the server".
+        Message theMsg;
+        theMsg.m_strCommand.Set(
+            (nullptr != szCommand) ? szCommand : "sendNymInstrument");
+        theMsg.m_strNotaryID = m_strNotaryID;
+        theMsg.m_bSuccess = true;
+        SENDER_NYM_ID.GetString(theMsg.m_strNymID);
+        RECIPIENT_NYM_ID.GetString(theMsg.m_strNymID2);
+
+        OTEnvelope theEnvelope;
+
+        if (!(instruments[i].Exists() &&
+              theEnvelope.Seal(thePubkey, instruments[i]) &&
+              theEnvelope.GetCiphertext(theMsg.m_ascPayload))) {
+            Log::vError(
+                "%s: Failed trying to seal envelope containing message.\n",
+                szFunc);
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(server_nym_lock_);
+            theMsg.SignContract(m_nymServer);
+        }
+
+        theMsg.SaveContract();
+
+        const String strInMessage(theMsg);
+        OTTransaction* pTransaction = OTTransaction::GenerateTransaction(
+            theLedger,
+            OTTransaction::instrumentNotice,
+            originType::not_applicable,
+            lTransNum);
+
+        if (nullptr == pTransaction) {
+            Log::vError(
+                "%s: Failed while trying to generate transaction.\n", szFunc);
+            return false;
+        }
+
+        pTransaction->SetReferenceToNum(lTransNum);
+        pTransaction->SetReferenceString(strInMessage);
+
+        {
+            std::lock_guard<std::mutex> lock(server_nym_lock_);
+            pTransaction->SignContract(m_nymServer);
+        }
+
+        pTransaction->SaveContract();
+
+        if (!theLedger.AddTransaction(*pTransaction)) {
+            Log::vError(
+                "%s: Failed adding receipt %" PRId64 " to the Nymbox.\n",
+                szFunc,
+                lTransNum);
+            delete pTransaction;
+            pTransaction = nullptr;
+            return false;
+        }
+
+        added.push_back(pTransaction);  // the ledger will cleanup.
+    }
+
+    if (added.empty()) { return true; }
+
+    theLedger.ReleaseSignatures();
+
+    {
+        std::lock_guard<std::mutex> lock(server_nym_lock_);
+        theLedger.SignContract(m_nymServer);
+    }
+
+    theLedger.SaveContract();
+
+    if (!theLedger.SaveNymbox()) {
+        Log::vError("%s: Failed saving Nymbox.\n", szFunc);
+        return false;
+    }
+
+    for (auto& pTransaction : added) {
+        pTransaction->SaveBoxReceipt(theLedger);
+    }
+
+    return true;
+}
+
 bool OTServer::GetConnectInfo(std::string& strHostname, uint32_t& nPort) const
 {
     bool notUsed = false;
@@ -43,6 +43,7 @@
 #include "opentxs/core/Cheque.hpp"
 #include "opentxs/core/Identifier.hpp"
 #include "opentxs/core/Log.hpp"
+#include "opentxs/core/OTStorage.hpp"
 #include "opentxs/core/String.hpp"
 #include "opentxs/core/util/Assert.hpp"
 #include "opentxs/core/util/Common.hpp"
@@ -52,6 +53,16 @@
 
 #include <inttypes.h>
 #include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace opentxs
 {
@@ -92,6 +103,44 @@ PayDividendVisitor::~PayDividendVisitor()
     m_lAmountReturned = 0;
 }
 
+namespace
+{
+
+// Runs task(0 .. count - 1) across one worker per hardware thread.
+void run_parallel(
+    const std::size_t count,
+    const std::function<void(const std::size_t)>& task)
+{
+    std::atomic<std::size_t> next(0);
+
+    auto worker = [&]() -> void {
+        for (std::size_t i = next++; i < count; i = next++) {
+            task(i);
+        }
+    };
+
+    const std::size_t workers =
+        std::min<std::size_t>(std::thread::hardware_concurrency(), count);
+
+    if (2 > workers) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+
+        for (std::size_t i = 1; i < workers; ++i) {
+            pool.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+}
+
+}  // namespace
+
 // For each "user" account of a specific instrument definition, this function
 // is called in order to pay a dividend to the Nym who owns that account.
 
@@ -101,8 +150,8 @@ PayDividendVisitor::~PayDividendVisitor()
 bool PayDividendVisitor::Trigger(Account& theSharesAccount) // theSharesAccount
                                                             // is, say, a Pepsi
                                                             // shares
-// account.  Here, we'll send a dollars voucher
-// to its owner.
+// account.  Here, we'll record a dollars voucher
+// for its owner. (Pay() sends them.)
 {
     const int64_t lPayoutAmount =
         (theSharesAccount.GetBalance() * GetPayoutPerShare());
@@ -114,39 +163,341 @@ bool PayDividendVisitor::Trigger(Account& theSharesAccount) // theSharesAccount
         return true; // nothing to pay, since this account owns no shares.
                      // Success!
     }
+
+    Payout thePayout;
+    thePayout.recipient_ = String(theSharesAccount.GetNymID()).Get();
+    thePayout.amount_ = lPayoutAmount;
+    payouts_.push_back(thePayout);
+
+    return true;
+}
+
+bool PayDividendVisitor::Fund(
+    int64_t lTotalCost,
+    const Account& thePayerAcct,
+    const Account& theVoucherReserveAcct)
+{
+    total_cost_ = lTotalCost;
+    stage_ = DividendCheckpoint::STAGE_FUNDS_MOVED;
+    payer_acct_id_ = String(Identifier(thePayerAcct)).Get();
+    payer_balance_ = thePayerAcct.GetBalance();
+    reserve_balance_ = theVoucherReserveAcct.GetBalance();
+
+    return save_checkpoint();
+}
+
+bool PayDividendVisitor::Pay()
+{
+    OT_ASSERT(nullptr != GetServer());
+    OTServer& theServer = *(GetServer());
+    Nym& theServerNym = const_cast<Nym&>(theServer.GetServerNym());
+    const int64_t count = static_cast<int64_t>(payouts_.size());
+    const int64_t lTotalCost = total_cost_;
+
+    // We save the voucher numbers on the server Nym (normally we'd discard
+    // them) because when a cheque is deposited, the server nym, as the owner
+    // of the voucher account, needs to verify the transaction # on the
+    // cheque (to prevent double-spending of cheques.) The extra number is for
+    // returning any leftovers. The receipt numbers are not issued to anyone.
+    std::vector<int64_t> vouchers, receipts;
+
+    if (!theServer.transactor_.issueNextTransactionNumbersToNym(
+            theServerNym, count + 1, vouchers) ||
+        ((0 < count) && !theServer.transactor_.issueNextTransactionNumbers(
+                            count, receipts))) {
+        // The checkpoint from Fund() is still in place, so the payer is
+        // refunded when the server restarts.
+        Log::vError(
+            "%s: ERROR!! Failed issuing transaction numbers while paying "
+            "dividends. WAS TRYING TO PAY %" PRId64 " in total.\n",
+            __FUNCTION__,
+            lTotalCost);
+
+        return false;
+    }
+
+    for (std::size_t i = 0; i < payouts_.size(); ++i) {
+        payouts_[i].voucher_number_ = vouchers[i];
+        payouts_[i].receipt_number_ = receipts[i];
+    }
+
+    leftover_number_ = vouchers.back();
+    stage_ = DividendCheckpoint::STAGE_PAYING;
+
+    // Without a checkpoint the job could not be finished after a crash, so
+    // nothing is paid out and the whole amount goes back to the payer.
+    if (!save_checkpoint()) {
+        Log::vError(
+            "%s: Unable to checkpoint the dividend payout. Returning %" PRId64
+            " to the payer instead.\n",
+            __FUNCTION__,
+            lTotalCost);
+
+        if (return_to_sender(lTotalCost, leftover_number_)) {
+            m_lAmountReturned += lTotalCost;
+            erase_checkpoint();
+        }
+
+        return false;
+    }
+
+    return run();
+}
+
+bool PayDividendVisitor::run()
+{
+    for (std::size_t begin = 0; begin < payouts_.size();
+         begin += PAYOUT_BATCH) {
+        const std::size_t end =
+            std::min(payouts_.size(), begin + PAYOUT_BATCH);
+
+        pay_batch(begin, end);
+
+        if (!save_checkpoint()) {
+            Log::vError(
+                "%s: Unable to checkpoint the dividend payout. A crash now "
+                "would resend this batch.\n",
+                __FUNCTION__);
+        }
+    }
+
+    bool bSuccess = true;
+
+    // Whatever wasn't paid to anybody (nor returned already) is paid back to
+    // the sender himself, now.
+    const int64_t lLeftovers =
+        total_cost_ - (m_lAmountPaidOut + m_lAmountReturned);
+
+    if (0 < lLeftovers) {
+        Log::vOutput(
+            0,
+            "%s: After dividend payout, with %" PRId64
+            " units removed initially, there were %" PRId64
+            " units remaining. (Returning them to sender...)\n",
+            __FUNCTION__,
+            total_cost_,
+            lLeftovers);
+
+        bSuccess = return_to_sender(lLeftovers, leftover_number_);
+
+        if (bSuccess) { m_lAmountReturned += lLeftovers; }
+    }
+
+    erase_checkpoint();
+
+    return bSuccess;
+}
+
+// The payer was debited, but the payout never got as far as collecting the
+// payouts. The whole amount goes back to the payer, unless the debit itself
+// was never saved.
+bool PayDividendVisitor::refund()
+{
+    OT_ASSERT(nullptr != GetServer());
+    OTServer& theServer = *(GetServer());
+    Nym& theServerNym = const_cast<Nym&>(theServer.GetServerNym());
+
+    std::unique_ptr<Account> pPayerAcct(Account::LoadExistingAccount(
+        Identifier(payer_acct_id_), notaryID_));
+
+    if (!pPayerAcct) {
+        Log::vError(
+            "%s: Unable to load the dividend payer's account %s.\n",
+            __FUNCTION__,
+            payer_acct_id_.c_str());
+
+        return false;
+    }
+
+    if (payer_balance_ != pPayerAcct->GetBalance()) {
+        Log::vOutput(
+            0,
+            "%s: The dividend payer's account was never debited. Nothing to "
+            "refund.\n",
+            __FUNCTION__);
+        erase_checkpoint();
+
+        return true;
+    }
+
+    // The voucher reserve is saved right after the payer's account, so its
+    // credit may be missing.
+    std::shared_ptr<Account> pReserveAcct =
+        theServer.transactor_.getVoucherAccount(
+            *m_pPayoutInstrumentDefinitionID);
+
+    if (!pReserveAcct) {
+        Log::vError(
+            "%s: Unable to load the voucher reserve account.\n", __FUNCTION__);
+
+        return false;
+    }
+
+    if ((reserve_balance_ - total_cost_) == pReserveAcct->GetBalance()) {
+        if (!pReserveAcct->Credit(total_cost_)) {
+            Log::vError(
+                "%s: Failed crediting the voucher reserve account.\n",
+                __FUNCTION__);
+
+            return false;
+        }
+
+        pReserveAcct->ReleaseSignatures();
+        pReserveAcct->SignContract(theServerNym);
+        pReserveAcct->SaveContract();
+        pReserveAcct->SaveAccount();
+    } else if (reserve_balance_ != pReserveAcct->GetBalance()) {
+        Log::vError(
+            "%s: The voucher reserve account balance is %" PRId64
+            ", expected %" PRId64 ". Not refunding the dividend payer.\n",
+            __FUNCTION__,
+            pReserveAcct->GetBalance(),
+            reserve_balance_);
+
+        return false;
+    }
+
+    std::vector<int64_t> numbers;
+
+    if (!theServer.transactor_.issueNextTransactionNumbersToNym(
+            theServerNym, 1, numbers) ||
+        !return_to_sender(total_cost_, numbers.front())) {
+        Log::vError(
+            "%s: Failed returning %" PRId64 " to the dividend payer.\n",
+            __FUNCTION__,
+            total_cost_);
+
+        return false;
+    }
+
+    m_lAmountReturned += total_cost_;
+    erase_checkpoint();
+
+    return true;
+}
+
+void PayDividendVisitor::pay_batch(
+    const std::size_t begin,
+    const std::size_t end)
+{
     OT_ASSERT(nullptr != GetNotaryID());
     const Identifier& theNotaryID = *(GetNotaryID());
-    OT_ASSERT(nullptr != GetPayoutInstrumentDefinitionID());
-    const Identifier& thePayoutInstrumentDefinitionID =
-        *(GetPayoutInstrumentDefinitionID());
-    OT_ASSERT(nullptr != GetVoucherAcctID());
-    const Identifier& theVoucherAcctID = *(GetVoucherAcctID());
     OT_ASSERT(nullptr != GetServer());
     OTServer& theServer = *(GetServer());
+    const Identifier theServerNymID(theServer.GetServerNym());
+    const std::size_t count = end - begin;
+
+    // Issue and sign the vouchers.
+    std::vector<String> vouchers(count);
+    // Not vector<bool>, since each worker writes its own elements.
+    std::vector<char> issued(count, 0);
+
+    run_parallel(count, [&](const std::size_t i) -> void {
+        const Payout& thePayout = payouts_[begin + i];
+
+        if (DividendCheckpoint::PAYOUT_PENDING != thePayout.state_) { return; }
+
+        issued[i] = issue_voucher(
+            Identifier(thePayout.recipient_),
+            thePayout.amount_,
+            thePayout.voucher_number_,
+            vouchers[i]);
+    });
+
+    // Drop them, one nymbox write per recipient.
+    std::map<std::string, std::vector<std::size_t>> recipients;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (issued[i]) {
+            recipients[payouts_[begin + i].recipient_].push_back(i);
+        }
+    }
+
+    std::vector<const std::pair<const std::string, std::vector<std::size_t>>*>
+        groups;
+
+    for (const auto& it : recipients) {
+        groups.push_back(&it);
+    }
+
+    std::vector<char> delivered(count, 0);
+
+    run_parallel(groups.size(), [&](const std::size_t g) -> void {
+        const auto& indices = groups[g]->second;
+        std::vector<String> instruments;
+        std::vector<int64_t> numbers;
+
+        for (const auto& i : indices) {
+            instruments.push_back(vouchers[i]);
+            numbers.push_back(payouts_[begin + i].receipt_number_);
+        }
+
+        const bool bSent = theServer.DropInstrumentsToNymbox(
+            theNotaryID,
+            theServerNymID,
+            Identifier(groups[g]->first),
+            instruments,
+            numbers,
+            "payDividend");  // todo: hardcoding.
+
+        for (const auto& i : indices) {
+            delivered[i] = bSent;
+        }
+    });
+
+    for (std::size_t i = 0; i < count; ++i) {
+        Payout& thePayout = payouts_[begin + i];
+
+        if (DividendCheckpoint::PAYOUT_PENDING != thePayout.state_) {
+            continue;
+        }
+
+        if (delivered[i]) {
+            thePayout.state_ = DividendCheckpoint::PAYOUT_PAID;
+            // At the end of the job, if m_lAmountPaidOut is less than the
+            // total, then we return the rest to the sender.
+            m_lAmountPaidOut += thePayout.amount_;
+
+            continue;
+        }
+
+        const String strRecipientNymID(thePayout.recipient_);
+        Log::vError(
+            "%s: ERROR failed sending voucher to dividend payout recipient. "
+            "WAS TRYING TO PAY %" PRId64 " to Nym %s.\n",
+            __FUNCTION__,
+            thePayout.amount_,
+            strRecipientNymID.Get());
+
+        // If we didn't send it, then we need to return the funds to where
+        // they came from. The returned voucher reuses the number, so at most
+        // one of the two can ever be deposited.
+        if (return_to_sender(thePayout.amount_, thePayout.voucher_number_)) {
+            thePayout.state_ = DividendCheckpoint::PAYOUT_RETURNED;
+            m_lAmountReturned += thePayout.amount_;
+        } else {
+            // Counted with the leftovers instead.
+            thePayout.state_ = DividendCheckpoint::PAYOUT_FAILED;
+        }
+    }
+}
+
+bool PayDividendVisitor::issue_voucher(
+    const Identifier& theRecipientID,
+    int64_t lAmount,
+    int64_t lTransactionNumber,
+    String& strOutput) const
+{
+    const Identifier& theNotaryID = notaryID_;
+    const Identifier& thePayoutInstrumentDefinitionID =
+        *m_pPayoutInstrumentDefinitionID;
+    const Identifier& theVoucherAcctID = *m_pVoucherAcctID;
+    OTServer& theServer = *m_pServer;
     Nym& theServerNym = const_cast<Nym&>(theServer.GetServerNym());
     const Identifier theServerNymID(theServerNym);
-    const Identifier& RECIPIENT_ID = theSharesAccount.GetNymID();
-    OT_ASSERT(nullptr != GetNymID());
-    const Identifier& theSenderNymID = *(GetNymID());
-    OT_ASSERT(nullptr != GetMemo());
-    const String& strMemo = *(GetMemo());
-    // Note: theSenderNymID is the originator of the Dividend Payout.
-    // However, all the actual vouchers will be from "the server Nym" and
-    // not from theSenderNymID. So then why is it even here? Because anytime
-    // there's an error, the server will send to theSenderNymID instead of
-    // RECIPIENT_ID (so the original sender can have his money back, instead of
-    // just having it get lost in the ether.)
-    bool bReturnValue = false;
 
     Cheque theVoucher(theNotaryID, thePayoutInstrumentDefinitionID);
 
-    // 10 minutes ==    600 Seconds
-    // 1 hour    ==     3600 Seconds
-    // 1 day    ==    86400 Seconds
-    // 30 days    ==  2592000 Seconds
-    // 3 months ==  7776000 Seconds
-    // 6 months == 15552000 Seconds
-
     const time64_t VALID_FROM =
         OTTimeGetCurrentTime(); // This time is set to TODAY NOW
     const time64_t VALID_TO = OTTimeAddTimeInterval(
@@ -155,165 +506,192 @@ bool PayDividendVisitor::Trigger(Account& theSharesAccount) // theSharesAccount
                                                          // 180 days (6 months).
                                                          // Todo hardcoding.
 
-    int64_t lNewTransactionNumber = 0;
-
-    bool bGotNextTransNum =
-        theServer.transactor_.issueNextTransactionNumberToNym(
-            theServerNym, lNewTransactionNumber); // We save the transaction
-    // number on the server Nym (normally we'd discard it) because
-    // when the cheque is deposited, the server nym, as the owner of
-    // the voucher account, needs to verify the transaction # on the
-    // cheque (to prevent double-spending of cheques.)
-    if (bGotNextTransNum) {
-        const bool bIssueVoucher = theVoucher.IssueCheque(
-            lPayoutAmount,         // The amount of the cheque.
-            lNewTransactionNumber, // Requiring a transaction number prevents
-                                   // double-spending of cheques.
-            VALID_FROM, // The expiration date (valid from/to dates) of the
-                        // cheque
-            VALID_TO, // Vouchers are automatically starting today and lasting 6
-                      // months.
-            theVoucherAcctID, // The asset account the cheque is drawn on.
-            theServerNymID,   // Nym ID of the sender (in this case the server
-                              // nym.)
-            strMemo, // Optional memo field. Includes item note and request
+    const bool bIssueVoucher = theVoucher.IssueCheque(
+        lAmount,            // The amount of the cheque.
+        lTransactionNumber, // Requiring a transaction number prevents
+                            // double-spending of cheques.
+        VALID_FROM, // The expiration date (valid from/to dates) of the cheque
+        VALID_TO,   // Vouchers are automatically starting today and lasting 6
+                    // months.
+        theVoucherAcctID, // The asset account the cheque is drawn on.
+        theServerNymID,   // Nym ID of the sender (in this case the server nym.)
+        *m_pstrMemo, // Optional memo field. Includes item note and request
                      // memo.
-            &RECIPIENT_ID);
-
-        // All account crediting / debiting happens in the caller, in OTServer.
-        //    (AND it happens only ONCE, to cover ALL vouchers.)
-        // Then in here, the voucher either gets send to the recipient, or if
-        // error, sent back home to
-        // the issuer Nym. (ALL the funds are removed, then the vouchers are
-        // sent one way or the other.)
-        // Any returned vouchers, obviously serve to notify the dividend payer
-        // of where the errors were
-        // (as well as give him the opportunity to get his money back.)
-        //
-        bool bSent = false;
-        if (bIssueVoucher) {
-            // All this does is set the voucher's internal contract string to
-            // "VOUCHER" instead of "CHEQUE". We also set the server itself as
-            // the remitter, which is unusual for vouchers, but necessary in the
-            // case of dividends.
-            //
-            theVoucher.SetAsVoucher(theServerNymID, theVoucherAcctID);
-            theVoucher.SignContract(theServerNym);
-            theVoucher.SaveContract();
-
-            // Send the voucher to the payments inbox of the recipient.
-            //
-            const String strVoucher(theVoucher);
-            OTPayment thePayment(strVoucher);
-
-            // calls DropMessageToNymbox
-            bSent = theServer.SendInstrumentToNym(
-                theNotaryID, theServerNymID,          // sender nym
-                RECIPIENT_ID,                         // recipient nym
-                nullptr, &thePayment, "payDividend"); // todo: hardcoding.
-            bReturnValue = bSent;                     // <======= RETURN VALUE.
-            if (bSent)
-                m_lAmountPaidOut +=
-                    lPayoutAmount; // At the end of iterating all accounts, if
-                                   // m_lAmountPaidOut is less than
-                                   // lTotalPayoutAmount, then we return to rest
-                                   // to the sender.
-        }
-        else {
-            const String strPayoutInstrumentDefinitionID(
-                thePayoutInstrumentDefinitionID),
-                strRecipientNymID(RECIPIENT_ID);
-            Log::vError("PayDividendVisitor::Trigger: ERROR failed "
-                        "issuing voucher (to send to dividend payout "
-                        "recipient.) "
-                        "WAS TRYING TO PAY %" PRId64
-                        " of instrument definition %s to Nym %s.\n",
-                        lPayoutAmount, strPayoutInstrumentDefinitionID.Get(),
-                        strRecipientNymID.Get());
-        }
-        // If we didn't send it, then we need to return the funds to where they
-        // came from.
-        //
-        if (!bSent) {
-            Cheque theReturnVoucher(theNotaryID,
-                                    thePayoutInstrumentDefinitionID);
-
-            const bool bIssueReturnVoucher = theReturnVoucher.IssueCheque(
-                lPayoutAmount,         // The amount of the cheque.
-                lNewTransactionNumber, // Requiring a transaction number
-                                       // prevents double-spending of cheques.
-                VALID_FROM, // The expiration date (valid from/to dates) of the
-                            // cheque
-                VALID_TO,   // Vouchers are automatically starting today and
-                            // lasting 6 months.
-                theVoucherAcctID, // The asset account the cheque is drawn on.
-                theServerNymID,   // Nym ID of the sender (in this case the
-                                  // server nym.)
-                strMemo, // Optional memo field. Includes item note and request
-                         // memo.
-                &theSenderNymID); // We're returning the money to its original
-                                  // sender.
-            if (bIssueReturnVoucher) {
-                // All this does is set the voucher's internal contract string
-                // to
-                // "VOUCHER" instead of "CHEQUE".
-                //
-                theReturnVoucher.SetAsVoucher(theServerNymID, theVoucherAcctID);
-                theReturnVoucher.SignContract(theServerNym);
-                theReturnVoucher.SaveContract();
-
-                // Return the voucher back to the payments inbox of the original
-                // sender.
-                //
-                const String strReturnVoucher(theReturnVoucher);
-                OTPayment theReturnPayment(strReturnVoucher);
-
-                // calls DropMessageToNymbox
-                bSent = theServer.SendInstrumentToNym(
-                    theNotaryID, theServerNymID, // sender nym
-                    theSenderNymID, // recipient nym (original sender.)
-                    nullptr, &theReturnPayment,
-                    "payDividend"); // todo: hardcoding.
-                if (bSent)
-                    m_lAmountReturned +=
-                        lPayoutAmount; // At the end of iterating all accounts,
-                                       // if m_lAmountPaidOut+m_lAmountReturned
-                                       // is less than lTotalPayoutAmount, then
-                                       // we return the rest to the sender.
-            }
-            else {
-                const String strPayoutInstrumentDefinitionID(
-                    thePayoutInstrumentDefinitionID),
-                    strSenderNymID(theSenderNymID);
-                Log::vError("PayDividendVisitor::Trigger: ERROR "
-                            "failed issuing voucher (to return back to "
-                            "the dividend payout initiator, after a failed "
-                            "payment attempt to the originally intended "
-                            "recipient.) WAS TRYING TO PAY %" PRId64
-                            " of instrument definition "
-                            "%s to Nym %s.\n",
-                            lPayoutAmount,
-                            strPayoutInstrumentDefinitionID.Get(),
-                            strSenderNymID.Get());
-            }
-        }  // if !bSent
-    }
-    else // !bGotNextTransNum
-    {
+        &theRecipientID);
+
+    if (!bIssueVoucher) {
         const String strPayoutInstrumentDefinitionID(
             thePayoutInstrumentDefinitionID),
-            strRecipientNymID(RECIPIENT_ID);
+            strRecipientNymID(theRecipientID);
+        Log::vError("PayDividendVisitor::issue_voucher: ERROR failed issuing "
+                    "voucher. WAS TRYING TO PAY %" PRId64
+                    " of instrument definition %s to Nym %s.\n",
+                    lAmount, strPayoutInstrumentDefinitionID.Get(),
+                    strRecipientNymID.Get());
+
+        return false;
+    }
+
+    // All this does is set the voucher's internal contract string to
+    // "VOUCHER" instead of "CHEQUE". We also set the server itself as
+    // the remitter, which is unusual for vouchers, but necessary in the
+    // case of dividends.
+    //
+    theVoucher.SetAsVoucher(theServerNymID, theVoucherAcctID);
+
+    {
+        // Several batch workers sign at once, and the server nym's private
+        // key may not be used concurrently.
+        std::lock_guard<std::mutex> lock(theServer.server_nym_lock_);
+        theVoucher.SignContract(theServerNym);
+    }
+
+    theVoucher.SaveContract();
+
+    const String strVoucher(theVoucher);
+    OTPayment thePayment(strVoucher);
+
+    return thePayment.IsValid() && thePayment.GetPaymentContents(strOutput);
+}
+
+bool PayDividendVisitor::return_to_sender(
+    int64_t lAmount,
+    int64_t lTransactionNumber)
+{
+    OT_ASSERT(nullptr != GetNymID());
+    const Identifier& theSenderNymID = *(GetNymID());
+    OTServer& theServer = *m_pServer;
+    const Identifier theServerNymID(theServer.GetServerNym());
+
+    String strReturnVoucher;
+
+    if (!issue_voucher(
+            theSenderNymID, lAmount, lTransactionNumber, strReturnVoucher)) {
+        return false;
+    }
+
+    // Return the voucher back to the payments inbox of the original sender.
+    const OTPayment theReturnPayment(strReturnVoucher);
+
+    // calls DropMessageToNymbox
+    return theServer.SendInstrumentToNym(
+        notaryID_,
+        theServerNymID,   // sender nym
+        theSenderNymID,   // recipient nym (original sender.)
+        nullptr,
+        &theReturnPayment,
+        "payDividend");  // todo: hardcoding.
+}
+
+// A dividend is paid out inside a single (exclusive) request, so there is
+// never more than one job in flight, and one checkpoint file is enough.
+std::string PayDividendVisitor::checkpoint_filename(const OTServer& theServer)
+{
+    String filename;
+    filename.Format("%s.dividend", theServer.m_strWalletFilename.Get());
+
+    return filename.Get();
+}
+
+void PayDividendVisitor::erase_checkpoint() const
+{
+    if (!OTDB::EraseValueByKey(".", checkpoint_filename(*m_pServer))) {
         Log::vError(
-            "PayDividendVisitor::Trigger: ERROR!! Failed issuing next "
-            "transaction "
-            "number while trying to send a voucher (while paying dividends.) "
-            "WAS TRYING TO PAY %" PRId64
-            " of instrument definition %s to Nym %s.\n",
-            lPayoutAmount, strPayoutInstrumentDefinitionID.Get(),
-            strRecipientNymID.Get());
+            "%s: Failed to remove the dividend checkpoint.\n", __FUNCTION__);
     }
+}
+
+bool PayDividendVisitor::save_checkpoint() const
+{
+    DividendCheckpoint checkpoint;
+    checkpoint.notary_id_ = String(notaryID_).Get();
+    checkpoint.nym_id_ = String(*m_pNymID).Get();
+    checkpoint.payout_instrument_definition_id_ =
+        String(*m_pPayoutInstrumentDefinitionID).Get();
+    checkpoint.voucher_acct_id_ = String(*m_pVoucherAcctID).Get();
+    checkpoint.memo_ = m_pstrMemo->Get();
+    checkpoint.payout_per_share_ = m_lPayoutPerShare;
+    checkpoint.total_cost_ = total_cost_;
+    checkpoint.leftover_number_ = leftover_number_;
+    checkpoint.stage_ = stage_;
+    checkpoint.payer_acct_id_ = payer_acct_id_;
+    checkpoint.payer_balance_ = payer_balance_;
+    checkpoint.reserve_balance_ = reserve_balance_;
+    checkpoint.payouts_ = payouts_;
+
+    return checkpoint.Save(checkpoint_filename(*m_pServer));
+}
+
+void PayDividendVisitor::load_checkpoint(const DividendCheckpoint& checkpoint)
+{
+    payouts_ = checkpoint.payouts_;
+    total_cost_ = checkpoint.total_cost_;
+    leftover_number_ = checkpoint.leftover_number_;
+    stage_ = checkpoint.stage_;
+    payer_acct_id_ = checkpoint.payer_acct_id_;
+    payer_balance_ = checkpoint.payer_balance_;
+    reserve_balance_ = checkpoint.reserve_balance_;
+    m_lAmountPaidOut = 0;
+    m_lAmountReturned = 0;
+
+    for (const auto& thePayout : payouts_) {
+        if (DividendCheckpoint::PAYOUT_PAID == thePayout.state_) {
+            m_lAmountPaidOut += thePayout.amount_;
+        } else if (DividendCheckpoint::PAYOUT_RETURNED == thePayout.state_) {
+            m_lAmountReturned += thePayout.amount_;
+        }
+    }
+}
+
+// static
+bool PayDividendVisitor::Resume(OTServer& theServer)
+{
+    const std::string filename = checkpoint_filename(theServer);
+
+    if (!OTDB::Exists(".", filename)) { return true; }
+
+    DividendCheckpoint checkpoint;
+
+    if (!checkpoint.Load(filename)) {
+        Log::vError(
+            "%s: Unable to read dividend checkpoint %s.\n",
+            __FUNCTION__,
+            filename.c_str());
+
+        return false;
+    }
+
+    PayDividendVisitor actionPayDividend(
+        Identifier(checkpoint.notary_id_),
+        Identifier(checkpoint.nym_id_),
+        Identifier(checkpoint.payout_instrument_definition_id_),
+        Identifier(checkpoint.voucher_acct_id_),
+        String(checkpoint.memo_),
+        theServer,
+        checkpoint.payout_per_share_);
+    actionPayDividend.load_checkpoint(checkpoint);
+
+    if (DividendCheckpoint::STAGE_FUNDS_MOVED == checkpoint.stage_) {
+        Log::vOutput(
+            0,
+            "%s: Refunding %" PRId64 " to the payer of an interrupted "
+            "dividend payout.\n",
+            __FUNCTION__,
+            checkpoint.total_cost_);
+
+        return actionPayDividend.refund();
+    }
+
+    Log::vOutput(
+        0,
+        "%s: Resuming an interrupted dividend payout (%" PRId64
+        " paid, %" PRId64 " returned of %" PRId64 ").\n",
+        __FUNCTION__,
+        actionPayDividend.GetAmountPaidOut(),
+        actionPayDividend.GetAmountReturned(),
+        actionPayDividend.total_cost_);
 
-    return bReturnValue;
+    return actionPayDividend.run();
 }
 
 } // namespace opentxs
@@ -39,6 +39,7 @@
 #include "opentxs/server/Transactor.hpp"
 
 #include "opentxs/cash/Mint.hpp"
+#include "opentxs/cash/SpentTokens.hpp"
 #include "opentxs/core/Account.hpp"
 #include "opentxs/core/AccountList.hpp"
 #include "opentxs/core/Identifier.hpp"
@@ -46,6 +47,7 @@
 #include "opentxs/core/Nym.hpp"
 #include "opentxs/core/String.hpp"
 #include "opentxs/core/util/Assert.hpp"
+#include "opentxs/core/util/Common.hpp"
 #include "opentxs/core/util/OTFolders.hpp"
 #include "opentxs/server/MainFile.hpp"
 #include "opentxs/server/OTServer.hpp"
@@ -56,12 +58,14 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace opentxs
 {
 
 Transactor::Transactor(OTServer* server)
     : transactionNumber_(0)
+    , reservedNumber_(0)
     , server_(server)
 {
 }
@@ -86,24 +90,97 @@ Transactor::~Transactor()
 ///
 /// Users must ask the server to send them transaction numbers so that they
 /// can be used in transaction requests.
+///
+/// Numbers are handed out from a block which has already been reserved in
+/// storage, so only one write is needed per TRANSACTION_NUMBER_BLOCK
+/// numbers. If the server stops before a block is used up, the remainder of
+/// that block is skipped on the next start.
 bool Transactor::issueNextTransactionNumber(int64_t& lTransactionNumber)
 {
     // transactionNumber_ stores the last VALID AND ISSUED transaction number.
-    // So first, we increment that, since we don't want to issue the same number
+    // So first, we make sure the next one has been reserved...
+    if ((transactionNumber_ >= reservedNumber_) &&
+        !reserveTransactionNumbers()) {
+        Log::Error("Error reserving transaction numbers.\n");
+        return false;
+    }
+
+    // ...then we increment it, since we don't want to issue the same number
     // twice.
     transactionNumber_++;
 
-    // Next, we save it to file.
-    if (!server_->mainFile_.SaveMainFile()) {
-        Log::Error("Error saving main server file.\n");
-        transactionNumber_--;
+    // SUCCESS?
+    // Now the reserved high-water mark covers the latest transaction number,
+    // so we set it onto the parameter and return true.
+    lTransactionNumber = transactionNumber_;
+    return true;
+}
+
+bool Transactor::reserveTransactionNumbers(const int64_t count)
+{
+    const int64_t reserved =
+        transactionNumber_ + (count - 1) + TRANSACTION_NUMBER_BLOCK;
+
+    if (!server_->mainFile_.SaveTransactionNumber(reserved)) {
+        return false;
+    }
+
+    reservedNumber_ = reserved;
+
+    return true;
+}
+
+bool Transactor::issueNextTransactionNumbers(const int64_t count,
+                                             std::vector<int64_t>& numbers)
+{
+    numbers.clear();
+
+    if (0 >= count) { return false; }
+
+    if (((transactionNumber_ + count) > reservedNumber_) &&
+        !reserveTransactionNumbers(count)) {
+        Log::Error("Error reserving transaction numbers.\n");
+        return false;
+    }
+
+    numbers.reserve(count);
+
+    for (int64_t i = 0; i < count; ++i) {
+        numbers.push_back(++transactionNumber_);
+    }
+
+    return true;
+}
+
+bool Transactor::issueNextTransactionNumbersToNym(
+    Nym& theNym, const int64_t count, std::vector<int64_t>& numbers)
+{
+    Identifier NYM_ID(theNym), NOTARY_NYM_ID(server_->m_nymServer);
+
+    // Same as issueNextTransactionNumberToNym: stick to the server nym we
+    // already loaded, if that's who this is.
+    Nym* pNym = (NYM_ID == NOTARY_NYM_ID) ? &server_->m_nymServer : &theNym;
+
+    if (!issueNextTransactionNumbers(count, numbers)) { return false; }
+
+    for (const auto& number : numbers) {
+        if (!pNym->AddTransactionNum(server_->m_strNotaryID, number) ||
+            !pNym->AddIssuedNum(server_->m_strNotaryID, number)) {
+            Log::Error("Error adding transaction number to Nym file.\n");
+            numbers.clear();
+
+            return false;
+        }
+    }
+
+    // The whole block is recorded with a single nymfile write.
+    if (!pNym->SaveSignedNymfile(server_->m_nymServer)) {
+        Log::Error("Error saving Nym file.\n");
+        numbers.clear();
+
         return false;
     }
 
-    // SUCCESS?
-    // Now the server main file has saved the latest transaction number,
-    // NOW we set it onto the parameter and return true.
-    lTransactionNumber = transactionNumber_;
     return true;
 }
 
@@ -138,11 +215,9 @@ bool Transactor::issueNextTransactionNumberToNym(Nym& theNym,
     if (!pNym->AddTransactionNum(server_->m_nymServer, server_->m_strNotaryID,
                                  transactionNumber_, true)) {
         Log::Error("Error adding transaction number to Nym file.\n");
-        transactionNumber_--;
-        server_->mainFile_.SaveMainFile(); // Save it back how it was, since
-                                           // we're not
-                                           // issuing this
-                                           // number after all.
+        transactionNumber_--; // Hand it out again next time, since we're not
+                              // issuing this number after all. (It is still
+                              // covered by the reservation.)
         return false;
     }
 
@@ -451,6 +526,13 @@ Mint* Transactor::getMint(const Identifier& INSTRUMENT_DEFINITION_ID,
             mintsMap_.insert(std::pair<std::string, Mint*>(
                 INSTRUMENT_DEFINITION_ID_STR.Get(), pMint));
 
+            // Tokens from a series past its valid-to date fail verification
+            // on deposit, so its spent token database is no longer needed.
+            if (OTTimeGetCurrentTime() > pMint->GetValidTo()) {
+                SpentTokens::It().ExpireSeries(
+                    INSTRUMENT_DEFINITION_ID_STR, nSeries);
+            }
+
             return pMint;
         }
         else {
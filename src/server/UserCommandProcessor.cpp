@@ -78,6 +78,7 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 
@@ -92,10 +93,16 @@ UserCommandProcessor::UserCommandProcessor(OTServer* server)
 bool UserCommandProcessor::ProcessUserCommand(
     Message& theMessage,
     Message& msgOut,
-    ClientConnection* pConnection)
+    ClientConnection* pConnection,
+    std::mutex* serverNymLock)
 {
     msgOut.m_strRequestNum.Set(theMessage.m_strRequestNum);
 
+    // Taken once the request is authenticated. Declared before the context
+    // editors below, so that it is released after they have signed and saved
+    // the context.
+    std::unique_lock<std::mutex> serverNym;
+
     if (ServerSettings::__admin_server_locked &&
         ((ServerSettings::GetOverrideNymID().size() <=
           0) ||  // AND (there's no Override Nym ID listed --OR-- the Override
@@ -198,6 +205,10 @@ bool UserCommandProcessor::ProcessUserCommand(
                                               // encryption key for sending
                                               // an encrypted reply.
 
+        if (nullptr != serverNymLock) {
+            serverNym = std::unique_lock<std::mutex>(*serverNymLock);
+        }
+
         UserCmdPingNotary(theNym, theMessage, msgOut);
         return true;
     }
@@ -258,6 +269,11 @@ bool UserCommandProcessor::ProcessUserCommand(
             // client's public key that we set here.)
             if (strPublicEncrKey.Exists() && (nullptr != pConnection))
                 pConnection->SetPublicKey(thePublicEncrKey);
+
+            if (nullptr != serverNymLock) {
+                serverNym = std::unique_lock<std::mutex>(*serverNymLock);
+            }
+
             // Look up the NymID and see if it's already a valid
             // user account.
             //
@@ -511,6 +527,10 @@ bool UserCommandProcessor::ProcessUserCommand(
     if (nullptr != pConnection)
         pConnection->SetPublicKey(theNym.GetPublicEncrKey());
 
+    if (nullptr != serverNymLock) {
+        serverNym = std::unique_lock<std::mutex>(*serverNymLock);
+    }
+
     // Now we might as well load up the rest of the Nym.
     // Notice I use the && to only load the nymfile if it's NOT the
     // server Nym.
@@ -69,6 +69,7 @@ Storage::Storage(
     const Digest& hash,
     const Random& random)
     : gc_interval_(config.gc_interval_)
+    , commit_interval_(config.commit_interval_)
     , config_(config)
     , digest_(hash)
     , random_(random)
@@ -92,14 +93,145 @@ void Storage::Cleanup_Storage()
 
 void Storage::Cleanup()
 {
+    std::unique_lock<std::mutex> lock(write_lock_);
     shutdown_.store(true);
+    lock.unlock();
+    commit_signal_.notify_all();
+
+    if (commit_thread_) {
+        if (commit_thread_->joinable()) {
+            commit_thread_->join();
+        }
+
+        commit_thread_.reset();
+    }
 
     Cleanup_Storage();
+
+    lock.lock();
+
+    if (!dirty_) {
+
+        return;
+    }
+
+    // Opened without holding write_lock_, since it may wait for another
+    // thread's batch
+    lock.unlock();
+
+    if (!StartBatch()) {
+        std::cerr << __FUNCTION__ << ": Transaction error." << std::endl;
+
+        return;
+    }
+
+    lock.lock();
+
+    if (dirty_) {
+        if (!commit(lock)) {
+            std::cerr << __FUNCTION__ << ": Failed to write index changes."
+                      << std::endl;
+        }
+    }
+
+    commit_batch(lock);
+}
+
+bool Storage::Commit()
+{
+    // Taken before write_lock_, since it may wait for another thread's batch
+    if (!StartBatch()) {
+
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(write_lock_);
+    const bool committed = commit(lock);
+
+    return commit_batch(lock) && committed;
+}
+
+bool Storage::commit(const std::unique_lock<std::mutex>& lock)
+{
+    if (!verify_write_lock(lock)) {
+        std::cerr << __FUNCTION__ << ": Lock failure." << std::endl;
+        abort();
+    }
+
+    if (!dirty_) {
+
+        return true;
+    }
+
+    committing_.store(true);
+    const bool flushed = tree_->Flush();
+    committing_.store(false);
+
+    if (!flushed) {
+
+        return false;
+    }
+
+    dirty_ = false;
+    items_ = tree_->Root();
+    save(lock);
+
+    return true;
+}
+
+bool Storage::CommitBatch()
+{
+    std::unique_lock<std::mutex> lock(write_lock_);
+
+    return commit_batch(lock);
+}
+
+bool Storage::commit_batch(const std::unique_lock<std::mutex>& lock)
+{
+    const auto thread = std::this_thread::get_id();
+    std::unique_lock<std::mutex> transactionLock(transaction_lock_);
+    auto it = batch_depth_.find(thread);
+
+    if (batch_depth_.end() == it) {
+        std::cerr << __FUNCTION__ << ": No batch in progress." << std::endl;
+
+        return false;
+    }
+
+    if (1 < it->second) {
+        --(it->second);
+
+        return true;
+    }
+
+    transactionLock.unlock();
+    bool committed = true;
+
+    // With a commit interval the tree is written by PeriodicCommit instead
+    if (0 == commit_interval_) {
+        committed = commit(lock);
+    }
+
+    transactionLock.lock();
+    batch_depth_.erase(thread);
+    committed = CommitTransaction() && committed;
+    transaction_owner_ = std::thread::id();
+    transactionLock.unlock();
+    transaction_signal_.notify_all();
+
+    return committed;
 }
 
 void Storage::CollectGarbage()
 {
     const bool resume = gc_resume_.exchange(false);
+
+    if (!StartBatch()) {
+        std::cerr << __FUNCTION__ << ": Transaction error." << std::endl;
+
+        return;
+    }
+
     std::unique_lock<std::mutex> lock(write_lock_);
 
     bool oldLocation = false;
@@ -107,12 +239,18 @@ void Storage::CollectGarbage()
     if (resume) {
         oldLocation = !current_bucket_.load();
     } else {
+        if (!commit(lock)) {
+            std::cerr << __FUNCTION__ << ": Failed to write index changes."
+                      << std::endl;
+        }
+
         gc_root_ = tree_->Root();
         oldLocation = current_bucket_.load();
         current_bucket_.store(!oldLocation);
         save(lock);
     }
 
+    commit_batch(lock);
     lock.unlock();
     bool success = false;
 
@@ -130,16 +268,46 @@ void Storage::CollectGarbage()
                   << "Will retry next cycle." << std::endl;
     }
 
+    const bool started = StartBatch();
     std::unique_lock<std::mutex> gcLock(gc_lock_, std::defer_lock);
     std::lock(gcLock, lock);
     gc_running_.store(false);
     gc_root_ = "";
     last_gc_ = static_cast<std::int64_t>(std::time(nullptr));
     save(lock);
+
+    if (started) {
+        commit_batch(lock);
+    }
+
     lock.unlock();
     gcLock.unlock();
 }
 
+bool Storage::defer_writes() const
+{
+    if (committing_.load()) {
+
+        return false;
+    }
+
+    if (0 < commit_interval_) {
+
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(transaction_lock_);
+    const auto it = batch_depth_.find(std::this_thread::get_id());
+
+    if (batch_depth_.end() == it) {
+
+        return false;
+    }
+
+    // The outermost batch belongs to an explicit StartBatch call
+    return (1 < it->second);
+}
+
 ObjectList Storage::ContextList(const std::string& nymID) {
 
     return tree_->NymNode().Nym(nymID).Contexts().List();
@@ -579,6 +747,10 @@ void Storage::read_root()
     tree_.reset(new storage::Tree(*this, migrate, items_));
 
     OT_ASSERT(tree_);
+
+    if ((0 < commit_interval_) && (!commit_thread_)) {
+        commit_thread_.reset(new std::thread(&Storage::PeriodicCommit, this));
+    }
 }
 
 bool Storage::RemoveNymBoxItem(
@@ -695,6 +867,37 @@ bool Storage::RemoveUnitDefinition(const std::string& id)
     return tree().It().mutable_Units().It().Delete(id);
 }
 
+void Storage::PeriodicCommit()
+{
+    std::unique_lock<std::mutex> lock(write_lock_);
+
+    while (!shutdown_.load()) {
+        commit_signal_.wait_for(
+            lock, std::chrono::milliseconds(commit_interval_), [&]() -> bool {
+                return shutdown_.load();
+            });
+
+        if (!dirty_) {
+            continue;
+        }
+
+        // The batch must be opened without holding write_lock_, since it may
+        // wait for another thread's batch to finish.
+        lock.unlock();
+        const bool started = StartBatch();
+        lock.lock();
+
+        if (started) {
+            if (!commit(lock)) {
+                std::cerr << __FUNCTION__ << ": Failed to write index changes."
+                          << std::endl;
+            }
+
+            commit_batch(lock);
+        }
+    }
+}
+
 void Storage::RunGC()
 {
     if (shutdown_.load()) {
@@ -761,9 +964,17 @@ void Storage::save(storage::Tree* in, const std::unique_lock<std::mutex>& lock)
         abort();
     }
 
-    items_ = in->Root();
+    if (defer_writes()) {
+        dirty_ = true;
+    } else {
+        items_ = in->Root();
+        save(lock);
+    }
 
-    save(lock);
+    if (!commit_batch(lock)) {
+        std::cerr << __FUNCTION__ << ": Commit error." << std::endl;
+        abort();
+    }
 }
 
 proto::StorageRoot Storage::serialize() const
@@ -861,6 +1072,31 @@ bool Storage::SetUnitDefinitionAlias(
     return tree().It().mutable_Units().It().SetAlias(id, alias);
 }
 
+bool Storage::serialize_write(const std::function<bool()>& write) const
+{
+    const auto thread = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(transaction_lock_);
+
+    if (thread == transaction_owner_) {
+        lock.unlock();
+
+        return write();
+    }
+
+    // Hold the driver transaction slot for the duration of this write only
+    transaction_signal_.wait(
+        lock, [&]() -> bool { return std::thread::id() == transaction_owner_; });
+    transaction_owner_ = thread;
+    lock.unlock();
+    const bool output = write();
+    lock.lock();
+    transaction_owner_ = std::thread::id();
+    lock.unlock();
+    transaction_signal_.notify_all();
+
+    return output;
+}
+
 std::string Storage::ServerAlias(const std::string& id)
 {
     return tree_->ServerNode().Alias(id);
@@ -868,6 +1104,33 @@ std::string Storage::ServerAlias(const std::string& id)
 
 ObjectList Storage::ServerList() { return tree_->ServerNode().List(); }
 
+bool Storage::StartBatch()
+{
+    const auto thread = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(transaction_lock_);
+    auto it = batch_depth_.find(thread);
+
+    if (batch_depth_.end() != it) {
+        ++(it->second);
+
+        return true;
+    }
+
+    // Only one thread at a time may have writes in the driver transaction
+    transaction_signal_.wait(
+        lock, [&]() -> bool { return std::thread::id() == transaction_owner_; });
+
+    if (!StartTransaction()) {
+
+        return false;
+    }
+
+    transaction_owner_ = thread;
+    batch_depth_[thread] = 1;
+
+    return true;
+}
+
 bool Storage::Store(const proto::Context& data)
 {
     std::string notUsed;
@@ -1085,6 +1348,13 @@ Editor<storage::Tree> Storage::tree()
         this->save(in, lock);
     };
 
+    // Committed in save() once the root hash has been updated. Opened before
+    // taking write_lock_, since it may wait for another thread's batch.
+    if (!StartBatch()) {
+        std::cerr << __FUNCTION__ << ": Transaction error." << std::endl;
+        abort();
+    }
+
     return Editor<storage::Tree>(write_lock_, tree_.get(), callback);
 }
 
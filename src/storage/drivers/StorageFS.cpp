@@ -204,7 +204,8 @@ bool StorageFS::EmptyBucket(
 
 void StorageFS::Cleanup_StorageFS()
 {
-    // future cleanup actions go here
+    // Deferred index changes must be written while the driver is usable
+    ot_super::Cleanup();
 }
 
 void StorageFS::Cleanup()
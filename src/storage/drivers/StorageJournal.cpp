@@ -0,0 +1,516 @@
+/************************************************************
+ *
+ *                 OPEN TRANSACTIONS
+ *
+ *       Financial Cryptography and Digital Cash
+ *       Library, Protocol, API, Server, CLI, GUI
+ *
+ *       -- Anonymous Numbered Accounts.
+ *       -- Untraceable Digital Cash.
+ *       -- Triple-Signed Receipts.
+ *       -- Cheques, Vouchers, Transfers, Inboxes.
+ *       -- Basket Currencies, Markets, Payment Plans.
+ *       -- Signed, XML, Ricardian-style Contracts.
+ *       -- Scripted smart contracts.
+ *
+ *  EMAIL:
+ *  fellowtraveler@opentransactions.org
+ *
+ *  WEBSITE:
+ *  http://www.opentransactions.org/
+ *
+ *  -----------------------------------------------------
+ *
+ *   LICENSE:
+ *   This Source Code Form is subject to the terms of the
+ *   Mozilla Public License, v. 2.0. If a copy of the MPL
+ *   was not distributed with this file, You can obtain one
+ *   at http://mozilla.org/MPL/2.0/.
+ *
+ *   DISCLAIMER:
+ *   This program is distributed in the hope that it will
+ *   be useful, but WITHOUT ANY WARRANTY; without even the
+ *   implied warranty of MERCHANTABILITY or FITNESS FOR A
+ *   PARTICULAR PURPOSE.  See the Mozilla Public License
+ *   for more details.
+ *
+ ************************************************************/
+#if OT_STORAGE_JOURNAL
+#include "opentxs/storage/drivers/StorageJournal.hpp"
+
+#include <boost/filesystem.hpp>
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+}
+
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Every record starts with four 32 bit fields in host byte order: magic,
+// key size, value size, and a checksum over the key and value.
+#define OT_JOURNAL_MAGIC 0x4f544a31  // "OTJ1"
+#define OT_JOURNAL_HEADER_FIELDS 4
+#define OT_JOURNAL_HEADER_SIZE (OT_JOURNAL_HEADER_FIELDS * sizeof(uint32_t))
+
+namespace opentxs
+{
+
+StorageJournal::Segment::~Segment()
+{
+    if (0 <= fd_) {
+        ::close(fd_);
+    }
+}
+
+StorageJournal::StorageJournal(
+    const StorageConfig& config,
+    const Digest& hash,
+    const Random& random)
+    : ot_super(config, hash, random)
+    , folder_(config.path_)
+{
+    Init_StorageJournal();
+}
+
+std::uint32_t StorageJournal::checksum(
+    const std::string& key,
+    const std::string& value)
+{
+    // FNV-1a, used only to detect torn writes at the end of a segment
+    std::uint32_t output = 2166136261u;
+
+    for (const auto& c : key) {
+        output ^= static_cast<std::uint8_t>(c);
+        output *= 16777619u;
+    }
+
+    for (const auto& c : value) {
+        output ^= static_cast<std::uint8_t>(c);
+        output *= 16777619u;
+    }
+
+    return output;
+}
+
+std::string StorageJournal::segment_name(
+    const std::string& folder,
+    const std::uint32_t segment)
+{
+    char name[16]{};
+    std::snprintf(name, sizeof(name), "%08u", segment);
+
+    return folder + "/" + name;
+}
+
+void StorageJournal::Init_StorageJournal()
+{
+    for (const bool bucket : {false, true}) {
+        auto& target = buckets_[bucket];
+        target.folder_ = folder_ + "/" + GetBucketName(bucket);
+        boost::filesystem::create_directories(target.folder_);
+
+        if (!replay_bucket(target)) {
+            std::cerr << __FUNCTION__ << ": Failed to load journal "
+                      << target.folder_ << std::endl;
+            abort();
+        }
+    }
+
+    read_root();
+}
+
+bool StorageJournal::open_segment(
+    Bucket& bucket,
+    const std::uint32_t segment) const
+{
+    const auto name = segment_name(bucket.folder_, segment);
+    const int fd = ::open(name.c_str(), O_RDWR | O_CREAT, 0600);
+
+    if (0 > fd) {
+        std::cerr << __FUNCTION__ << ": Failed to open " << name << ": "
+                  << std::strerror(errno) << std::endl;
+
+        return false;
+    }
+
+    bucket.segments_[segment].reset(new Segment(fd));
+    bucket.current_ = segment;
+    bucket.tail_ = 0;
+
+    return true;
+}
+
+bool StorageJournal::replay_bucket(Bucket& bucket)
+{
+    std::set<std::uint32_t> segments;
+    boost::filesystem::directory_iterator end;
+
+    for (boost::filesystem::directory_iterator it(bucket.folder_); it != end;
+         ++it) {
+        const auto name = it->path().filename().string();
+
+        if (name.empty() ||
+            (std::string::npos != name.find_first_not_of("0123456789"))) {
+            continue;
+        }
+
+        segments.insert(std::stoul(name));
+    }
+
+    if (segments.empty()) {
+        return open_segment(bucket, 0);
+    }
+
+    // Later segments override earlier ones, so replay in order
+    for (const auto& segment : segments) {
+        if (!open_segment(bucket, segment)) {
+            return false;
+        }
+
+        if (!replay(bucket, segment)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool StorageJournal::replay(Bucket& bucket, const std::uint32_t segment)
+{
+    const auto name = segment_name(bucket.folder_, segment);
+    std::ifstream file(name, std::ios::in | std::ios::ate | std::ios::binary);
+
+    if (!file.good()) {
+        return false;
+    }
+
+    const std::uint64_t size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::uint64_t offset = 0;
+    std::uint32_t header[OT_JOURNAL_HEADER_FIELDS]{};
+    std::string key, value;
+
+    while (OT_JOURNAL_HEADER_SIZE <= (size - offset)) {
+        file.read(reinterpret_cast<char*>(header), OT_JOURNAL_HEADER_SIZE);
+
+        if (!file.good() || (OT_JOURNAL_MAGIC != header[0])) {
+            break;
+        }
+
+        const std::uint64_t keySize = header[1];
+        const std::uint64_t valueSize = header[2];
+        const std::uint64_t body = keySize + valueSize;
+
+        if (body > (size - offset - OT_JOURNAL_HEADER_SIZE)) {
+            break;
+        }
+
+        key.resize(keySize);
+        value.resize(valueSize);
+        file.read(&key[0], keySize);
+        file.read(&value[0], valueSize);
+
+        if (!file.good() || (checksum(key, value) != header[3])) {
+            break;
+        }
+
+        auto& position = bucket.index_[key];
+        position.segment_ = segment;
+        position.offset_ = offset + OT_JOURNAL_HEADER_SIZE + keySize;
+        position.size_ = valueSize;
+        offset += OT_JOURNAL_HEADER_SIZE + body;
+    }
+
+    if (offset != size) {
+        // A record was only partially written before the process stopped.
+        // It was never acknowledged, so it is safe to discard.
+        std::cerr << __FUNCTION__ << ": Discarding " << (size - offset)
+                  << " bytes of incomplete data from " << name << std::endl;
+
+        if (0 != ::truncate(name.c_str(), offset)) {
+            return false;
+        }
+    }
+
+    bucket.tail_ = offset;
+
+    return true;
+}
+
+void StorageJournal::Purge(const std::string& path)
+{
+    if (path.empty()) { return; }
+
+    boost::filesystem::remove_all(path);
+}
+
+std::string StorageJournal::LoadRoot() const
+{
+    if (!folder_.empty()) {
+        std::string filename = folder_ + "/" + config_.journal_root_file_;
+
+        if (!boost::filesystem::exists(filename)) { return ""; }
+
+        std::ifstream file(
+            filename,
+            std::ios::in | std::ios::ate | std::ios::binary);
+
+        if (file.good()) {
+            std::ifstream::pos_type pos = file.tellg();
+
+            if ((0 >= pos) || (0xFFFFFFFF <= pos)) { return ""; }
+
+            uint32_t size(pos);
+
+            file.seekg(0, std::ios::beg);
+
+            std::vector<char> bytes(size);
+            file.read(&bytes[0], size);
+
+            return std::string(&bytes[0], size);
+        }
+    }
+
+    return "";
+}
+
+bool StorageJournal::Load(
+    const std::string& key,
+    std::string& value,
+    const bool bucket) const
+{
+    std::shared_ptr<Segment> segment;
+    Position position;
+
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        const auto& target = buckets_[bucket];
+        const auto it = target.index_.find(key);
+
+        if (target.index_.end() == it) { return false; }
+
+        position = it->second;
+        segment = target.segments_.at(position.segment_);
+    }
+
+    value.resize(position.size_);
+    std::size_t read = 0;
+
+    while (read < position.size_) {
+        const auto bytes = ::pread(
+            segment->fd_,
+            &value[read],
+            position.size_ - read,
+            position.offset_ + read);
+
+        if (0 >= bytes) {
+            if ((0 > bytes) && (EINTR == errno)) { continue; }
+
+            value.clear();
+
+            return false;
+        }
+
+        read += bytes;
+    }
+
+    return true;
+}
+
+bool StorageJournal::StoreRoot(const std::string& hash)
+{
+    if (folder_.empty()) { return false; }
+
+    const std::string filename = folder_ + "/" + config_.journal_root_file_;
+    const std::string temp = filename + ".new";
+    const int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+
+    if (0 > fd) { return false; }
+
+    const bool written =
+        (static_cast<ssize_t>(hash.size()) ==
+         ::write(fd, hash.c_str(), hash.size())) &&
+        (0 == ::fsync(fd));
+    ::close(fd);
+
+    if (!written) { return false; }
+
+    // rename is atomic, so the root is always either the old or new value
+    return (0 == std::rename(temp.c_str(), filename.c_str()));
+}
+
+bool StorageJournal::append(
+    Bucket& bucket,
+    const std::string& key,
+    const std::string& value) const
+{
+    const std::uint64_t size =
+        OT_JOURNAL_HEADER_SIZE + key.size() + value.size();
+    const std::uint64_t limit = config_.journal_segment_size_;
+
+    if ((0 < bucket.tail_) && (limit < (bucket.tail_ + size))) {
+        if (!open_segment(bucket, bucket.current_ + 1)) { return false; }
+    }
+
+    const std::uint32_t header[OT_JOURNAL_HEADER_FIELDS]{
+        OT_JOURNAL_MAGIC,
+        static_cast<std::uint32_t>(key.size()),
+        static_cast<std::uint32_t>(value.size()),
+        checksum(key, value)};
+    std::string record(reinterpret_cast<const char*>(header), sizeof(header));
+    record.append(key);
+    record.append(value);
+
+    auto& segment = bucket.segments_.at(bucket.current_);
+    std::size_t written = 0;
+
+    while (written < record.size()) {
+        const auto bytes = ::pwrite(
+            segment->fd_,
+            &record[written],
+            record.size() - written,
+            bucket.tail_ + written);
+
+        if (0 > bytes) {
+            if (EINTR == errno) { continue; }
+
+            std::cerr << __FUNCTION__ << ": Write failed: "
+                      << std::strerror(errno) << std::endl;
+            // Leave the partial record for replay to discard. The next
+            // append overwrites it.
+
+            return false;
+        }
+
+        written += bytes;
+    }
+
+    auto& position = bucket.index_[key];
+    position.segment_ = bucket.current_;
+    position.offset_ = bucket.tail_ + OT_JOURNAL_HEADER_SIZE + key.size();
+    position.size_ = value.size();
+    bucket.tail_ += record.size();
+    dirty_.insert(segment);
+
+    return true;
+}
+
+bool StorageJournal::flush(
+    std::unique_lock<std::mutex>& lock,
+    const std::uint64_t sequence) const
+{
+    while ((synced_ < sequence) && (!failed_)) {
+        if (syncing_) {
+            sync_.wait(lock);
+
+            continue;
+        }
+
+        // This thread syncs every record written so far, including those
+        // appended by threads now waiting on sync_
+        syncing_ = true;
+        const auto target = written_;
+        std::set<std::shared_ptr<Segment>> dirty;
+        dirty.swap(dirty_);
+        lock.unlock();
+        bool success = true;
+
+        for (const auto& segment : dirty) {
+            success &= (0 == ::fsync(segment->fd_));
+        }
+
+        lock.lock();
+        syncing_ = false;
+
+        if (success) {
+            synced_ = target;
+        } else {
+            // The state of unsynced pages is undefined after a failed fsync,
+            // so the journal can not be trusted for further writes.
+            std::cerr << __FUNCTION__ << ": fsync failed: "
+                      << std::strerror(errno) << std::endl;
+            failed_ = true;
+        }
+
+        sync_.notify_all();
+    }
+
+    return !failed_;
+}
+
+bool StorageJournal::Store(
+    const std::string& key,
+    const std::string& value,
+    const bool bucket) const
+{
+    std::unique_lock<std::mutex> lock(lock_);
+
+    if (failed_) { return false; }
+
+    auto& target = buckets_[bucket];
+
+    // Keys are content hashes, so an existing key already holds this value
+    if (target.index_.end() == target.index_.find(key)) {
+        if (!append(target, key, value)) { return false; }
+
+        ++written_;
+    }
+
+    return flush(lock, written_);
+}
+
+bool StorageJournal::EmptyBucket(const bool bucket)
+{
+    assert(random_);
+
+    std::lock_guard<std::mutex> lock(lock_);
+    auto& target = buckets_[bucket];
+    const std::string newName = folder_ + "/" + random_();
+
+    if (0 != std::rename(target.folder_.c_str(), newName.c_str())) {
+        return false;
+    }
+
+    // Readers holding a segment keep its descriptor open until they finish
+    target.index_.clear();
+    target.segments_.clear();
+
+    std::thread backgroundDelete(&StorageJournal::Purge, this, newName);
+    backgroundDelete.detach();
+
+    if (!boost::filesystem::create_directory(target.folder_)) { return false; }
+
+    return open_segment(target, 0);
+}
+
+void StorageJournal::Cleanup_StorageJournal()
+{
+    // Deferred index changes must be written while the driver is usable
+    ot_super::Cleanup();
+
+    std::unique_lock<std::mutex> lock(lock_);
+    flush(lock, written_);
+}
+
+void StorageJournal::Cleanup()
+{
+    Cleanup_StorageJournal();
+}
+
+StorageJournal::~StorageJournal()
+{
+    Cleanup_StorageJournal();
+}
+
+} // namespace opentxs
+#endif
@@ -59,16 +59,53 @@ StorageSqlite3::StorageSqlite3(
     Init_StorageSqlite3();
 }
 
+sqlite3_stmt* StorageSqlite3::Prepare(
+    std::map<std::string, sqlite3_stmt*>& cache,
+    const std::string& tablename,
+    const std::string& query) const
+{
+    auto& statement = cache[tablename];
+
+    if (nullptr == statement) {
+        if (SQLITE_OK !=
+            sqlite3_prepare_v2(db_, query.c_str(), -1, &statement, 0)) {
+            std::cerr << __FUNCTION__ << ": " << sqlite3_errmsg(db_)
+                      << std::endl;
+            sqlite3_finalize(statement);
+            cache.erase(tablename);
+
+            return nullptr;
+        }
+    }
+
+    return statement;
+}
+
+void StorageSqlite3::Finalize(const std::string& tablename) const
+{
+    for (auto cache : {&select_, &upsert_}) {
+        auto it = cache->find(tablename);
+
+        if (cache->end() != it) {
+            sqlite3_finalize(it->second);
+            cache->erase(it);
+        }
+    }
+}
+
 bool StorageSqlite3::Select(
     const std::string& key,
     const std::string& tablename,
     std::string& value) const
 {
-    sqlite3_stmt* statement = nullptr;
-    const std::string query =
-        "select v from `" + tablename + "` where k=?1 LIMIT 0,1;";
+    std::lock_guard<std::mutex> lock(statement_lock_);
+    sqlite3_stmt* statement = Prepare(
+        select_,
+        tablename,
+        "select v from `" + tablename + "` where k=?1 LIMIT 0,1;");
+
+    if (nullptr == statement) { return false; }
 
-    sqlite3_prepare_v2(db_, query.c_str(), -1, &statement, 0);
     sqlite3_bind_text(statement, 1, key.c_str(), key.size(), SQLITE_STATIC);
     int result = sqlite3_step(statement);
     bool success = false;
@@ -79,7 +116,8 @@ bool StorageSqlite3::Select(
         value.assign(static_cast<const char*>(pResult), size);
         success = true;
     }
-    sqlite3_finalize(statement);
+    sqlite3_reset(statement);
+    sqlite3_clear_bindings(statement);
 
     return success;
 }
@@ -89,16 +127,19 @@ bool StorageSqlite3::Upsert(
     const std::string& tablename,
     const std::string& value) const
 {
-    sqlite3_stmt *statement;
-    const std::string query =
-        "insert or replace into `" + tablename +
-        "` (k, v) values (?1, ?2);";
+    std::lock_guard<std::mutex> lock(statement_lock_);
+    sqlite3_stmt* statement = Prepare(
+        upsert_,
+        tablename,
+        "insert or replace into `" + tablename + "` (k, v) values (?1, ?2);");
+
+    if (nullptr == statement) { return false; }
 
-    sqlite3_prepare_v2(db_, query.c_str(), -1, &statement, 0);
     sqlite3_bind_text(statement, 1, key.c_str(), key.size(), SQLITE_STATIC);
     sqlite3_bind_blob(statement, 2, value.c_str(), value.size(), SQLITE_STATIC);
     int result = sqlite3_step(statement);
-    sqlite3_finalize(statement);
+    sqlite3_reset(statement);
+    sqlite3_clear_bindings(statement);
 
     return (result == SQLITE_DONE);
 }
@@ -115,6 +156,8 @@ bool StorageSqlite3::Create(const std::string& tablename)
 
 bool StorageSqlite3::Purge(const std::string& tablename)
 {
+    std::lock_guard<std::mutex> lock(statement_lock_);
+    Finalize(tablename);
     const std::string sql = "DROP TABLE `" + tablename + "`;";
 
     if (SQLITE_OK ==
@@ -169,8 +212,10 @@ bool StorageSqlite3::Load(
 
 bool StorageSqlite3::StoreRoot(const std::string& hash)
 {
-    return Upsert(
-        config_.sqlite3_root_key_, config_.sqlite3_control_table_, hash);
+    return serialize_write([&]() -> bool {
+        return Upsert(
+            config_.sqlite3_root_key_, config_.sqlite3_control_table_, hash);
+    });
 }
 
 bool StorageSqlite3::Store(
@@ -178,17 +223,61 @@ bool StorageSqlite3::Store(
     const std::string& value,
     const bool bucket) const
 {
-    return Upsert(key, GetTableName(bucket), value);
+    return serialize_write([&]() -> bool {
+        return Upsert(key, GetTableName(bucket), value);
+    });
 }
 
 bool StorageSqlite3::EmptyBucket(const bool bucket)
 {
-    return Purge(GetTableName(bucket));
+    return serialize_write(
+        [&]() -> bool { return Purge(GetTableName(bucket)); });
+}
+
+bool StorageSqlite3::StartTransaction()
+{
+    std::lock_guard<std::mutex> lock(statement_lock_);
+
+    return (SQLITE_OK ==
+        sqlite3_exec(db_, "BEGIN TRANSACTION;", nullptr, nullptr, nullptr));
+}
+
+bool StorageSqlite3::CommitTransaction()
+{
+    std::lock_guard<std::mutex> lock(statement_lock_);
+
+    if (SQLITE_OK ==
+        sqlite3_exec(db_, "COMMIT TRANSACTION;", nullptr, nullptr, nullptr)) {
+
+        return true;
+    }
+
+    std::cerr << __FUNCTION__ << ": " << sqlite3_errmsg(db_) << std::endl;
+
+    // A failed commit can leave the transaction open, which would make the
+    // next BEGIN fail.
+    if (0 == sqlite3_get_autocommit(db_)) {
+        sqlite3_exec(
+            db_, "ROLLBACK TRANSACTION;", nullptr, nullptr, nullptr);
+    }
+
+    return false;
 }
 
 void StorageSqlite3::Cleanup_StorageSqlite3()
 {
+    // Deferred index changes must be written while the driver is usable
+    ot_super::Cleanup();
+
+    {
+        std::lock_guard<std::mutex> lock(statement_lock_);
+        Finalize(config_.sqlite3_primary_bucket_);
+        Finalize(config_.sqlite3_secondary_bucket_);
+        Finalize(config_.sqlite3_control_table_);
+    }
+
     sqlite3_close(db_);
+    db_ = nullptr;
 }
 
 void StorageSqlite3::Cleanup()
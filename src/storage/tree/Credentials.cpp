@@ -159,6 +159,10 @@ bool Credentials::save(const std::unique_lock<std::mutex>& lock)
         abort();
     }
 
+    if (deferred(lock)) {
+        return true;
+    }
+
     auto serialized = serialize();
 
     if (!proto::Check(serialized, version_, version_)) {
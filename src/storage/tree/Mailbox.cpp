@@ -100,6 +100,10 @@ bool Mailbox::save(const std::unique_lock<std::mutex>& lock)
         abort();
     }
 
+    if (deferred(lock)) {
+        return true;
+    }
+
     auto serialized = serialize();
 
     if (!proto::Check(serialized, version_, version_)) {
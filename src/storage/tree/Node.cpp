@@ -63,6 +63,22 @@ bool Node::check_hash(const std::string& hash) const
     return !(empty || blank);
 }
 
+bool Node::deferred(const std::unique_lock<std::mutex>& lock)
+{
+    if (!verify_write_lock(lock)) {
+        std::cerr << __FUNCTION__ << ": Lock failure." << std::endl;
+        abort();
+    }
+
+    if (storage_.defer_writes()) {
+        dirty_ = true;
+
+        return true;
+    }
+
+    return false;
+}
+
 bool Node::delete_item(const std::string& id)
 {
     std::unique_lock<std::mutex> lock(write_lock_);
@@ -76,6 +92,21 @@ bool Node::delete_item(const std::string& id)
     return save(lock);
 }
 
+bool Node::Flush()
+{
+    std::unique_lock<std::mutex> lock(write_lock_);
+
+    if (!dirty_) {
+        return true;
+    }
+
+    // Children first, so the index written below contains their final roots
+    flush_children(lock);
+    dirty_ = false;
+
+    return save(lock);
+}
+
 std::string Node::get_alias(const std::string& id) const
 {
     std::string output;
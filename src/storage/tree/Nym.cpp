@@ -209,6 +209,43 @@ const PeerReplies& Nym::IncomingReplyBox() const
     return *incoming_reply_box();
 }
 
+void Nym::flush_children(const std::unique_lock<std::mutex>& lock)
+{
+    if (!verify_write_lock(lock)) {
+        std::cerr << __FUNCTION__ << ": Lock failure." << std::endl;
+        abort();
+    }
+
+    flush_child(
+        sent_request_box_lock_, sent_request_box_, sent_peer_request_);
+    flush_child(
+        incoming_request_box_lock_,
+        incoming_request_box_,
+        incoming_peer_request_);
+    flush_child(sent_reply_box_lock_, sent_reply_box_, sent_peer_reply_);
+    flush_child(
+        incoming_reply_box_lock_, incoming_reply_box_, incoming_peer_reply_);
+    flush_child(
+        finished_request_box_lock_,
+        finished_request_box_,
+        finished_peer_request_);
+    flush_child(
+        finished_reply_box_lock_, finished_reply_box_, finished_peer_reply_);
+    flush_child(
+        processed_request_box_lock_,
+        processed_request_box_,
+        processed_peer_request_);
+    flush_child(
+        processed_reply_box_lock_,
+        processed_reply_box_,
+        processed_peer_reply_);
+    // Threads may add items to the mailboxes, so flush them first
+    flush_child(threads_lock_, threads_, threads_root_);
+    flush_child(mail_inbox_lock_, mail_inbox_, mail_inbox_root_);
+    flush_child(mail_outbox_lock_, mail_outbox_, mail_outbox_root_);
+    flush_child(contexts_lock_, contexts_, contexts_root_);
+}
+
 void Nym::init(const std::string& hash)
 {
     std::shared_ptr<proto::StorageNym> serialized;
@@ -577,6 +614,10 @@ bool Nym::save(const std::unique_lock<std::mutex>& lock)
         abort();
     }
 
+    if (deferred(lock)) {
+        return true;
+    }
+
     auto serialized = serialize();
 
     if (!proto::Check(serialized, version_, version_)) {
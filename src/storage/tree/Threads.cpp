@@ -128,6 +128,32 @@ bool Threads::FindAndDeleteItem(const std::string& itemID)
     return found;
 }
 
+void Threads::flush_children(const std::unique_lock<std::mutex>& lock)
+{
+    if (!verify_write_lock(lock)) {
+        std::cerr << __FUNCTION__ << ": Lock failure." << std::endl;
+        abort();
+    }
+
+    for (auto& it : threads_) {
+        const auto& id = it.first;
+        auto& node = it.second;
+
+        if (!node) {
+            continue;
+        }
+
+        if (!node->Flush()) {
+            std::cerr << __FUNCTION__ << ": Save error" << std::endl;
+            abort();
+        }
+
+        auto& index = item_map_[id];
+        std::get<0>(index) = node->Root();
+        std::get<1>(index) = node->Alias();
+    }
+}
+
 void Threads::init(const std::string& hash)
 {
     std::shared_ptr<proto::StorageNymList> serialized;
@@ -220,6 +246,10 @@ bool Threads::save(const std::unique_lock<std::mutex>& lock)
         abort();
     }
 
+    if (deferred(lock)) {
+        return true;
+    }
+
     auto serialized = serialize();
 
     if (!proto::Check(serialized, version_, version_)) {
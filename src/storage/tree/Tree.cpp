@@ -106,6 +106,20 @@ Credentials* Tree::credentials() const
     return credentials_.get();
 }
 
+void Tree::flush_children(const std::unique_lock<std::mutex>& lock)
+{
+    if (!verify_write_lock(lock)) {
+        std::cerr << __FUNCTION__ << ": Lock failure." << std::endl;
+        abort();
+    }
+
+    flush_child(credential_lock_, credentials_, credential_root_);
+    flush_child(nym_lock_, nyms_, nym_root_);
+    flush_child(seed_lock_, seeds_, seed_root_);
+    flush_child(server_lock_, servers_, server_root_);
+    flush_child(unit_lock_, units_, unit_root_);
+}
+
 void Tree::init(const std::string& hash)
 {
     std::shared_ptr<proto::StorageItems> serialized;
@@ -234,6 +248,10 @@ bool Tree::save(const std::unique_lock<std::mutex>& lock)
         abort();
     }
 
+    if (deferred(lock)) {
+        return true;
+    }
+
     auto serialized = serialize();
 
     if (!proto::Check(serialized, version_, version_)) {
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest-message.h"
+#include "gtest/gtest-test-part.h"
+#include "opentxs/client/OTAPI_Wrap.hpp"
+#include "opentxs/core/OTStorage.hpp"
+#include "opentxs/server/DividendCheckpoint.hpp"
+#include "opentxs/server/OTServer.hpp"
+#include "opentxs/server/PayDividendVisitor.hpp"
+#include "opentxs/server/Transactor.hpp"
+
+using namespace opentxs;
+
+namespace
+{
+
+// A default constructed OTServer has an empty wallet filename
+const std::string checkpoint_{".dividend"};
+const std::string checkpoint_file_{"Test_Dividend.dividend"};
+
+DividendCheckpoint sample()
+{
+    DividendCheckpoint checkpoint;
+    checkpoint.notary_id_ = "notary";
+    checkpoint.nym_id_ = "payer";
+    checkpoint.payout_instrument_definition_id_ = "unit";
+    checkpoint.voucher_acct_id_ = "vouchers";
+    checkpoint.memo_ = "line one\nline two\n";
+    checkpoint.payout_per_share_ = 3;
+    checkpoint.total_cost_ = 30;
+    checkpoint.leftover_number_ = 12;
+    checkpoint.stage_ = DividendCheckpoint::STAGE_FUNDS_MOVED;
+    checkpoint.payer_acct_id_ = "payerAcct";
+    checkpoint.payer_balance_ = 70;
+    checkpoint.reserve_balance_ = 130;
+
+    DividendCheckpoint::Payout paid;
+    paid.recipient_ = "alice";
+    paid.amount_ = 21;
+    paid.voucher_number_ = 10;
+    paid.receipt_number_ = 20;
+    paid.state_ = DividendCheckpoint::PAYOUT_PAID;
+    checkpoint.payouts_.push_back(paid);
+
+    DividendCheckpoint::Payout pending;
+    pending.recipient_ = "bob";
+    pending.amount_ = 9;
+    pending.voucher_number_ = 11;
+    pending.receipt_number_ = 21;
+    checkpoint.payouts_.push_back(pending);
+
+    return checkpoint;
+}
+
+void expect_sample(const DividendCheckpoint& checkpoint)
+{
+    EXPECT_EQ("notary", checkpoint.notary_id_);
+    EXPECT_EQ("payer", checkpoint.nym_id_);
+    EXPECT_EQ("unit", checkpoint.payout_instrument_definition_id_);
+    EXPECT_EQ("vouchers", checkpoint.voucher_acct_id_);
+    EXPECT_EQ("line one\nline two\n", checkpoint.memo_);
+    EXPECT_EQ(3, checkpoint.payout_per_share_);
+    EXPECT_EQ(30, checkpoint.total_cost_);
+    EXPECT_EQ(12, checkpoint.leftover_number_);
+    EXPECT_EQ(DividendCheckpoint::STAGE_FUNDS_MOVED, checkpoint.stage_);
+    EXPECT_EQ("payerAcct", checkpoint.payer_acct_id_);
+    EXPECT_EQ(70, checkpoint.payer_balance_);
+    EXPECT_EQ(130, checkpoint.reserve_balance_);
+    ASSERT_EQ(2u, checkpoint.payouts_.size());
+    EXPECT_EQ("alice", checkpoint.payouts_[0].recipient_);
+    EXPECT_EQ(21, checkpoint.payouts_[0].amount_);
+    EXPECT_EQ(10, checkpoint.payouts_[0].voucher_number_);
+    EXPECT_EQ(20, checkpoint.payouts_[0].receipt_number_);
+    EXPECT_EQ(DividendCheckpoint::PAYOUT_PAID, checkpoint.payouts_[0].state_);
+    EXPECT_EQ("bob", checkpoint.payouts_[1].recipient_);
+    EXPECT_EQ(
+        DividendCheckpoint::PAYOUT_PENDING, checkpoint.payouts_[1].state_);
+}
+
+void remove_files()
+{
+    for (const std::string& filename :
+         {checkpoint_, checkpoint_file_, checkpoint_file_ + ".tmp",
+          std::string(".transactionNum.0"), std::string(".transactionNum.1")}) {
+        if (OTDB::Exists(".", filename)) {
+            OTDB::EraseValueByKey(".", filename);
+        }
+    }
+}
+
+class Test_Dividend : public ::testing::Test
+{
+public:
+    static void SetUpTestCase() { OTAPI_Wrap::AppInit(); }
+    static void TearDownTestCase() { OTAPI_Wrap::AppCleanup(); }
+
+    void SetUp() override { remove_files(); }
+    void TearDown() override { remove_files(); }
+};
+
+}  // namespace
+
+TEST_F(Test_Dividend, round_trips_through_the_record)
+{
+    DividendCheckpoint loaded;
+
+    ASSERT_TRUE(loaded.Parse(sample().Serialize()));
+    expect_sample(loaded);
+}
+
+TEST_F(Test_Dividend, rejects_a_torn_record)
+{
+    const std::string record = sample().Serialize();
+    DividendCheckpoint loaded;
+
+    // Cut off before the final line
+    EXPECT_FALSE(loaded.Parse(record.substr(0, record.size() - 4)));
+    EXPECT_FALSE(loaded.Parse(""));
+}
+
+TEST_F(Test_Dividend, a_record_without_a_stage_is_paying)
+{
+    std::string record = sample().Serialize();
+    const std::string stage = "stage=1\n";
+    const std::size_t position = record.find(stage);
+
+    ASSERT_NE(std::string::npos, position);
+    record.erase(position, stage.size());
+
+    DividendCheckpoint loaded;
+
+    ASSERT_TRUE(loaded.Parse(record));
+    EXPECT_EQ(DividendCheckpoint::STAGE_PAYING, loaded.stage_);
+}
+
+TEST_F(Test_Dividend, saves_and_loads_a_checkpoint)
+{
+    DividendCheckpoint loaded;
+
+    EXPECT_FALSE(loaded.Load(checkpoint_file_));
+    ASSERT_TRUE(sample().Save(checkpoint_file_));
+    EXPECT_FALSE(OTDB::Exists(".", checkpoint_file_ + ".tmp"));
+    ASSERT_TRUE(loaded.Load(checkpoint_file_));
+    expect_sample(loaded);
+
+    // Saving again replaces the previous checkpoint
+    DividendCheckpoint updated = sample();
+    updated.payouts_[1].state_ = DividendCheckpoint::PAYOUT_RETURNED;
+
+    ASSERT_TRUE(updated.Save(checkpoint_file_));
+    ASSERT_TRUE(loaded.Load(checkpoint_file_));
+    EXPECT_EQ(
+        DividendCheckpoint::PAYOUT_RETURNED, loaded.payouts_[1].state_);
+}
+
+TEST_F(Test_Dividend, issues_consecutive_transaction_numbers)
+{
+    OTServer server;
+    Transactor transactor(&server);
+    std::vector<int64_t> numbers;
+
+    transactor.transactionNumber(100);
+
+    ASSERT_TRUE(transactor.issueNextTransactionNumbers(5, numbers));
+    EXPECT_EQ((std::vector<int64_t>{101, 102, 103, 104, 105}), numbers);
+    EXPECT_EQ(105, transactor.transactionNumber());
+
+    // The rest of the block is issued without reserving again
+    const int64_t reserved = transactor.reservedNumber();
+
+    EXPECT_LE(105, reserved);
+    ASSERT_TRUE(transactor.issueNextTransactionNumbers(3, numbers));
+    EXPECT_EQ((std::vector<int64_t>{106, 107, 108}), numbers);
+    EXPECT_EQ(reserved, transactor.reservedNumber());
+
+    EXPECT_FALSE(transactor.issueNextTransactionNumbers(0, numbers));
+    EXPECT_TRUE(numbers.empty());
+    EXPECT_EQ(108, transactor.transactionNumber());
+}
+
+TEST_F(Test_Dividend, resume_without_a_checkpoint_does_nothing)
+{
+    OTServer server;
+
+    EXPECT_TRUE(PayDividendVisitor::Resume(server));
+}
+
+TEST_F(Test_Dividend, resume_ignores_a_torn_checkpoint)
+{
+    OTServer server;
+    const std::string record = sample().Serialize();
+
+    ASSERT_TRUE(OTDB::StorePlainString(
+        record.substr(0, record.size() - 4), ".", checkpoint_));
+    EXPECT_FALSE(PayDividendVisitor::Resume(server));
+}
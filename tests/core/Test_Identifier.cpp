@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <functional>
+#include <string>
+
+#include "gtest/gtest-message.h"
+#include "gtest/gtest-test-part.h"
+#include "opentxs/core/Identifier.hpp"
+
+using namespace opentxs;
+
+TEST(Identifier, compare_equal_to_other_same)
+{
+    Identifier one, other;
+    one.Assign("abcd", 4);
+    other.Assign("abcd", 4);
+    ASSERT_TRUE(one == other);
+    ASSERT_FALSE(one != other);
+    ASSERT_FALSE(one < other);
+    ASSERT_FALSE(other < one);
+}
+
+TEST(Identifier, compare_ordering)
+{
+    Identifier one, other;
+    one.Assign("abcd", 4);
+    other.Assign("abce", 4);
+    ASSERT_TRUE(one < other);
+    ASSERT_TRUE(one <= other);
+    ASSERT_TRUE(other > one);
+    ASSERT_TRUE(other >= one);
+    ASSERT_TRUE(one != other);
+}
+
+TEST(Identifier, compare_empty)
+{
+    Identifier empty, other;
+    other.Assign("abcd", 4);
+    ASSERT_TRUE(empty == Identifier());
+    ASSERT_TRUE(empty < other);
+    ASSERT_FALSE(other < empty);
+}
+
+TEST(Identifier, hash_equal_for_equal_ids)
+{
+    Identifier one, other;
+    one.Assign("abcdefghijklmnop", 16);
+    other.Assign("abcdefghijklmnop", 16);
+    std::hash<Identifier> hasher;
+    ASSERT_EQ(hasher(one), hasher(other));
+}
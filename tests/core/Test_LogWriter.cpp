@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest-message.h"
+#include "gtest/gtest-test-part.h"
+#include "opentxs/core/util/LogWriter.hpp"
+
+using namespace opentxs;
+
+namespace
+{
+
+const std::string path_{"Test_LogWriter.log"};
+
+std::size_t count_lines(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::size_t output = 0;
+
+    while (std::getline(file, line)) { ++output; }
+
+    return output;
+}
+
+void remove_logs()
+{
+    for (const auto& suffix : {"", ".1", ".2", ".3"}) {
+        std::remove((path_ + suffix).c_str());
+    }
+}
+
+}  // namespace
+
+TEST(LogWriter, writes_every_line_from_every_thread)
+{
+    remove_logs();
+
+    {
+        LogWriter writer(path_, 0, 0);
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([&writer, i]() {
+                for (int j = 0; j < 5000; ++j) {
+                    writer.Push(
+                        std::to_string(i) + " " + std::to_string(j) + "\n");
+                }
+            });
+        }
+
+        for (auto& thread : threads) { thread.join(); }
+
+        writer.Flush();
+        ASSERT_EQ(20000u, count_lines(path_));
+    }
+
+    std::ifstream file(path_);
+    std::set<std::string> lines;
+    std::string line;
+
+    while (std::getline(file, line)) { lines.insert(line); }
+
+    ASSERT_EQ(20000u, lines.size());
+    remove_logs();
+}
+
+TEST(LogWriter, rotates_by_size)
+{
+    remove_logs();
+
+    {
+        LogWriter writer(path_, 1000, 2);
+
+        for (int i = 0; i < 1000; ++i) { writer.Push("0123456789\n"); }
+    }
+
+    std::ifstream oldest(path_ + ".3");
+    ASSERT_FALSE(oldest.good());
+    ASSERT_EQ(91u, count_lines(path_ + ".1"));
+    ASSERT_EQ(91u, count_lines(path_ + ".2"));
+    remove_logs();
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest-message.h"
+#include "gtest/gtest-test-part.h"
+#include "opentxs/client/OTAPI_Wrap.hpp"
+#include "opentxs/core/Message.hpp"
+#include "opentxs/core/OTData.hpp"
+#include "opentxs/core/String.hpp"
+
+using namespace opentxs;
+
+namespace
+{
+
+// Minimal protobuf encoder, so that the expected wire bytes do not depend on
+// the code under test
+std::string varint(std::uint64_t value)
+{
+    std::string output;
+
+    while (0x80 <= value) {
+        output += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+
+    output += static_cast<char>(value);
+
+    return output;
+}
+
+std::string varint_field(const std::uint32_t field, const std::uint64_t value)
+{
+    return varint(field << 3) + varint(value);
+}
+
+std::string bytes_field(const std::uint32_t field, const std::string& value)
+{
+    return varint((field << 3) | 2) + varint(value.size()) + value;
+}
+
+const std::string payload_{"payload bytes"};
+
+// NotaryMessageBody_InternalPB
+std::string body()
+{
+    return bytes_field(1, "3.0") + bytes_field(3, "getBoxReceipt") +
+           bytes_field(4, "notary") + bytes_field(5, "nym") +
+           bytes_field(12, "account") + bytes_field(14, "7") +
+           bytes_field(16, payload_) + varint_field(21, 1) +
+           varint_field(22, 42) + varint_field(27, 1) + varint_field(29, 1);
+}
+
+// NotaryMessage_InternalPB, prefixed with the binary marker
+std::string wire()
+{
+    return std::string(1, '\0') + varint_field(1, 1) +
+           bytes_field(2, body()) + varint_field(3, 3) +
+           bytes_field(4, bytes_field(1, "signature"));
+}
+
+class Test_Message : public ::testing::Test
+{
+public:
+    static void SetUpTestCase() { OTAPI_Wrap::AppInit(); }
+    static void TearDownTestCase() { OTAPI_Wrap::AppCleanup(); }
+};
+
+}  // namespace
+
+TEST_F(Test_Message, loads_fields_from_the_binary_encoding)
+{
+    Message message;
+
+    ASSERT_TRUE(message.LoadBinary(wire()));
+    EXPECT_TRUE(message.Binary());
+    EXPECT_STREQ("getBoxReceipt", message.m_strCommand.Get());
+    EXPECT_STREQ("notary", message.m_strNotaryID.Get());
+    EXPECT_STREQ("nym", message.m_strNymID.Get());
+    EXPECT_STREQ("account", message.m_strAcctID.Get());
+    EXPECT_STREQ("7", message.m_strRequestNum.Get());
+    EXPECT_EQ(1, message.m_lDepth);
+    EXPECT_EQ(42, message.m_lTransactionNum);
+    EXPECT_TRUE(message.m_bSuccess);
+    EXPECT_FALSE(message.m_bBool);
+    EXPECT_TRUE(message.m_bBinaryMessages);
+
+    OTData payload;
+
+    ASSERT_TRUE(message.m_ascPayload.GetData(payload));
+    EXPECT_EQ(
+        payload_,
+        std::string(
+            static_cast<const char*>(payload.GetPointer()),
+            payload.GetSize()));
+}
+
+TEST_F(Test_Message, serializes_a_loaded_message_unchanged)
+{
+    Message message;
+    std::string output;
+
+    ASSERT_TRUE(message.LoadBinary(wire()));
+    ASSERT_TRUE(message.SerializeBinary(output));
+    EXPECT_EQ(wire(), output);
+}
+
+TEST_F(Test_Message, round_trips_through_the_string_form)
+{
+    Message message;
+    String saved;
+
+    ASSERT_TRUE(message.LoadBinary(wire()));
+    ASSERT_TRUE(message.SaveContractRaw(saved));
+    ASSERT_TRUE(saved.Exists());
+
+    Message loaded;
+    std::string output;
+
+    ASSERT_TRUE(loaded.LoadContractFromString(saved));
+    EXPECT_TRUE(loaded.Binary());
+    ASSERT_TRUE(loaded.SerializeBinary(output));
+    EXPECT_EQ(wire(), output);
+}
+
+TEST_F(Test_Message, rejects_input_which_is_not_binary)
+{
+    Message message;
+    std::string output;
+
+    EXPECT_FALSE(Message::IsBinary("armored"));
+    EXPECT_FALSE(message.LoadBinary("armored"));
+    EXPECT_FALSE(message.LoadBinary(std::string(1, '\0') + "\xff\xff"));
+    EXPECT_FALSE(message.SerializeBinary(output));
+    EXPECT_TRUE(output.empty());
+}
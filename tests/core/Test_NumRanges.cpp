@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "gtest/gtest-message.h"
+#include "gtest/gtest-test-part.h"
+#include "opentxs/core/NumRanges.hpp"
+#include "opentxs/core/String.hpp"
+
+using namespace opentxs;
+
+TEST(NumRanges, add_merges_adjacent_numbers)
+{
+    NumRanges numbers;
+    ASSERT_TRUE(numbers.Add(1));
+    ASSERT_TRUE(numbers.Add(3));
+    ASSERT_TRUE(numbers.Add(2));
+    ASSERT_FALSE(numbers.Add(2));
+    ASSERT_EQ(3u, numbers.Count());
+    ASSERT_EQ(1u, numbers.GetRanges().size());
+}
+
+TEST(NumRanges, remove_splits_range)
+{
+    NumRanges numbers;
+    numbers.AddRange(10, 20);
+    ASSERT_TRUE(numbers.Remove(15));
+    ASSERT_FALSE(numbers.Remove(15));
+    ASSERT_FALSE(numbers.Verify(15));
+    ASSERT_TRUE(numbers.Verify(14));
+    ASSERT_TRUE(numbers.Verify(16));
+    ASSERT_EQ(10u, numbers.Count());
+    ASSERT_EQ(2u, numbers.GetRanges().size());
+}
+
+TEST(NumRanges, add_range_absorbs_overlaps)
+{
+    NumRanges numbers;
+    numbers.AddRange(1, 3);
+    numbers.AddRange(7, 9);
+    numbers.AddRange(4, 6);
+    ASSERT_EQ(9u, numbers.Count());
+    ASSERT_EQ(1u, numbers.GetRanges().size());
+}
+
+TEST(NumRanges, iterates_in_order)
+{
+    NumRanges numbers;
+    numbers.AddRange(5, 6);
+    numbers.Add(1);
+    std::string output;
+
+    for (const auto& number : numbers) { output += std::to_string(number); }
+
+    ASSERT_EQ("156", output);
+
+    int64_t number = 0;
+    ASSERT_TRUE(numbers.At(2, number));
+    ASSERT_EQ(6, number);
+    ASSERT_FALSE(numbers.At(3, number));
+}
+
+TEST(NumRanges, serialization_round_trip)
+{
+    NumRanges numbers;
+    numbers.AddRange(1, 50);
+    numbers.Add(52);
+    String serialized;
+    ASSERT_TRUE(numbers.Output(serialized));
+    ASSERT_STREQ("1-50,52", serialized.Get());
+
+    NumRanges loaded(serialized);
+    ASSERT_EQ(51u, loaded.Count());
+    ASSERT_TRUE(loaded.Verify(52));
+    ASSERT_FALSE(loaded.Verify(51));
+}
+
+TEST(NumRanges, accepts_plain_number_list)
+{
+    NumRanges numbers;
+    ASSERT_TRUE(numbers.Add(String("4,2, 3")));
+    ASSERT_EQ(3u, numbers.Count());
+    ASSERT_EQ(1u, numbers.GetRanges().size());
+    ASSERT_FALSE(numbers.Add(String("5,x")));
+}
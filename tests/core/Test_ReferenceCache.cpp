@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+
+#include "gtest/gtest-message.h"
+#include "gtest/gtest-test-part.h"
+#include "opentxs/client/OTAPI_Wrap.hpp"
+#include "opentxs/core/Cheque.hpp"
+#include "opentxs/core/Identifier.hpp"
+#include "opentxs/core/Item.hpp"
+#include "opentxs/core/Ledger.hpp"
+#include "opentxs/core/OTTransaction.hpp"
+#include "opentxs/core/String.hpp"
+#include "opentxs/core/util/Common.hpp"
+
+using namespace opentxs;
+
+namespace
+{
+
+class Test_ReferenceCache : public ::testing::Test
+{
+public:
+    static void SetUpTestCase() { OTAPI_Wrap::AppInit(); }
+    static void TearDownTestCase() { OTAPI_Wrap::AppCleanup(); }
+
+    Identifier notary_, nym_, account_, unit_;
+
+    void SetUp() override
+    {
+        notary_.CalculateDigest(String("notary"));
+        nym_.CalculateDigest(String("nym"));
+        account_.CalculateDigest(String("account"));
+        unit_.CalculateDigest(String("unit"));
+    }
+
+    std::unique_ptr<OTTransaction> receipt()
+    {
+        return std::unique_ptr<OTTransaction>(
+            OTTransaction::GenerateTransaction(
+                nym_,
+                account_,
+                notary_,
+                OTTransaction::chequeReceipt,
+                originType::not_applicable,
+                5));
+    }
+
+    // A depositCheque item, optionally carrying a cheque with chequeNum
+    String deposit(OTTransaction& owner, const int64_t chequeNum)
+    {
+        std::unique_ptr<Item> pItem(
+            Item::CreateItemFromTransaction(owner, Item::depositCheque));
+
+        if (0 < chequeNum) {
+            Cheque theCheque(notary_, unit_);
+            theCheque.IssueCheque(
+                10,
+                chequeNum,
+                OT_TIME_ZERO,
+                OT_TIME_ZERO,
+                account_,
+                nym_,
+                String("memo"));
+            theCheque.SaveContract();
+            pItem->SetAttachment(String(theCheque));
+        }
+
+        pItem->SaveContract();
+
+        return String(*pItem);
+    }
+
+    String accept(OTTransaction& owner)
+    {
+        std::unique_ptr<Item> pItem(
+            Item::CreateItemFromTransaction(owner, Item::acceptPending));
+        pItem->SaveContract();
+
+        return String(*pItem);
+    }
+};
+
+}  // namespace
+
+TEST_F(Test_ReferenceCache, decodes_the_reference_item_once)
+{
+    auto pReceipt = receipt();
+    ASSERT_TRUE(pReceipt);
+
+    pReceipt->SetReferenceString(deposit(*pReceipt, 0));
+    pReceipt->SetReferenceToNum(7);
+
+    const Item* pItem = pReceipt->GetReferenceItem(notary_);
+
+    ASSERT_NE(nullptr, pItem);
+    EXPECT_EQ(Item::depositCheque, pItem->GetType());
+    EXPECT_EQ(7, pItem->GetTransactionNum());
+    EXPECT_EQ(pItem, pReceipt->GetReferenceItem(notary_));
+}
+
+TEST_F(Test_ReferenceCache, setting_the_reference_string_invalidates_it)
+{
+    auto pReceipt = receipt();
+    ASSERT_TRUE(pReceipt);
+
+    pReceipt->SetReferenceString(deposit(*pReceipt, 0));
+    ASSERT_NE(nullptr, pReceipt->GetReferenceItem(notary_));
+
+    pReceipt->SetReferenceString(accept(*pReceipt));
+    const Item* pItem = pReceipt->GetReferenceItem(notary_);
+
+    ASSERT_NE(nullptr, pItem);
+    EXPECT_EQ(Item::acceptPending, pItem->GetType());
+}
+
+TEST_F(Test_ReferenceCache, setting_the_reference_number_invalidates_it)
+{
+    auto pReceipt = receipt();
+    ASSERT_TRUE(pReceipt);
+
+    pReceipt->SetReferenceString(deposit(*pReceipt, 0));
+    pReceipt->SetReferenceToNum(7);
+    ASSERT_NE(nullptr, pReceipt->GetReferenceItem(notary_));
+
+    // The decoded item takes its transaction number from the reference
+    pReceipt->SetReferenceToNum(8);
+    const Item* pItem = pReceipt->GetReferenceItem(notary_);
+
+    ASSERT_NE(nullptr, pItem);
+    EXPECT_EQ(8, pItem->GetTransactionNum());
+}
+
+TEST_F(Test_ReferenceCache, decodes_the_attached_cheque_again_after_a_change)
+{
+    auto pReceipt = receipt();
+    ASSERT_TRUE(pReceipt);
+
+    pReceipt->SetReferenceString(deposit(*pReceipt, 40));
+    const Cheque* pCheque = pReceipt->GetReferenceCheque(notary_);
+
+    ASSERT_NE(nullptr, pCheque);
+    EXPECT_EQ(40, pCheque->GetTransactionNum());
+
+    pReceipt->SetReferenceString(deposit(*pReceipt, 41));
+    pCheque = pReceipt->GetReferenceCheque(notary_);
+
+    ASSERT_NE(nullptr, pCheque);
+    EXPECT_EQ(41, pCheque->GetTransactionNum());
+
+    pReceipt->SetReferenceString(accept(*pReceipt));
+    EXPECT_EQ(nullptr, pReceipt->GetReferenceCheque(notary_));
+}
+
+TEST_F(Test_ReferenceCache, cheque_receipt_lookup_returns_an_owned_copy)
+{
+    Ledger theInbox(nym_, account_, notary_);
+    OTTransaction* pReceipt = OTTransaction::GenerateTransaction(
+        theInbox,
+        OTTransaction::chequeReceipt,
+        originType::not_applicable,
+        5);
+    ASSERT_NE(nullptr, pReceipt);
+
+    pReceipt->SetReferenceString(deposit(*pReceipt, 40));
+    ASSERT_TRUE(theInbox.AddTransaction(*pReceipt));  // the ledger owns it
+
+    Cheque* pCopy = nullptr;
+
+    EXPECT_EQ(pReceipt, theInbox.GetChequeReceipt(40, &pCopy));
+    ASSERT_NE(nullptr, pCopy);
+
+    std::unique_ptr<Cheque> theCopy(pCopy);
+
+    EXPECT_NE(pReceipt->GetReferenceCheque(notary_), pCopy);
+    EXPECT_EQ(40, pCopy->GetTransactionNum());
+    EXPECT_EQ(nullptr, theInbox.GetChequeReceipt(41));
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest-message.h"
+#include "gtest/gtest-test-part.h"
+#include "opentxs/core/crypto/OTPassword.hpp"
+#include "opentxs/core/crypto/SecureArena.hpp"
+
+using namespace opentxs;
+
+TEST(SecureArena, freed_chunks_are_zeroed_and_reused)
+{
+    auto& arena = SecureArena::It();
+    const auto before = arena.GetStats();
+
+    auto* chunk = static_cast<std::uint8_t*>(arena.Allocate(100));
+    ASSERT_NE(nullptr, chunk);
+    std::memset(chunk, 0xaa, 100);
+
+    EXPECT_EQ(before.chunks_in_use_ + 1, arena.GetStats().chunks_in_use_);
+
+    arena.Free(chunk, 100);
+    auto* again = static_cast<std::uint8_t*>(arena.Allocate(100));
+
+    EXPECT_EQ(chunk, again);
+
+    for (std::size_t i = 0; i < 100; ++i) { EXPECT_EQ(0, again[i]); }
+
+    arena.Free(again, 100);
+
+    EXPECT_EQ(before.chunks_in_use_, arena.GetStats().chunks_in_use_);
+}
+
+TEST(SecureArena, large_password_fits)
+{
+    const std::string input(OT_LARGE_BLOCKSIZE, 'x');
+    const auto before = SecureArena::It().GetStats();
+
+    {
+        OTPassword password(
+            input.data(), input.size(), OTPassword::LARGER_SIZE);
+        OTPassword copy(password);
+
+        EXPECT_EQ(input.size(), copy.getPasswordSize());
+        EXPECT_EQ(input, std::string(copy.getPassword()));
+    }
+
+    EXPECT_EQ(
+        before.bytes_in_use_, SecureArena::It().GetStats().bytes_in_use_);
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest-message.h"
+#include "gtest/gtest-test-part.h"
+#include "opentxs/cash/SpentTokens.hpp"
+#include "opentxs/core/String.hpp"
+
+using namespace opentxs;
+
+namespace
+{
+
+const std::string folder_{"."};
+const String unit_{"Test_SpentTokens"};
+
+std::string log_path(const std::int32_t series)
+{
+    return folder_ + "/" + unit_.Get() + "." + std::to_string(series) + ".log";
+}
+
+void remove_logs()
+{
+    for (const std::int32_t series : {0, 1, 2}) {
+        std::remove(log_path(series).c_str());
+    }
+}
+
+}  // namespace
+
+TEST(SpentTokens, rejects_a_token_spent_twice)
+{
+    remove_logs();
+    SpentTokens spent(folder_);
+
+    EXPECT_TRUE(spent.Insert(unit_, {{0, {"a", "b"}}}));
+    EXPECT_TRUE(spent.Exists(unit_, 0, "a"));
+    EXPECT_TRUE(spent.Exists(unit_, 0, "b"));
+    EXPECT_FALSE(spent.Exists(unit_, 0, "c"));
+    EXPECT_FALSE(spent.Exists(unit_, 1, "a"));
+
+    // A batch holding one spent token records none of its tokens
+    EXPECT_FALSE(spent.Insert(unit_, {{0, {"b", "c"}}}));
+    EXPECT_FALSE(spent.Exists(unit_, 0, "c"));
+    EXPECT_FALSE(spent.Insert(unit_, {{1, {"d"}}, {0, {"a"}}}));
+    EXPECT_FALSE(spent.Exists(unit_, 1, "d"));
+
+    EXPECT_FALSE(spent.Insert(unit_, {}));
+    EXPECT_FALSE(spent.Insert(unit_, {{0, {}}}));
+
+    remove_logs();
+}
+
+TEST(SpentTokens, records_a_batch_in_every_series)
+{
+    remove_logs();
+    SpentTokens spent(folder_);
+
+    EXPECT_TRUE(spent.Insert(unit_, {{0, {"a"}}, {1, {"b", "c"}}}));
+    EXPECT_TRUE(spent.Exists(unit_, 0, "a"));
+    EXPECT_TRUE(spent.Exists(unit_, 1, "b"));
+    EXPECT_TRUE(spent.Exists(unit_, 1, "c"));
+    EXPECT_FALSE(spent.Exists(unit_, 0, "b"));
+
+    remove_logs();
+}
+
+TEST(SpentTokens, rolls_back_a_batch_which_fails_in_a_later_series)
+{
+    remove_logs();
+    SpentTokens spent(folder_);
+
+    ASSERT_TRUE(spent.Insert(unit_, {{0, {"a"}}}));
+
+    // A directory in place of the series 1 log makes its append fail
+    const std::string blocked = log_path(1);
+    ASSERT_EQ(0, ::mkdir(blocked.c_str(), 0700));
+
+    EXPECT_FALSE(spent.Insert(unit_, {{0, {"b"}}, {1, {"c"}}}));
+    EXPECT_FALSE(spent.Exists(unit_, 0, "b"));
+    ::rmdir(blocked.c_str());
+
+    SpentTokens reloaded(folder_);
+
+    EXPECT_TRUE(reloaded.Exists(unit_, 0, "a"));
+    EXPECT_FALSE(reloaded.Exists(unit_, 0, "b"));
+
+    remove_logs();
+}
+
+TEST(SpentTokens, reloads_spent_tokens_from_disk)
+{
+    remove_logs();
+
+    {
+        SpentTokens spent(folder_);
+
+        ASSERT_TRUE(spent.Insert(unit_, {{0, {"a", "b"}}}));
+        ASSERT_TRUE(spent.Insert(unit_, {{0, {"c"}}}));
+    }
+
+    // Simulate a batch torn by a crash in the middle of its write
+    {
+        std::ofstream file(log_path(0), std::ios::app | std::ios::binary);
+        file << "d e";
+    }
+
+    SpentTokens spent(folder_);
+
+    EXPECT_TRUE(spent.Exists(unit_, 0, "a"));
+    EXPECT_TRUE(spent.Exists(unit_, 0, "b"));
+    EXPECT_TRUE(spent.Exists(unit_, 0, "c"));
+    EXPECT_FALSE(spent.Exists(unit_, 0, "d"));
+    EXPECT_FALSE(spent.Exists(unit_, 0, "e"));
+    EXPECT_FALSE(spent.Insert(unit_, {{0, {"a"}}}));
+    EXPECT_TRUE(spent.Insert(unit_, {{0, {"d"}}}));
+
+    SpentTokens reloaded(folder_);
+
+    EXPECT_TRUE(reloaded.Exists(unit_, 0, "d"));
+    EXPECT_FALSE(reloaded.Exists(unit_, 0, "e"));
+
+    remove_logs();
+}
+
+TEST(SpentTokens, expiring_a_series_drops_only_that_series)
+{
+    remove_logs();
+    SpentTokens spent(folder_);
+
+    ASSERT_TRUE(spent.Insert(unit_, {{0, {"a"}}, {1, {"b"}}}));
+    EXPECT_TRUE(spent.ExpireSeries(unit_, 0));
+    EXPECT_FALSE(spent.Exists(unit_, 0, "a"));
+    EXPECT_TRUE(spent.Exists(unit_, 1, "b"));
+
+    std::ifstream file(log_path(0));
+
+    EXPECT_FALSE(file.good());
+
+    // Expiring a series which was never used is not an error
+    EXPECT_TRUE(spent.ExpireSeries(unit_, 2));
+
+    SpentTokens reloaded(folder_);
+
+    EXPECT_FALSE(reloaded.Exists(unit_, 0, "a"));
+    EXPECT_TRUE(reloaded.Exists(unit_, 1, "b"));
+
+    remove_logs();
+}